@@ -0,0 +1,393 @@
+#include "batch.h"
+#include "debug.h"
+#include <cassert>
+#include <cstdlib>
+#include <string>
+
+#ifdef MATH_SIMD
+// GCC 12 warns about the intentionally undefined source registers inside the AVX-512 intrinsics
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#endif
+
+namespace batch {
+
+// scalar reference implementation, component by component,
+// the sums over the components of a vector in the order of the SIMD kernels, (v0 + v1) + (v2 + v3),
+// so every level computes the same bits
+namespace scalar {
+
+template <size_t N>
+float sum_of_products(const Vector<float, N> & a, const Vector<float, N> & b) {
+  std::array<float, 4u> products = {0.0f, 0.0f, 0.0f, 0.0f};  // the padding of a Vector3df is zero
+  for (size_t axis = 0u; axis < N; axis++) {
+    products[axis] = a[axis] * b[axis];
+  }
+  return (products[0] + products[1]) + (products[2] + products[3]);
+}
+
+template <size_t N>
+void dot(std::span<const Vector<float, N>> a, std::span<const Vector<float, N>> b, std::span<float> result) {
+  for (size_t i = 0u; i < a.size(); i++) {
+    result[i] = sum_of_products(a[i], b[i]);
+  }
+}
+
+template <size_t N>
+void normalize(std::span<Vector<float, N>> vectors) {
+  for (auto & vector : vectors) {
+    float length = std::sqrt(sum_of_products(vector, vector));
+    for (size_t axis = 0u; axis < N; axis++) {
+      vector[axis] /= length;
+    }
+  }
+}
+
+void transform(const SquareMatrix4df & matrix, std::span<const Vector4df> points, std::span<Vector4df> result) {
+  for (size_t i = 0u; i < points.size(); i++) {
+    Vector4df product;
+    for (size_t row = 0u; row < 4u; row++) {
+      float sum = 0.0f;
+      for (size_t column = 0u; column < 4u; column++) {
+        sum += matrix.at(row, column) * points[i][column];
+      }
+      product[row] = sum;
+    }
+    result[i] = product;
+  }
+}
+
+void multiply(const SquareMatrix4df & factor1, const SquareMatrix4df & factor2, SquareMatrix4df & product) {
+  std::array<Vector4df, 4> columns = { factor2[0], factor2[1], factor2[2], factor2[3] };
+  std::array<Vector4df, 4> result;
+  transform(factor1, columns, result);
+  product = { result[0], result[1], result[2], result[3] };
+}
+
+}
+
+#ifdef MATH_SIMD
+// all SIMD kernels treat a Vector3df or Vector4df as one 16 byte lane of four floats
+// (the padding of Vector3df is zero). Wider registers hold two (AVX2) or four (AVX-512)
+// vectors, the sums within a lane are built in the same order as in Vector's operator*
+static_assert(sizeof(Vector3df) == 4u * sizeof(float) && sizeof(Vector4df) == 4u * sizeof(float));
+
+template <size_t N>
+const float * floats(std::span<const Vector<float, N>> vectors) {
+  return vectors.empty() ? nullptr : vectors[0].vector.data();
+}
+
+template <size_t N>
+float * floats(std::span<Vector<float, N>> vectors) {
+  return vectors.empty() ? nullptr : vectors[0].vector.data();
+}
+
+namespace sse2 {
+
+// (v0 + v1) + (v2 + v3) in all four values
+inline __m128 sum_lane(__m128 v) {
+  __m128 sums = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_add_ps(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+inline __m128 padding_mask(size_t n) {
+  return n == 3u ? _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)) : _mm_castsi128_ps(_mm_set1_epi32(-1));
+}
+
+inline void dot(const float * a, const float * b, float * result, size_t count) {
+  for (size_t i = 0u; i < count; i++) {
+    result[i] = _mm_cvtss_f32(sum_lane(_mm_mul_ps(_mm_load_ps(a + 4u * i), _mm_load_ps(b + 4u * i))));
+  }
+}
+
+inline void normalize(float * values, size_t count, size_t n) {
+  const __m128 mask = padding_mask(n);
+  for (size_t i = 0u; i < count; i++) {
+    __m128 v = _mm_load_ps(values + 4u * i);
+    __m128 length = _mm_sqrt_ps(sum_lane(_mm_mul_ps(v, v)));
+    _mm_store_ps(values + 4u * i, _mm_and_ps(_mm_div_ps(v, length), mask));
+  }
+}
+
+inline void transform(const SquareMatrix4df & matrix, const float * points, float * result, size_t count) {
+  const __m128 c0 = _mm_loadu_ps(matrix[0].vector.data());
+  const __m128 c1 = _mm_loadu_ps(matrix[1].vector.data());
+  const __m128 c2 = _mm_loadu_ps(matrix[2].vector.data());
+  const __m128 c3 = _mm_loadu_ps(matrix[3].vector.data());
+  for (size_t i = 0u; i < count; i++) {
+    __m128 v = _mm_load_ps(points + 4u * i);
+    __m128 sum = _mm_setzero_ps();
+    sum = _mm_add_ps(sum, _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xaa)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(c3, _mm_shuffle_ps(v, v, 0xff)));
+    _mm_store_ps(result + 4u * i, sum);
+  }
+}
+
+template <size_t N>
+void dot_kernel(std::span<const Vector<float, N>> a, std::span<const Vector<float, N>> b, std::span<float> result) {
+  dot(floats(a), floats(b), result.data(), a.size());
+}
+
+template <size_t N>
+void normalize_kernel(std::span<Vector<float, N>> vectors) {
+  normalize(floats(vectors), vectors.size(), N);
+}
+
+void transform_kernel(const SquareMatrix4df & matrix, std::span<const Vector4df> points, std::span<Vector4df> result) {
+  transform(matrix, floats(points), floats(result), points.size());
+}
+
+}
+
+namespace avx2 {
+
+__attribute__((target("avx2")))
+inline __m256 sum_lanes(__m256 v) {
+  __m256 sums = _mm256_add_ps(v, _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm256_add_ps(sums, _mm256_permute_ps(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+template <size_t N>
+__attribute__((target("avx2")))
+void dot_kernel(std::span<const Vector<float, N>> a, std::span<const Vector<float, N>> b, std::span<float> result) {
+  const float * a_values = floats(a);
+  const float * b_values = floats(b);
+  const __m256i first_values = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+  size_t i = 0u;
+  for (; i + 2u <= a.size(); i += 2u) {
+    __m256 sums = sum_lanes(_mm256_mul_ps(_mm256_loadu_ps(a_values + 4u * i), _mm256_loadu_ps(b_values + 4u * i)));
+    __m128 low = _mm256_castps256_ps128(_mm256_permutevar8x32_ps(sums, first_values));
+    _mm_storel_pi(reinterpret_cast<__m64 *>(result.data() + i), low);
+  }
+  sse2::dot(a_values + 4u * i, b_values + 4u * i, result.data() + i, a.size() - i);
+}
+
+template <size_t N>
+__attribute__((target("avx2")))
+void normalize_kernel(std::span<Vector<float, N>> vectors) {
+  float * values = floats(vectors);
+  const __m256 mask = _mm256_set_m128(sse2::padding_mask(N), sse2::padding_mask(N));
+  size_t i = 0u;
+  for (; i + 2u <= vectors.size(); i += 2u) {
+    __m256 v = _mm256_loadu_ps(values + 4u * i);
+    __m256 length = _mm256_sqrt_ps(sum_lanes(_mm256_mul_ps(v, v)));
+    _mm256_storeu_ps(values + 4u * i, _mm256_and_ps(_mm256_div_ps(v, length), mask));
+  }
+  sse2::normalize(values + 4u * i, vectors.size() - i, N);
+}
+
+__attribute__((target("avx2")))
+void transform_kernel(const SquareMatrix4df & matrix, std::span<const Vector4df> points, std::span<Vector4df> result) {
+  const float * point_values = floats(points);
+  float * result_values = floats(result);
+  const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix[0].vector.data()));
+  const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix[1].vector.data()));
+  const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix[2].vector.data()));
+  const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(matrix[3].vector.data()));
+  size_t i = 0u;
+  for (; i + 2u <= points.size(); i += 2u) {
+    __m256 v = _mm256_loadu_ps(point_values + 4u * i);
+    __m256 sum = _mm256_setzero_ps();
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(c0, _mm256_permute_ps(v, 0x00)));
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(c1, _mm256_permute_ps(v, 0x55)));
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(c2, _mm256_permute_ps(v, 0xaa)));
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(c3, _mm256_permute_ps(v, 0xff)));
+    _mm256_storeu_ps(result_values + 4u * i, sum);
+  }
+  sse2::transform(matrix, point_values + 4u * i, result_values + 4u * i, points.size() - i);
+}
+
+}
+
+namespace avx512 {
+
+__attribute__((target("avx512f")))
+inline __m512 sum_lanes(__m512 v) {
+  __m512 sums = _mm512_add_ps(v, _mm512_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm512_add_ps(sums, _mm512_permute_ps(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+template <size_t N>
+__attribute__((target("avx512f")))
+void dot_kernel(std::span<const Vector<float, N>> a, std::span<const Vector<float, N>> b, std::span<float> result) {
+  const float * a_values = floats(a);
+  const float * b_values = floats(b);
+  const __m512i first_values = _mm512_setr_epi32(0, 4, 8, 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+  size_t i = 0u;
+  for (; i + 4u <= a.size(); i += 4u) {
+    __m512 sums = sum_lanes(_mm512_mul_ps(_mm512_loadu_ps(a_values + 4u * i), _mm512_loadu_ps(b_values + 4u * i)));
+    _mm_storeu_ps(result.data() + i, _mm512_castps512_ps128(_mm512_permutexvar_ps(first_values, sums)));
+  }
+  avx2::dot_kernel<N>(a.subspan(i), b.subspan(i), result.subspan(i));
+}
+
+template <size_t N>
+__attribute__((target("avx512f")))
+void normalize_kernel(std::span<Vector<float, N>> vectors) {
+  float * values = floats(vectors);
+  const __m512 mask = _mm512_castsi512_ps(N == 3u ? _mm512_set4_epi32(0, -1, -1, -1) : _mm512_set1_epi32(-1));
+  size_t i = 0u;
+  for (; i + 4u <= vectors.size(); i += 4u) {
+    __m512 v = _mm512_loadu_ps(values + 4u * i);
+    __m512 length = _mm512_sqrt_ps(sum_lanes(_mm512_mul_ps(v, v)));
+    __m512 normalized = _mm512_div_ps(v, length);
+    _mm512_storeu_ps(values + 4u * i, _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(normalized),
+                                                                           _mm512_castps_si512(mask))));
+  }
+  avx2::normalize_kernel<N>(vectors.subspan(i));
+}
+
+__attribute__((target("avx512f")))
+void transform_kernel(const SquareMatrix4df & matrix, std::span<const Vector4df> points, std::span<Vector4df> result) {
+  const float * point_values = floats(points);
+  float * result_values = floats(result);
+  const __m512 c0 = _mm512_broadcast_f32x4(_mm_loadu_ps(matrix[0].vector.data()));
+  const __m512 c1 = _mm512_broadcast_f32x4(_mm_loadu_ps(matrix[1].vector.data()));
+  const __m512 c2 = _mm512_broadcast_f32x4(_mm_loadu_ps(matrix[2].vector.data()));
+  const __m512 c3 = _mm512_broadcast_f32x4(_mm_loadu_ps(matrix[3].vector.data()));
+  size_t i = 0u;
+  for (; i + 4u <= points.size(); i += 4u) {
+    __m512 v = _mm512_loadu_ps(point_values + 4u * i);
+    __m512 sum = _mm512_setzero_ps();
+    sum = _mm512_add_ps(sum, _mm512_mul_ps(c0, _mm512_permute_ps(v, 0x00)));
+    sum = _mm512_add_ps(sum, _mm512_mul_ps(c1, _mm512_permute_ps(v, 0x55)));
+    sum = _mm512_add_ps(sum, _mm512_mul_ps(c2, _mm512_permute_ps(v, 0xaa)));
+    sum = _mm512_add_ps(sum, _mm512_mul_ps(c3, _mm512_permute_ps(v, 0xff)));
+    _mm512_storeu_ps(result_values + 4u * i, sum);
+  }
+  avx2::transform_kernel(matrix, points.subspan(i), result.subspan(i));
+}
+
+}
+
+// the product of two matrices transforms the columns of factor2 with factor1
+template <void (*TRANSFORM)(const SquareMatrix4df &, std::span<const Vector4df>, std::span<Vector4df>)>
+void multiply_kernel(const SquareMatrix4df & factor1, const SquareMatrix4df & factor2, SquareMatrix4df & product) {
+  std::array<Vector4df, 4> columns = { factor2[0], factor2[1], factor2[2], factor2[3] };
+  std::array<Vector4df, 4> result;
+  TRANSFORM(factor1, columns, result);
+  product = { result[0], result[1], result[2], result[3] };
+}
+#endif
+
+const char * get_name(Isa isa) {
+  switch (isa) {
+    case Isa::scalar: return "scalar";
+    case Isa::sse2: return "sse2";
+    case Isa::avx2: return "avx2";
+    case Isa::avx512: return "avx512";
+  }
+  return "unknown";
+}
+
+bool is_supported(Isa isa) {
+#ifdef MATH_SIMD
+  __builtin_cpu_init();
+  switch (isa) {
+    case Isa::scalar: return true;
+    case Isa::sse2: return __builtin_cpu_supports("sse2");
+    case Isa::avx2: return __builtin_cpu_supports("avx2");
+    case Isa::avx512: return __builtin_cpu_supports("avx512f");
+  }
+  return false;
+#else
+  return isa == Isa::scalar;
+#endif
+}
+
+// returns the best supported level, or the one given by MATH_ISA
+Isa select_isa() {
+  Isa best = Isa::scalar;
+  for (Isa isa : {Isa::sse2, Isa::avx2, Isa::avx512}) {
+    if (is_supported(isa)) {
+      best = isa;
+    }
+  }
+  const char * forced = std::getenv("MATH_ISA");
+  if (forced != nullptr) {
+    for (Isa isa : {Isa::scalar, Isa::sse2, Isa::avx2, Isa::avx512}) {
+      if (std::string(forced) == get_name(isa)) {
+        if (is_supported(isa)) {
+          return isa;
+        }
+        warning(std::string("MATH_ISA ") + forced + " is not supported, using " + get_name(best));
+        return best;
+      }
+    }
+    warning(std::string("unknown MATH_ISA ") + forced + ", using " + get_name(best));
+  }
+  return best;
+}
+
+Isa get_active_isa() {
+  static const Isa active_isa = select_isa();
+  return active_isa;
+}
+
+const Kernels & get_kernels(Isa isa) {
+  static const Kernels scalar_kernels = { scalar::dot<3u>, scalar::dot<4u>, scalar::normalize<3u>, scalar::normalize<4u>,
+                                          scalar::transform, scalar::multiply };
+#ifdef MATH_SIMD
+  static const Kernels sse2_kernels = { sse2::dot_kernel<3u>, sse2::dot_kernel<4u>,
+                                        sse2::normalize_kernel<3u>, sse2::normalize_kernel<4u>,
+                                        sse2::transform_kernel, multiply_kernel<sse2::transform_kernel> };
+  // a single 4x4 product is too small for the wider registers, their setup costs more than it saves
+  static const Kernels avx2_kernels = { avx2::dot_kernel<3u>, avx2::dot_kernel<4u>,
+                                        avx2::normalize_kernel<3u>, avx2::normalize_kernel<4u>,
+                                        avx2::transform_kernel, multiply_kernel<sse2::transform_kernel> };
+  static const Kernels avx512_kernels = { avx512::dot_kernel<3u>, avx512::dot_kernel<4u>,
+                                          avx512::normalize_kernel<3u>, avx512::normalize_kernel<4u>,
+                                          avx512::transform_kernel, multiply_kernel<sse2::transform_kernel> };
+#endif
+  assert(is_supported(isa));
+  switch (isa) {
+#ifdef MATH_SIMD
+    case Isa::sse2: return sse2_kernels;
+    case Isa::avx2: return avx2_kernels;
+    case Isa::avx512: return avx512_kernels;
+#endif
+    default: return scalar_kernels;
+  }
+}
+
+// kernels of the active level, selected once
+const Kernels & active_kernels() {
+  static const Kernels & kernels = get_kernels(get_active_isa());
+  return kernels;
+}
+
+void dot(std::span<const Vector3df> a, std::span<const Vector3df> b, std::span<float> result) {
+  assert(a.size() == b.size() && result.size() >= a.size());
+  active_kernels().dot3(a, b, result);
+}
+
+void dot(std::span<const Vector4df> a, std::span<const Vector4df> b, std::span<float> result) {
+  assert(a.size() == b.size() && result.size() >= a.size());
+  active_kernels().dot4(a, b, result);
+}
+
+void normalize(std::span<Vector3df> vectors) {
+  active_kernels().normalize3(vectors);
+}
+
+void normalize(std::span<Vector4df> vectors) {
+  active_kernels().normalize4(vectors);
+}
+
+void transform(const SquareMatrix4df & matrix, std::span<const Vector4df> points, std::span<Vector4df> result) {
+  assert(result.size() >= points.size());
+  active_kernels().transform(matrix, points, result);
+}
+
+SquareMatrix4df multiply(const SquareMatrix4df & factor1, const SquareMatrix4df & factor2) {
+  SquareMatrix4df product;
+  active_kernels().multiply(factor1, factor2, product);
+  return product;
+}
+
+}
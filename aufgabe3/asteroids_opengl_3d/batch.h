@@ -0,0 +1,57 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <span>
+#include "math.h"
+#include "matrix.h"
+
+// bulk math kernels over spans of Vectors, compiled for several instruction set levels
+//
+// the best level supported by the cpu is selected once at the first call,
+// the environment variable MATH_ISA (scalar, sse2, avx2, avx512) forces a lower level,
+// e.g. for testing or comparing the variants
+namespace batch {
+
+enum class Isa { scalar, sse2, avx2, avx512 };
+
+// returns the name of the instruction set level as used by MATH_ISA
+const char * get_name(Isa isa);
+
+// returns true if the kernels of the given level are compiled in and the cpu supports them
+bool is_supported(Isa isa);
+
+// returns the level used by the functions below
+Isa get_active_isa();
+
+// one set of kernels per instruction set level
+// all spans of a call must have the same size
+struct Kernels {
+  // result[i] = a[i] * b[i]
+  void (*dot3)(std::span<const Vector3df> a, std::span<const Vector3df> b, std::span<float> result);
+  void (*dot4)(std::span<const Vector4df> a, std::span<const Vector4df> b, std::span<float> result);
+
+  // normalizes all vectors to the length 1
+  void (*normalize3)(std::span<Vector3df> vectors);
+  void (*normalize4)(std::span<Vector4df> vectors);
+
+  // result[i] = matrix * points[i]
+  void (*transform)(const SquareMatrix4df & matrix, std::span<const Vector4df> points, std::span<Vector4df> result);
+
+  // product = factor1 * factor2
+  void (*multiply)(const SquareMatrix4df & factor1, const SquareMatrix4df & factor2, SquareMatrix4df & product);
+};
+
+// returns the kernels of the given (supported) level
+const Kernels & get_kernels(Isa isa);
+
+// the kernels of the active level
+void dot(std::span<const Vector3df> a, std::span<const Vector3df> b, std::span<float> result);
+void dot(std::span<const Vector4df> a, std::span<const Vector4df> b, std::span<float> result);
+void normalize(std::span<Vector3df> vectors);
+void normalize(std::span<Vector4df> vectors);
+void transform(const SquareMatrix4df & matrix, std::span<const Vector4df> points, std::span<Vector4df> result);
+SquareMatrix4df multiply(const SquareMatrix4df & factor1, const SquareMatrix4df & factor2);
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include "batch.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// compares the instruction set levels of the batch kernels,
+// levels the cpu does not support are skipped
+
+namespace {
+
+constexpr size_t NO_OF_VECTORS = 4096u;
+
+template <size_t N>
+std::vector< Vector<float, N> > create_vectors() {
+  std::vector< Vector<float, N> > vectors(NO_OF_VECTORS);
+  for (size_t i = 0u; i < NO_OF_VECTORS; i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      vectors[i][axis] = 0.25f + static_cast<float>((i * 7u + axis * 13u) % 31u);
+    }
+  }
+  return vectors;
+}
+
+bool skip_unsupported(benchmark::State & state, batch::Isa isa) {
+  if (! batch::is_supported(isa)) {
+    state.SkipWithError("instruction set level not supported");
+    return true;
+  }
+  return false;
+}
+
+void BM_Dot3(benchmark::State & state, batch::Isa isa) {
+  if (skip_unsupported(state, isa)) {
+    return;
+  }
+  auto a = create_vectors<3u>();
+  auto b = create_vectors<3u>();
+  std::vector<float> result(NO_OF_VECTORS);
+  const batch::Kernels & kernels = batch::get_kernels(isa);
+  for (auto _ : state) {
+    kernels.dot3(a, b, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+void BM_Normalize4(benchmark::State & state, batch::Isa isa) {
+  if (skip_unsupported(state, isa)) {
+    return;
+  }
+  auto vectors = create_vectors<4u>();
+  const batch::Kernels & kernels = batch::get_kernels(isa);
+  for (auto _ : state) {
+    kernels.normalize4(vectors);
+    benchmark::DoNotOptimize(vectors.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+void BM_Transform(benchmark::State & state, batch::Isa isa) {
+  if (skip_unsupported(state, isa)) {
+    return;
+  }
+  auto points = create_vectors<4u>();
+  std::vector<Vector4df> result(NO_OF_VECTORS);
+  SquareMatrix4df matrix = { {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.5f, 0.5f, 0.0f},
+                             {0.0f, -0.5f, 0.5f, 0.0f}, {3.0f, 2.0f, 1.0f, 1.0f} };
+  const batch::Kernels & kernels = batch::get_kernels(isa);
+  for (auto _ : state) {
+    kernels.transform(matrix, points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+void BM_Multiply(benchmark::State & state, batch::Isa isa) {
+  if (skip_unsupported(state, isa)) {
+    return;
+  }
+  SquareMatrix4df matrix = { {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 0.5f, 0.5f, 0.0f},
+                             {0.0f, -0.5f, 0.5f, 0.0f}, {3.0f, 2.0f, 1.0f, 1.0f} };
+  SquareMatrix4df product;
+  const batch::Kernels & kernels = batch::get_kernels(isa);
+  for (auto _ : state) {
+    kernels.multiply(matrix, matrix, product);
+    benchmark::DoNotOptimize(product);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_Dot3, scalar, batch::Isa::scalar);
+BENCHMARK_CAPTURE(BM_Dot3, sse2, batch::Isa::sse2);
+BENCHMARK_CAPTURE(BM_Dot3, avx2, batch::Isa::avx2);
+BENCHMARK_CAPTURE(BM_Dot3, avx512, batch::Isa::avx512);
+BENCHMARK_CAPTURE(BM_Normalize4, scalar, batch::Isa::scalar);
+BENCHMARK_CAPTURE(BM_Normalize4, sse2, batch::Isa::sse2);
+BENCHMARK_CAPTURE(BM_Normalize4, avx2, batch::Isa::avx2);
+BENCHMARK_CAPTURE(BM_Normalize4, avx512, batch::Isa::avx512);
+BENCHMARK_CAPTURE(BM_Transform, scalar, batch::Isa::scalar);
+BENCHMARK_CAPTURE(BM_Transform, sse2, batch::Isa::sse2);
+BENCHMARK_CAPTURE(BM_Transform, avx2, batch::Isa::avx2);
+BENCHMARK_CAPTURE(BM_Transform, avx512, batch::Isa::avx512);
+BENCHMARK_CAPTURE(BM_Multiply, scalar, batch::Isa::scalar);
+BENCHMARK_CAPTURE(BM_Multiply, sse2, batch::Isa::sse2);
+BENCHMARK_CAPTURE(BM_Multiply, avx2, batch::Isa::avx2);
+BENCHMARK_CAPTURE(BM_Multiply, avx512, batch::Isa::avx512);
+
+}
+
+BENCHMARK_MAIN();
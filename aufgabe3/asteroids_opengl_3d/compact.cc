@@ -0,0 +1,268 @@
+#include "compact.h"
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#ifdef MATH_SIMD
+#include <immintrin.h>
+#endif
+
+namespace compact {
+
+// the bit manipulations follow F. Giesen, "half <-> float conversions" (float_to_half_fast3_rtne
+// and half_to_float_fast5), they round like the F16C instructions
+uint16_t to_half(float value) {
+  uint32_t bits = std::bit_cast<uint32_t>(value);
+  const uint16_t sign = (bits >> 16) & 0x8000u;
+  bits &= 0x7fffffffu;
+  if (bits >= 0x7f800000u) { // infinity stays infinity, NaN becomes a quiet NaN
+    return sign | 0x7c00u | (bits > 0x7f800000u ? 0x0200u | ((bits >> 13) & 0x03ffu) : 0u);
+  }
+  if (bits >= 0x477ff000u) { // 65520 and above round to infinity
+    return sign | 0x7c00u;
+  }
+  if (bits < 0x38800000u) { // below 2^-14: subnormal half or zero
+    // adding 0.5 shifts the mantissa to the lowest bits, rounded by the fpu to nearest even
+    float shifted = std::bit_cast<float>(bits) + 0.5f;
+    return sign | (std::bit_cast<uint32_t>(shifted) - 0x3f000000u);
+  }
+  const uint32_t odd = (bits >> 13) & 1u;
+  bits += (static_cast<uint32_t>(15 - 127) << 23) + 0x0fffu + odd; // rebias and round to nearest even
+  return sign | (bits >> 13);
+}
+
+float from_half(uint16_t half) {
+  constexpr uint32_t exponent_mask = 0x7c00u << 13;
+  uint32_t bits = (half & 0x7fffu) << 13;
+  const uint32_t exponent = bits & exponent_mask;
+  bits += static_cast<uint32_t>(127 - 15) << 23;
+  if (exponent == exponent_mask) { // infinity or NaN
+    bits += static_cast<uint32_t>(128 - 16) << 23;
+  } else if (exponent == 0u) { // zero or subnormal, renormalized by the fpu
+    bits += 1u << 23;
+    bits = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) - std::bit_cast<float>(113u << 23));
+  }
+  return std::bit_cast<float>(bits | (static_cast<uint32_t>(half & 0x8000u) << 16));
+}
+
+template <class INT>
+INT to_snorm(float value) {
+  constexpr float max = std::numeric_limits<INT>::max();
+  // fmax returns -1 for NaN
+  return static_cast<INT>(std::nearbyint(std::fmin(std::fmax(value, -1.0f), 1.0f) * max));
+}
+
+template <class INT>
+float from_snorm(INT snorm) {
+  constexpr float max = std::numeric_limits<INT>::max();
+  // the division is exact for +-max, min() = -max - 1 is clamped to -1
+  return std::fmax(snorm / max, -1.0f);
+}
+
+#ifdef MATH_SIMD
+namespace sse {
+
+template <size_t N>
+inline __m128 load(const Vector<float, N> & v) {
+  if constexpr (N == 2u) {
+    return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(v.vector.data())));
+  } else {
+    return _mm_loadu_ps(v.vector.data());
+  }
+}
+
+// the values of the unused lanes are zero, so the padding of a Vector3df stays zero
+template <size_t N>
+inline void store(Vector<float, N> & v, __m128 value) {
+  if constexpr (N == 2u) {
+    _mm_storel_pi(reinterpret_cast<__m64 *>(v.vector.data()), value);
+  } else {
+    _mm_storeu_ps(v.vector.data(), value);
+  }
+}
+
+template <class UINT>
+inline uint64_t load_unsigned(const unsigned char * bytes) {
+  UINT value;
+  std::memcpy(&value, bytes, sizeof(UINT));
+  return value;
+}
+
+// loads SIZE bytes with full integer loads, a copy into a zeroed 8 byte variable
+// on the stack would be followed by a wider load and stall the store forwarding
+template <size_t SIZE>
+inline uint64_t load_bytes(const unsigned char * bytes) {
+  if constexpr (SIZE == 8u) {
+    return load_unsigned<uint64_t>(bytes);
+  } else if constexpr (SIZE >= 4u) {
+    return load_unsigned<uint32_t>(bytes) | (load_bytes<SIZE - 4u>(bytes + 4u) << 32);
+  } else if constexpr (SIZE >= 2u) {
+    return load_unsigned<uint16_t>(bytes) | (load_bytes<SIZE - 2u>(bytes + 2u) << 16);
+  } else if constexpr (SIZE == 1u) {
+    return load_unsigned<uint8_t>(bytes);
+  } else {
+    return 0u;
+  }
+}
+
+// the compact values of a vector, copied from and to the lowest bytes of a register
+template <class T, size_t N>
+inline __m128i load_values(const std::array<T, N> & values) {
+  return _mm_cvtsi64_si128(load_bytes<sizeof(T) * N>(reinterpret_cast<const unsigned char *>(values.data())));
+}
+
+template <class T, size_t N>
+inline void store_values(std::array<T, N> & values, __m128i value) {
+  uint64_t bits = _mm_cvtsi128_si64(value);
+  std::memcpy(values.data(), &bits, sizeof(T) * N);
+}
+
+template <size_t N>
+__attribute__((target("f16c")))
+void pack_half(std::span<const Vector<float, N>> values, std::span<HalfVector<N>> result) {
+  const size_t count = values.size();
+  for (size_t i = 0u; i < count; i++) {
+    store_values(result[i].values, _mm_cvtps_ph(load(values[i]), _MM_FROUND_TO_NEAREST_INT));
+  }
+}
+
+template <size_t N>
+__attribute__((target("f16c")))
+void unpack_half(std::span<const HalfVector<N>> values, std::span<Vector<float, N>> result) {
+  const size_t count = values.size();
+  for (size_t i = 0u; i < count; i++) {
+    store(result[i], _mm_cvtph_ps(load_values(values[i].values)));
+  }
+}
+
+bool supports_f16c() {
+  static const bool supported = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("f16c") != 0;
+  }();
+  return supported;
+}
+
+template <class INT, size_t N>
+void pack_snorm(std::span<const Vector<float, N>> values, std::span<SnormVector<INT, N>> result) {
+  const __m128 max = _mm_set1_ps(std::numeric_limits<INT>::max());
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 minus_one = _mm_set1_ps(-1.0f);
+  const size_t count = values.size();
+  for (size_t i = 0u; i < count; i++) {
+    // maxps returns its second operand for NaN, like fmax in to_snorm
+    __m128 clamped = _mm_min_ps(_mm_max_ps(load(values[i]), minus_one), one);
+    __m128i snorm = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(clamped, max)), _mm_setzero_si128());
+    if constexpr (sizeof(INT) == 1u) {
+      snorm = _mm_packs_epi16(snorm, snorm);
+    }
+    store_values(result[i].values, snorm);
+  }
+}
+
+template <class INT, size_t N>
+void unpack_snorm(std::span<const SnormVector<INT, N>> values, std::span<Vector<float, N>> result) {
+  const __m128 max = _mm_set1_ps(std::numeric_limits<INT>::max());
+  const __m128 minus_one = _mm_set1_ps(-1.0f);
+  const size_t count = values.size();
+  for (size_t i = 0u; i < count; i++) {
+    // sign extension: the value is moved to the highest bytes of each 32 bit lane
+    __m128i snorm = load_values(values[i].values);
+    if constexpr (sizeof(INT) == 1u) {
+      snorm = _mm_unpacklo_epi8(snorm, snorm);
+    }
+    snorm = _mm_srai_epi32(_mm_unpacklo_epi16(snorm, snorm), 32 - 8 * sizeof(INT));
+    store(result[i], _mm_max_ps(_mm_div_ps(_mm_cvtepi32_ps(snorm), max), minus_one));
+  }
+}
+
+}
+#endif
+
+template <size_t N>
+void pack(std::span<const Vector<float, N>> values, std::span<HalfVector<N>> result) {
+  assert(values.size() == result.size());
+#ifdef MATH_SIMD
+  if (sse::supports_f16c()) {
+    sse::pack_half(values, result);
+    return;
+  }
+#endif
+  for (size_t i = 0u; i < values.size(); i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      result[i].values[axis] = to_half(values[i][axis]);
+    }
+  }
+}
+
+template <size_t N>
+void unpack(std::span<const HalfVector<N>> values, std::span<Vector<float, N>> result) {
+  assert(values.size() == result.size());
+#ifdef MATH_SIMD
+  if (sse::supports_f16c()) {
+    sse::unpack_half(values, result);
+    return;
+  }
+#endif
+  for (size_t i = 0u; i < values.size(); i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      result[i][axis] = from_half(values[i].values[axis]);
+    }
+  }
+}
+
+template <class INT, size_t N>
+void pack(std::span<const Vector<float, N>> values, std::span<SnormVector<INT, N>> result) {
+  assert(values.size() == result.size());
+#ifdef MATH_SIMD
+  sse::pack_snorm(values, result);
+#else
+  for (size_t i = 0u; i < values.size(); i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      result[i].values[axis] = to_snorm<INT>(values[i][axis]);
+    }
+  }
+#endif
+}
+
+template <class INT, size_t N>
+void unpack(std::span<const SnormVector<INT, N>> values, std::span<Vector<float, N>> result) {
+  assert(values.size() == result.size());
+#ifdef MATH_SIMD
+  sse::unpack_snorm(values, result);
+#else
+  for (size_t i = 0u; i < values.size(); i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      result[i][axis] = from_snorm(values[i].values[axis]);
+    }
+  }
+#endif
+}
+
+template int8_t to_snorm(float value);
+template int16_t to_snorm(float value);
+template float from_snorm(int8_t snorm);
+template float from_snorm(int16_t snorm);
+
+template void pack(std::span<const Vector<float, 2u>> values, std::span<HalfVector<2u>> result);
+template void pack(std::span<const Vector<float, 3u>> values, std::span<HalfVector<3u>> result);
+template void pack(std::span<const Vector<float, 4u>> values, std::span<HalfVector<4u>> result);
+template void unpack(std::span<const HalfVector<2u>> values, std::span<Vector<float, 2u>> result);
+template void unpack(std::span<const HalfVector<3u>> values, std::span<Vector<float, 3u>> result);
+template void unpack(std::span<const HalfVector<4u>> values, std::span<Vector<float, 4u>> result);
+
+template void pack(std::span<const Vector<float, 2u>> values, std::span<SnormVector<int8_t, 2u>> result);
+template void pack(std::span<const Vector<float, 3u>> values, std::span<SnormVector<int8_t, 3u>> result);
+template void pack(std::span<const Vector<float, 4u>> values, std::span<SnormVector<int8_t, 4u>> result);
+template void pack(std::span<const Vector<float, 2u>> values, std::span<SnormVector<int16_t, 2u>> result);
+template void pack(std::span<const Vector<float, 3u>> values, std::span<SnormVector<int16_t, 3u>> result);
+template void pack(std::span<const Vector<float, 4u>> values, std::span<SnormVector<int16_t, 4u>> result);
+template void unpack(std::span<const SnormVector<int8_t, 2u>> values, std::span<Vector<float, 2u>> result);
+template void unpack(std::span<const SnormVector<int8_t, 3u>> values, std::span<Vector<float, 3u>> result);
+template void unpack(std::span<const SnormVector<int8_t, 4u>> values, std::span<Vector<float, 4u>> result);
+template void unpack(std::span<const SnormVector<int16_t, 2u>> values, std::span<Vector<float, 2u>> result);
+template void unpack(std::span<const SnormVector<int16_t, 3u>> values, std::span<Vector<float, 3u>> result);
+template void unpack(std::span<const SnormVector<int16_t, 4u>> values, std::span<Vector<float, 4u>> result);
+
+}
@@ -0,0 +1,67 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include "math.h"
+
+// storage only vector types for mesh data (normals, colors) and archived states
+// they are converted to Vector<float, N> for any computation
+//
+// HalfVector stores IEEE 754 binary16 values (2 bytes, 11 significant bits, range +-65504),
+// SnormVector stores values of [-1, 1] as signed normalized integers (1 or 2 bytes),
+// compared to a Vector3df (16 bytes with padding) a HalfVector<3u> takes 6 bytes,
+// a SnormVector<int8_t, 3u> takes 3 bytes
+namespace compact {
+
+template <size_t N>
+struct HalfVector {
+  std::array<uint16_t, N> values{};
+};
+
+// INT is int8_t or int16_t, the value max() represents 1.0 and -max() represents -1.0
+template <class INT, size_t N>
+struct SnormVector {
+  std::array<INT, N> values{};
+};
+
+typedef HalfVector<3u> HalfVector3;
+typedef HalfVector<4u> HalfVector4;
+typedef SnormVector<int8_t, 3u> Snorm8Vector3;
+typedef SnormVector<int8_t, 4u> Snorm8Vector4;
+typedef SnormVector<int16_t, 3u> Snorm16Vector3;
+typedef SnormVector<int16_t, 4u> Snorm16Vector4;
+
+// returns the nearest half value (ties to even), values above 65504 become infinity
+uint16_t to_half(float value);
+
+// returns the exact float value of the given half value
+float from_half(uint16_t half);
+
+// returns the nearest snorm value (ties to even) of value clamped to [-1, 1], NaN becomes -max()
+template <class INT>
+INT to_snorm(float value);
+
+// returns snorm / max() clamped to [-1, 1]
+template <class INT>
+float from_snorm(INT snorm);
+
+// bulk conversions, result[i] = conversion of values[i], both spans must have the same size
+// the results are the same as those of the scalar conversions above, the half kernels
+// use the F16C instructions if the cpu supports them
+template <size_t N>
+void pack(std::span<const Vector<float, N>> values, std::span<HalfVector<N>> result);
+
+template <size_t N>
+void unpack(std::span<const HalfVector<N>> values, std::span<Vector<float, N>> result);
+
+template <class INT, size_t N>
+void pack(std::span<const Vector<float, N>> values, std::span<SnormVector<INT, N>> result);
+
+template <class INT, size_t N>
+void unpack(std::span<const SnormVector<INT, N>> values, std::span<Vector<float, N>> result);
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#include "compact.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// throughput of the conversions between Vector3df (16 bytes) and the compact
+// storage types, compared to copying the Vector3df values
+
+namespace {
+
+using namespace compact;
+
+constexpr size_t NO_OF_VECTORS = 4096u;
+
+std::vector<Vector3df> create_normals() {
+  std::vector<Vector3df> normals(NO_OF_VECTORS);
+  for (size_t i = 0u; i < NO_OF_VECTORS; i++) {
+    normals[i] = {0.25f + static_cast<float>(i % 31u), 1.0f, -static_cast<float>(i % 7u)};
+    normals[i].normalize();
+  }
+  return normals;
+}
+
+void BM_Copy(benchmark::State & state) {
+  auto normals = create_normals();
+  std::vector<Vector3df> result(NO_OF_VECTORS);
+  for (auto _ : state) {
+    std::copy(normals.begin(), normals.end(), result.begin());
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+void BM_PackHalf(benchmark::State & state) {
+  auto normals = create_normals();
+  std::vector<HalfVector3> result(NO_OF_VECTORS);
+  for (auto _ : state) {
+    pack<3u>(normals, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+void BM_UnpackHalf(benchmark::State & state) {
+  auto normals = create_normals();
+  std::vector<HalfVector3> halfs(NO_OF_VECTORS);
+  pack<3u>(normals, halfs);
+  for (auto _ : state) {
+    unpack<3u>(halfs, normals);
+    benchmark::DoNotOptimize(normals.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+// the scalar conversion, as used without F16C
+void BM_PackHalfScalar(benchmark::State & state) {
+  auto normals = create_normals();
+  std::vector<HalfVector3> result(NO_OF_VECTORS);
+  for (auto _ : state) {
+    for (size_t i = 0u; i < NO_OF_VECTORS; i++) {
+      for (size_t axis = 0u; axis < 3u; axis++) {
+        result[i].values[axis] = to_half(normals[i][axis]);
+      }
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class INT>
+void BM_PackSnorm(benchmark::State & state) {
+  auto normals = create_normals();
+  std::vector< SnormVector<INT, 3u> > result(NO_OF_VECTORS);
+  for (auto _ : state) {
+    pack<INT, 3u>(normals, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class INT>
+void BM_UnpackSnorm(benchmark::State & state) {
+  auto normals = create_normals();
+  std::vector< SnormVector<INT, 3u> > snorms(NO_OF_VECTORS);
+  pack<INT, 3u>(normals, snorms);
+  for (auto _ : state) {
+    unpack<INT, 3u>(snorms, normals);
+    benchmark::DoNotOptimize(normals.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+BENCHMARK(BM_Copy);
+BENCHMARK(BM_PackHalf);
+BENCHMARK(BM_UnpackHalf);
+BENCHMARK(BM_PackHalfScalar);
+BENCHMARK(BM_PackSnorm<int8_t>);
+BENCHMARK(BM_UnpackSnorm<int8_t>);
+BENCHMARK(BM_PackSnorm<int16_t>);
+BENCHMARK(BM_UnpackSnorm<int16_t>);
+
+}
+
+BENCHMARK_MAIN();
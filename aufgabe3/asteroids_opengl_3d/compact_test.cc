@@ -0,0 +1,141 @@
+#include "compact.h"
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace {
+
+using namespace compact;
+
+// deterministic values of all magnitudes, including subnormal halfs and values above 65504
+std::vector<float> create_floats() {
+  std::vector<float> floats;
+  uint32_t state = 12345u;
+  for (size_t i = 0u; i < 4000u; i++) {
+    state = state * 1664525u + 1013904223u;
+    float mantissa = static_cast<float>(state >> 8) / (1u << 24) * 2.0f - 1.0f;
+    floats.push_back(std::ldexp(mantissa, static_cast<int>(i % 48u) - 30));
+  }
+  return floats;
+}
+
+template <size_t N>
+std::vector< Vector<float, N> > create_vectors(const std::vector<float> & floats, float max = 1.0e6f) {
+  std::vector< Vector<float, N> > vectors(floats.size() / N);
+  for (size_t i = 0u; i < vectors.size(); i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      vectors[i][axis] = std::fmin(std::fmax(floats[i * N + axis], -max), max);
+    }
+  }
+  return vectors;
+}
+
+TEST(HALF, RoundTripOfAllHalfValues) {
+  for (uint32_t half = 0u; half <= 0xffffu; half++) {
+    bool is_nan = (half & 0x7c00u) == 0x7c00u && (half & 0x03ffu) != 0u;
+    if (! is_nan) {
+      EXPECT_EQ(half, to_half(from_half(half)));
+    }
+  }
+}
+
+TEST(HALF, KnownValues) {
+  EXPECT_EQ(0x3c00u, to_half(1.0f));
+  EXPECT_EQ(0xc000u, to_half(-2.0f));
+  EXPECT_EQ(0x7bffu, to_half(65504.0f));
+  EXPECT_EQ(0x7c00u, to_half(65520.0f));
+  EXPECT_EQ(0xfc00u, to_half(-std::numeric_limits<float>::infinity()));
+  EXPECT_EQ(0x0001u, to_half(std::ldexp(1.0f, -24)));
+  EXPECT_EQ(0x0000u, to_half(std::ldexp(1.0f, -26)));
+  EXPECT_EQ(0x8000u, to_half(-0.0f));
+  EXPECT_TRUE(std::isnan(from_half(to_half(std::numeric_limits<float>::quiet_NaN()))));
+
+  EXPECT_FLOAT_EQ(0.333251953125f, from_half(0x3555u));
+  EXPECT_FLOAT_EQ(std::ldexp(1.0f, -24), from_half(0x0001u));
+}
+
+TEST(HALF, RoundsToNearestEven) {
+  // 1 + 2^-11 is halfway between 1 and 1 + 2^-10
+  EXPECT_EQ(0x3c00u, to_half(1.0f + std::ldexp(1.0f, -11)));
+  EXPECT_EQ(0x3c02u, to_half(1.0f + 3.0f * std::ldexp(1.0f, -11)));
+  EXPECT_EQ(0x3c01u, to_half(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)));
+}
+
+template <size_t N>
+void expect_bulk_half_equals_scalar() {
+  auto vectors = create_vectors<N>(create_floats());
+  std::vector< HalfVector<N> > halfs(vectors.size());
+  std::vector< Vector<float, N> > unpacked(vectors.size());
+
+  pack<N>(vectors, halfs);
+  unpack<N>(halfs, unpacked);
+
+  for (size_t i = 0u; i < vectors.size(); i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      ASSERT_EQ(to_half(vectors[i][axis]), halfs[i].values[axis]);
+      ASSERT_EQ(from_half(halfs[i].values[axis]), unpacked[i][axis]);
+    }
+    for (size_t padding = N; padding < unpacked[i].vector.size(); padding++) {
+      ASSERT_EQ(0.0f, unpacked[i].vector[padding]);
+    }
+  }
+}
+
+TEST(HALF, BulkConversionEqualsScalar) {
+  expect_bulk_half_equals_scalar<2u>();
+  expect_bulk_half_equals_scalar<3u>();
+  expect_bulk_half_equals_scalar<4u>();
+}
+
+TEST(SNORM, RoundTripOfAllSnormValues) {
+  for (int snorm = -127; snorm <= 127; snorm++) {
+    EXPECT_EQ(snorm, to_snorm<int8_t>(from_snorm<int8_t>(snorm)));
+  }
+  for (int snorm = -32767; snorm <= 32767; snorm++) {
+    EXPECT_EQ(snorm, to_snorm<int16_t>(from_snorm<int16_t>(snorm)));
+  }
+  EXPECT_EQ(-1.0f, from_snorm<int8_t>(-128));
+  EXPECT_EQ(-1.0f, from_snorm<int16_t>(-32768));
+  EXPECT_EQ(1.0f, from_snorm<int16_t>(32767));
+}
+
+TEST(SNORM, ClampsAndRounds) {
+  EXPECT_EQ(127, to_snorm<int8_t>(2.0f));
+  EXPECT_EQ(-127, to_snorm<int8_t>(-2.0f));
+  EXPECT_EQ(-127, to_snorm<int8_t>(std::numeric_limits<float>::quiet_NaN()));
+  EXPECT_EQ(64, to_snorm<int8_t>(0.5f)); // 63.5 rounds to even
+  EXPECT_EQ(0, to_snorm<int16_t>(0.0f));
+  EXPECT_NEAR(0.5f, from_snorm(to_snorm<int16_t>(0.5f)), 1.0f / 32767);
+}
+
+template <class INT, size_t N>
+void expect_bulk_snorm_equals_scalar() {
+  auto vectors = create_vectors<N>(create_floats(), 2.0f);
+  std::vector< SnormVector<INT, N> > snorms(vectors.size());
+  std::vector< Vector<float, N> > unpacked(vectors.size());
+
+  pack<INT, N>(vectors, snorms);
+  unpack<INT, N>(snorms, unpacked);
+
+  for (size_t i = 0u; i < vectors.size(); i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      ASSERT_EQ(to_snorm<INT>(vectors[i][axis]), snorms[i].values[axis]);
+      ASSERT_EQ(from_snorm<INT>(snorms[i].values[axis]), unpacked[i][axis]);
+    }
+    for (size_t padding = N; padding < unpacked[i].vector.size(); padding++) {
+      ASSERT_EQ(0.0f, unpacked[i].vector[padding]);
+    }
+  }
+}
+
+TEST(SNORM, BulkConversionEqualsScalar) {
+  expect_bulk_snorm_equals_scalar<int8_t, 2u>();
+  expect_bulk_snorm_equals_scalar<int8_t, 3u>();
+  expect_bulk_snorm_equals_scalar<int8_t, 4u>();
+  expect_bulk_snorm_equals_scalar<int16_t, 2u>();
+  expect_bulk_snorm_equals_scalar<int16_t, 3u>();
+  expect_bulk_snorm_equals_scalar<int16_t, 4u>();
+}
+
+}
@@ -1,7 +1,11 @@
 #include "game.h"
 #include "debug.h"
+#include "shapes.h"
 #include <iostream>
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <random>
 #include <GL/glew.h>
 
 const int SCREEN_WIDTH = 1024;
@@ -29,28 +33,28 @@ void displacement_fix(Body2df * body, float seconds) {
   body->set_position(new_position);
 }
 
-Asteroid::Asteroid(short size)
+Asteroid::Asteroid(RandomGenerator & random, short size)
   : TypedBody( BodyType::asteroid,
-               Body2df{ BoundingVolume2df{ Vector2df{ 128.0f + 768.0f * dis(gen), 64.0f + 640.0f * dis(gen) }, size * 11.0f },
-                         Vector2df{ 0.5f - dis(gen), 0.5f - dis(gen) },
+               Body2df{ BoundingVolume2df{ Vector2df{ 128.0f + 768.0f * draw(random), 64.0f + 640.0f * draw(random) }, size * 11.0f },
+                         Vector2df{ 0.5f - draw(random), 0.5f - draw(random) },
                          348.0, 0.0, 0.0, displacement_fix } ),
     size(size),
-    rock_type( std::trunc(4 * dis(gen)) )
+    rock_type( std::trunc(4 * draw(random)) )
   {
 
     velocity /= velocity.length();
     if (size == 3) { /* 5 - 10 s to cross the screen */
-      velocity *= 768.0f / 10.0f +  768.0f / 10.0f * dis(gen);
+      velocity *= 768.0f / 10.0f +  768.0f / 10.0f * draw(random);
     } else if (size == 2) { /* 4 - 8s */
-      velocity *= 768.0f / 8.0f +  768.0f / 8.0f * dis(gen);
+      velocity *= 768.0f / 8.0f +  768.0f / 8.0f * draw(random);
     } else if (size == 1) { /* 3 - 6s */
-      velocity *= 768.0f / 6.0f +  768.0f / 6.0f * dis(gen);
+      velocity *= 768.0f / 6.0f +  768.0f / 6.0f * draw(random);
     }
 
   }
 
 
-Asteroid::Asteroid(short size, Vector2df position ) : Asteroid(size) {
+Asteroid::Asteroid(RandomGenerator & random, short size, Vector2df position ) : Asteroid(random, size) {
   set_position(position);
 }
   
@@ -146,8 +150,8 @@ bool Spaceship::is_in_hyperspace() {
 void Spaceship::jump_into_hyperspace(Game & game) {
   if ( ! in_hyperspace && ! is_marked_for_deletion() ) {
     set_velocity({0.0f, 0.0f});
-    set_position({512.0f + 348.0f * (0.5f - dis(gen)) , 368.0f + 256.0f * (0.5f - dis(gen)) });
-    if ( dis(gen) < 0.25f ||  game.no_of_asteroids > (dis(gen) * 15.0f + 4.0f) ) {
+    set_position({512.0f + 348.0f * (0.5f - draw(game.random)) , 368.0f + 256.0f * (0.5f - draw(game.random)) });
+    if ( draw(game.random) < 0.25f ||  game.no_of_asteroids > (draw(game.random) * 15.0f + 4.0f) ) {
       game.destroy_spaceship(); 
     } else {
       in_hyperspace = true;
@@ -183,7 +187,7 @@ bool Saucer::shoot(Game & game) {
         new_body = std::make_unique<Torpedo>(get_position(), direct_shot.angle(0.0f,1.0f), get_velocity(), this );
         precise_shoot_counter = 6;
       } else {
-        direction_angle = PI * (1.0f - 2.0f * static_cast<float>(dis(gen)));
+        direction_angle = PI * (1.0f - 2.0f * static_cast<float>(draw(game.random)));
         new_body = std::make_unique<Torpedo>(get_position(), direction_angle, get_velocity(), this);
         precise_shoot_counter--;
       }
@@ -198,12 +202,12 @@ bool Saucer::shoot(Game & game) {
 
 
 
-void Saucer::change_direction() {
+void Saucer::change_direction(RandomGenerator & random) {
   if ( change_direction_cooldown.get_time() < 0.0f && ! is_marked_for_deletion()) {
-    float random = dis(gen);
-    if ( random < 0.33 ) {
+    float number = draw(random);
+    if ( number < 0.33 ) {
       velocity[1] = 0.0f;
-    } else if (random < 0.66) {
+    } else if (number < 0.66) {
       velocity[1] = 768.0f / 8.0f;
     } else {
       velocity[1] = -768.0f / 8.0f;
@@ -220,7 +224,7 @@ void Saucer::pass_time(float seconds, Game & game) {
   }
   change_direction_cooldown.tick(seconds);
   if (change_direction_cooldown.get_time() < 0.0) {
-    change_direction();
+    change_direction(game.random);
   }
 }
 
@@ -251,28 +255,31 @@ void Saucer::remove(Torpedo *torpedo) {
 }
 
 
-Game::Game() {
+Game::Game() : Game(std::random_device{}()) {
+}
+
+Game::Game(uint64_t seed) : random(seed) {
 }
 
 void Game::spawn_asteroids() {
   no_of_asteroids = current_no_of_asteroids;
   for (size_t i = 0; i < no_of_asteroids; i++) {
     Vector2df position = {0, 0};
-    float random = dis(gen);
-    if ( random < 0.25 ) {
-      position[0] = 128.0f * dis(gen);
-      position[1] = 768.0f * dis(gen);
-    } else if ( random < 0.5) {
-      position[0] = 1024.0f - 128.0f * dis(gen);
-      position[1] = 768.0f * dis(gen);
-    } else if ( random < 0.75 ) {
-      position[0] = 1024.0f * dis(gen);
-      position[1] = 98.0f * dis(gen);
+    float number = draw(random);
+    if ( number < 0.25 ) {
+      position[0] = 128.0f * draw(random);
+      position[1] = 768.0f * draw(random);
+    } else if ( number < 0.5) {
+      position[0] = 1024.0f - 128.0f * draw(random);
+      position[1] = 768.0f * draw(random);
+    } else if ( number < 0.75 ) {
+      position[0] = 1024.0f * draw(random);
+      position[1] = 98.0f * draw(random);
     } else {
-      position[0] = 1024.0f * dis(gen);
-      position[1] = 768.0f - 98.0f * dis(gen);      
+      position[0] = 1024.0f * draw(random);
+      position[1] = 768.0f - 98.0f * draw(random);      
     }
-    std::unique_ptr<Body2df> new_body = std::make_unique<Asteroid>(3, position);    
+    std::unique_ptr<Body2df> new_body = std::make_unique<Asteroid>(random, 3, position);    
     physics.add_body(new_body);
   }
   if (current_no_of_asteroids < MAXIMUM_ASTEROIDS_SPAWNING - 1) {
@@ -290,6 +297,10 @@ Physics2df & Game::get_physics() {
   return physics;
 }
 
+void Game::set_outline_collisions(bool enabled) {
+  outline_collisions = enabled;
+}
+
 
 void Game::accelerate_ship(float tick_time) {
   if ( ship_exists() && ship->can_accelerate(tick_time) ) {
@@ -313,11 +324,11 @@ void Game::destroy_asteroid(Asteroid * asteroid) {
   if (asteroid->get_size() > 1) {
     if (no_of_asteroids < 26) {
       no_of_asteroids++;
-      new_body = std::make_unique<Asteroid>(asteroid->get_size() - 1, asteroid->get_position() );
+      new_body = std::make_unique<Asteroid>(random, asteroid->get_size() - 1, asteroid->get_position() );
       physics.add_body( new_body );
     }
     asteroid->mark_for_deletion();
-    new_body = std::make_unique<Asteroid>(asteroid->get_size() - 1, asteroid->get_position() );
+    new_body = std::make_unique<Asteroid>(random, asteroid->get_size() - 1, asteroid->get_position() );
     physics.add_body( new_body );
   } else {
     asteroid->mark_for_deletion();
@@ -483,11 +494,11 @@ void Game::new_saucer() {
     if ( time_since_start_of_level > 35.0f || score >= 30000LL) {
       type = 0;
     }
-    Vector2df position = { 10.0,   dis(gen) * (SCREEN_HEIGHT / 10 + (6 * SCREEN_HEIGHT) / 8)  };
+    Vector2df position = { 10.0,   draw(random) * (SCREEN_HEIGHT / 10 + (6 * SCREEN_HEIGHT) / 8)  };
     Vector2df velocity = { 1024.0f / 8.0f, 0.0 };
     BoundingVolume2df body{position, 10.0f};
     if ( area_free_of_asteroids(&body) ) {
-      if ( dis(gen) > 0.5 ) {
+      if ( draw(random) > 0.5 ) {
         position[0] = SCREEN_WIDTH - 10.0;
         velocity[0] = -velocity[0];
       }
@@ -577,20 +588,95 @@ void Game::resolve_collision(Body2df *body1, Body2df *body2) {
   }    
 }
   
+namespace {
+
+// the outlines of shapes.h decomposed into convex polygons, relative to the position of the body
+const ConvexDecomposition2df & asteroid_outline(short rock_type, short size) {
+  static const std::vector<ConvexDecomposition2df> outlines = [] {
+    std::vector<ConvexDecomposition2df> outlines;
+    for (std::span<const Vector2df> rock : shapes::asteroids) {
+      ConvexDecomposition2df outline(rock);
+      for (float scale : {0.25f, 0.5f, 1.0f}) {  // size 1, 2, 3
+        outlines.push_back( outline.transformed(0.0f, scale) );
+      }
+    }
+    return outlines;
+  }();
+  return outlines[3 * rock_type + size - 1];
+}
+
+// the lines of the saucer cross each other, it collides with its convex hull
+const ConvexDecomposition2df & saucer_outline(short size) {
+  static const std::array<ConvexDecomposition2df, 2> outlines = [] {
+    ConvexDecomposition2df hull( std::vector<ConvexPolygon2df>{ ConvexPolygon2df::convex_hull(shapes::saucer) } );
+    return std::array<ConvexDecomposition2df, 2>{ hull.transformed(0.0f, 0.25f), hull.transformed(0.0f, 0.5f) };
+  }();
+  return outlines[size];
+}
+
+// not rotated
+const ConvexDecomposition2df & spaceship_outline() {
+  static const ConvexDecomposition2df outline(shapes::spaceship);
+  return outline;
+}
+
+// the outline of an asteroid, a saucer, or a spaceship, not rotated by outline_angle(body)
+const ConvexDecomposition2df & outline(TypedBody * body) {
+  if (body->get_type() == BodyType::asteroid) {
+    Asteroid * asteroid = static_cast<Asteroid *>(body);
+    return asteroid_outline(asteroid->get_rock_type(), asteroid->get_size());
+  }
+  if (body->get_type() == BodyType::saucer) {
+    return saucer_outline(static_cast<Saucer *>(body)->get_size());
+  }
+  assert(body->get_type() == BodyType::spaceship);
+  return spaceship_outline();
+}
+
+// only the spaceship is drawn rotated
+float outline_angle(TypedBody * body) {
+  return body->get_type() == BodyType::spaceship ? body->get_angle() : 0.0f;
+}
+
+// tested in the frame of body2, i.e. rotated backwards by its angle, no outline is transformed
+bool outlines_collide(TypedBody *body1, TypedBody *body2, float tick_time) {
+  if (body2->get_type() == BodyType::torpedo) {
+    std::swap(body1, body2);
+  }
+  float angle2 = outline_angle(body2);
+  float cosine = std::cos(angle2);
+  float sine = std::sin(angle2);
+  auto to_frame2 = [cosine, sine](Vector2df v) {
+    return Vector2df{cosine * v[0] + sine * v[1], cosine * v[1] - sine * v[0]};
+  };
+  Vector2df offset = to_frame2(body1->get_position() - body2->get_position());
+  if (body1->get_type() == BodyType::torpedo) {
+    Vector2df start = offset - tick_time * to_frame2(body1->get_velocity() - body2->get_velocity());
+    return outline(body2).intersects_segment(start, offset);
+  }
+  return outline(body2).intersects_rotated(outline(body1), outline_angle(body1) - angle2, offset);
+}
+
+}
+
+bool bodies_collide(TypedBody *body1, TypedBody *body2, bool outlines, float tick_time) {
+  bool torpedo = body1->get_type() == BodyType::torpedo
+                  || body2->get_type() == BodyType::torpedo;
+  bool asteroid = body1->get_type() == BodyType::asteroid
+                  || body2->get_type() == BodyType::asteroid;
+  bool spaceship = body1->get_type() == BodyType::spaceship
+                  || body2->get_type() == BodyType::spaceship;
+  bool saucer = body1->get_type() == BodyType::saucer
+                  || body2->get_type() == BodyType::saucer;
+  bool collision = ( torpedo && (asteroid || spaceship || saucer ) )
+                   || (asteroid && (saucer || spaceship) )
+                   || (saucer && spaceship);
+  return collision && (!outlines || outlines_collide(body1, body2, tick_time));
+}
+
 bool Game::check_collision(Body2df *body1, Body2df *body2) {
-  TypedBody *typed_body1 = static_cast<TypedBody *>(body1);
-  TypedBody *typed_body2 = static_cast<TypedBody *>(body2);
-  bool torpedo = typed_body1->get_type() == BodyType::torpedo
-                  || typed_body2->get_type() == BodyType::torpedo;
-  bool asteroid = typed_body1->get_type() == BodyType::asteroid
-                  || typed_body2->get_type() == BodyType::asteroid;
-  bool spaceship = typed_body1->get_type() == BodyType::spaceship
-                  || typed_body2->get_type() == BodyType::spaceship;
-  bool saucer = typed_body1->get_type() == BodyType::saucer
-                  || typed_body2->get_type() == BodyType::saucer;
-  return ( torpedo && (asteroid || spaceship || saucer ) )
-       || (asteroid && (saucer || spaceship) )
-       || (saucer && spaceship);  
+  return bodies_collide(static_cast<TypedBody *>(body1), static_cast<TypedBody *>(body2),
+                        outline_collisions, physics.get_tick_time());
 }
 
 void Game::resolve_deleted_bodies(Body2df *body1) {
@@ -4,10 +4,10 @@
 #include <vector>  
 #include <utility>
 #include <array>
-#include <random>
 #include <memory>
 #include "timer.h"
 #include "physics.h" 
+#include "random_generator.h"
 
 // all different types of object used in this Asteroid-Game
 // for each type there will be a corresponding class
@@ -25,9 +25,11 @@ class Game;
 
 void displacement_fix(Body2df * body, float seconds = 1.0);
 
-static std::random_device rd;
-static std::mt19937 gen(rd());
-static std::uniform_real_distribution<float> dis(0.0, 0.99);
+// the random numbers of the game are drawn from [0, 0.99), not [0, 1),
+// like the uniform_real_distribution(0.0, 0.99) the game was tuned with
+inline float draw(RandomGenerator & random) {
+  return random.uniform(0.0f, 0.99f);
+}
 
 // the base class of all game objects
 class TypedBody : public Body2df {
@@ -41,13 +43,18 @@ public:
   }
 };
 
+// the collision rules of Game::check_collision for bodies whose bounding circles collide during a tick,
+// with outlines the narrow phase tests the outlines of shapes.h,
+// a torpedo is the line segment of its movement during the tick
+bool bodies_collide(TypedBody *body1, TypedBody *body2, bool outlines, float tick_time);
+
 class Asteroid : public TypedBody {
 short size; // 3 = big, 2 = medium, 1 = small
 short rock_type; // one of the four different rock types
 public:
-  Asteroid(short size = 3);
+  Asteroid(RandomGenerator & random, short size = 3);
 
-  Asteroid(short size, Vector2df position );
+  Asteroid(RandomGenerator & random, short size, Vector2df position );
   
   short get_size() const;
   
@@ -68,10 +75,11 @@ public:
 
   Torpedo(Vector2df position, float angle, Vector2df velocity, TypedBody * origin)
     : TypedBody(BodyType::torpedo, 
-                Body2df{ BoundingVolume2df{position + 14.0f * Vector2df( angle ), 1.0},
-                         velocity + 1.1f * MAX_SPEED / 2.0f * Vector2df( angle ),
+                Body2df{ BoundingVolume2df{position + 14.0f * fast::unit_vector<2u>( angle ), 1.0},
+                         velocity + 1.1f * MAX_SPEED / 2.0f * fast::unit_vector<2u>( angle ),
                          MAX_SPEED, 0.0f, angle, displacement_fix} ) 
     { set_time_to_delete(1.2f);
+      set_fast(true); // hits small asteroids at low tick rates, too
       this->origin = origin; 
     }
 
@@ -149,7 +157,7 @@ public:
       }
     }
   bool shoot(Game & game);
-  void change_direction();
+  void change_direction(RandomGenerator & random);
   void pass_time(float seconds, Game & game);
   short get_size() const;
   void remove(Torpedo *torpedo);
@@ -200,6 +208,7 @@ class Game {
   long long score = 0LL;
   // check_collision must not have side effects
   bool check_collision(Body2df *body1, Body2df *body2);
+  bool outline_collisions = false;
   void resolve_collision(Body2df *body1, Body2df *body2);
   void resolve_deleted_bodies(Body2df *body1);
   void destroy_asteroid(Asteroid * asteroid);
@@ -219,8 +228,12 @@ class Game {
   void add_score(long long points);
   bool area_free_of_asteroids(BoundingVolume2df * bounding);
   void remove(Saucer * saucer);
+  RandomGenerator random;
 public:
+  // seeded by std::random_device
   Game();
+  // the same seed and the same inputs result in the same game
+  explicit Game(uint64_t seed);
   void tick(float tick_time);
   void ship_shoots();
   void hyperspace();
@@ -232,6 +245,9 @@ public:
   bool saucer_exists() const;
   Spaceship * get_ship();
   Physics2df & get_physics();
+  // the narrow phase tests the outlines of shapes.h, for renderers drawing them (the SDL2 renderer),
+  // otherwise the bounding circles decide (the OpenGL renderer scales its meshes to them)
+  void set_outline_collisions(bool enabled);
   std::vector<GameEvent> & get_game_events();  
   friend class Saucer;
   friend class Spaceship;
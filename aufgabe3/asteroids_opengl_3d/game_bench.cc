@@ -0,0 +1,58 @@
+#include "game.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+
+// a tick of Physics2df in a scene of 1000 asteroids, 30 torpedoes, a turned spaceship, and a saucer
+// with the collision rules of Game::check_collision, with and without the outline narrow phase
+
+namespace {
+
+constexpr size_t NO_OF_ASTEROIDS = 1000u;
+constexpr size_t NO_OF_TORPEDOS = 30u;
+constexpr float TICK_TIME = 1.0f / 60.0f;
+
+void add(Physics2df & physics, std::unique_ptr<Body2df> body) {
+  physics.add_body(body);
+}
+
+// Arg(0): the bounding circles decide (the OpenGL renderer), Arg(1): the outlines of shapes.h (the SDL2 renderer),
+// the collisions are counted but not resolved, so the scene keeps all bodies
+void BM_AsteroidsTick(benchmark::State & state) {
+  bool outlines = state.range(0) == 1;
+  size_t circle_collisions = 0u;
+  size_t collisions = 0u;
+  Physics2df physics( [&](Body2df * body1, Body2df * body2) {
+    circle_collisions++;
+    bool collision = bodies_collide(static_cast<TypedBody *>(body1), static_cast<TypedBody *>(body2), outlines, TICK_TIME);
+    collisions += collision;
+    return collision;
+  } );
+  RandomGenerator random(11u);
+  for (size_t i = 0; i < NO_OF_ASTEROIDS; i++) {
+    short size = 1 + static_cast<short>(3.0f * random.uniform());
+    add(physics, std::make_unique<Asteroid>(random, size, Vector2df{1024.0f * random.uniform(), 768.0f * random.uniform()}));
+  }
+  for (size_t i = 0; i < NO_OF_TORPEDOS; i++) {
+    add(physics, std::make_unique<Torpedo>(Vector2df{1024.0f * random.uniform(), 768.0f * random.uniform()},
+                                           6.2831853f * random.uniform(), Vector2df{0.0f, 0.0f}, nullptr));
+  }
+  auto ship = std::make_unique<Spaceship>(Vector2df{512.0f, 384.0f});
+  ship->turn(1.0f);
+  add(physics, std::move(ship));
+  add(physics, std::make_unique<Saucer>(1, Vector2df{256.0f, 192.0f}));
+  physics.tick(TICK_TIME);  // adds the bodies
+
+  circle_collisions = 0u;
+  collisions = 0u;
+  for (auto _ : state) {
+    physics.tick(TICK_TIME);
+  }
+  state.counters["circle_collisions"] = static_cast<double>(circle_collisions) / state.iterations();
+  state.counters["collisions"] = static_cast<double>(collisions) / state.iterations();
+}
+
+BENCHMARK(BM_AsteroidsTick)->Arg(0)->Arg(1);
+
+}
+
+BENCHMARK_MAIN();
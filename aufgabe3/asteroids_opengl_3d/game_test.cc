@@ -58,4 +58,21 @@ TEST(GAME, ShipShoots) {
 }
 
 
+TEST(GAME, SameSeedSameAsteroids) {
+  Game game1{42u};
+  Game game2{42u};
+
+  game1.tick(0.05f);
+  game1.tick(0.05f);
+  game2.tick(0.05f);
+  game2.tick(0.05f);
+  auto & bodies1 = game1.get_physics().get_bodies();
+  auto & bodies2 = game2.get_physics().get_bodies();
+  ASSERT_EQ(bodies1.size(), bodies2.size());
+  for (size_t i = 0u; i < bodies1.size(); i++) {
+    EXPECT_EQ(bodies1[i]->get_position()[0], bodies2[i]->get_position()[0]);
+    EXPECT_EQ(bodies1[i]->get_position()[1], bodies2[i]->get_position()[1]);
+  }
+}
+
 }
\ No newline at end of file
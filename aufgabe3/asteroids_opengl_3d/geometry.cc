@@ -14,4 +14,39 @@ template class Sphere<float, 3u>;
 
 template class Triangle<float, 3u>; 
 
+template class OrientedBoundingBox<float, 2u>;
+template class OrientedBoundingBox<float, 3u>;
+template struct MeshBounds<float>;
+
+template class PrecomputedTriangle<float, 3u>;
+template class TriangleBlock<float, 3u, 4u>;
+template class TriangleBlock<float, 3u, 8u>;
+
+template class PreparedRay<float, 2u>;
+template class PreparedRay<float, 3u>;
+
+template class RayPacket<float, 3u, 4u>;
+template class RayPacket<float, 3u, 8u>;
+
+template uint32_t AxisAlignedBoundingBox<float, 3u>::intersects<4u>(const RayPacket4df &, const std::array<float, 4u> &, uint32_t) const;
+template uint32_t AxisAlignedBoundingBox<float, 3u>::intersects<8u>(const RayPacket8df &, const std::array<float, 8u> &, uint32_t) const;
+template uint32_t Sphere<float, 3u>::intersects<4u>(const RayPacket4df &, std::array<float, 4u> &, uint32_t) const;
+template uint32_t Sphere<float, 3u>::intersects<8u>(const RayPacket8df &, std::array<float, 8u> &, uint32_t) const;
+template uint32_t Triangle<float, 3u>::intersects<4u>(const RayPacket4df &, std::array<float, 4u> &, uint32_t) const;
+template uint32_t Triangle<float, 3u>::intersects<8u>(const RayPacket8df &, std::array<float, 8u> &, uint32_t) const;
+template uint32_t PrecomputedTriangle<float, 3u>::intersects<4u>(const RayPacket4df &, std::array<float, 4u> &, uint32_t) const;
+template uint32_t PrecomputedTriangle<float, 3u>::intersects<8u>(const RayPacket8df &, std::array<float, 8u> &, uint32_t) const;
+
 template bool refract<float, 3u>(float refraction_index, Vector<float, 3u> normal, Vector<float, 3u> direction, Vector<float, 3> & transmission);
+
+template class ConvexPolygon<float>;
+template class ConvexDecomposition<float>;
+
+template class ConvexVertices<float>;
+
+template class SignedDistanceField<float>;
+
+template class BVH<Triangle3df>;
+template class BVH<PrecomputedTriangle3df>;
+template class BVH<Sphere3df>;
+template class BVH<AABB3df>;
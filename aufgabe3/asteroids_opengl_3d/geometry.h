@@ -3,7 +3,11 @@
 
 
 #include "math.h"
+#include "matrix.h"
+#include <cstdint>
 #include <iostream>
+#include <span>
+#include <utility>
 #include <vector>
 
 // contains geometric shapes and related stuff, like spheres, triangles, intersection algorithms.
@@ -25,6 +29,38 @@ struct Intersection_Context {
 };
 
 
+// W rays stored as a structure of arrays, e.g. the coherent primary rays of neighbouring pixels
+// the packet variants of the intersects methods test all rays at once, the float variants four rays per SSE instruction
+// bit i of a mask stands for the i-th ray of the packet
+template <class FLOAT, size_t N, size_t W>
+struct RayPacket {
+  static_assert(W > 0u && W <= 32u);
+  static constexpr uint32_t ALL = W == 32u ? ~0u : (1u << W) - 1u;
+
+  alignas(16) std::array< std::array<FLOAT, W>, N > origin,
+                                                     direction;
+
+  Ray<FLOAT, N> get(size_t i) const;
+
+  void set(size_t i, const Ray<FLOAT, N> & ray);
+};
+
+
+// a ray prepared for many slab tests (AxisAlignedBoundingBox, BVH traversal):
+// the inverse direction replaces the divisions per box by multiplications,
+// bit i of sign_bits is set iff direction[i] is negative (-0.0, too) and selects the near and far slab plane
+// a zero direction value has an infinite inverse, the slab tests handle it without NaN results
+template <class FLOAT, size_t N>
+struct PreparedRay {
+  Vector<FLOAT, N> origin,
+                   direction,
+                   inverse;
+  uint32_t sign_bits;
+
+  explicit PreparedRay(const Ray<FLOAT, N> & ray);
+};
+
+
 // calculates the refracted rays direction (transmission) for the rays direction und a surface normal
 // refraction_index is the quotient of the outside and inside material density 
 // returns true if transmission occurs
@@ -61,11 +97,26 @@ protected:
                   half_edge_length;
 public:
   AxisAlignedBoundingBox(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length);
+
+  // the smallest aabb containing the points, which must not be empty
+  explicit AxisAlignedBoundingBox(std::span<const Vector<FLOAT, N>> points);
+
   bool intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const;
 
-  // checks if this aabb is intersected by the given ray
+  // checks if this aabb is intersected by the given ray (or the line through it, t may be negative)
   bool intersects(Ray<FLOAT,N> ray) const;
 
+  // returns the interval [t_near, t_far] of the ray inside this aabb, restricted to [t_min, t_max],
+  // it is empty (t_near > t_far) iff the ray misses this aabb in that range
+  // branchless, an origin on a slab plane with a zero direction value counts as inside
+  std::pair<FLOAT, FLOAT> slab_interval(const PreparedRay<FLOAT, N> & ray, FLOAT t_min = -INFINITY, FLOAT t_max = INFINITY) const;
+
+  // returns true iff the given ray intersects this aabb in front of the ray origin
+  // context.t is set to the entry value (the exit value if the ray starts inside),
+  // context.intersection to the corresponding point and context.normal to the normal of the face
+  // that had been hit, facing away from the surface (to the inside if the ray starts inside)
+  bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
   // checks if an intersection exists with an aabb moving in the given direction
   bool intersects(AxisAlignedBoundingBox<FLOAT,N> aabb, Vector<FLOAT, N> direction) const;
   
@@ -73,6 +124,19 @@ public:
   // returns the normal (length not normalized) of the face that had been hit, or the null vector 
   // if no intersections occured
   Vector<FLOAT, N> sweep_intersects(AxisAlignedBoundingBox<FLOAT,N> aabb, Vector<FLOAT, N> direction) const;
+
+  Vector<FLOAT, N> get_center() const;
+
+  Vector<FLOAT, N> get_half_edge_length() const;
+
+  // returns this aabb, allows BVH<AxisAlignedBoundingBox>
+  AxisAlignedBoundingBox<FLOAT, N> bounding_box() const;
+
+  // packet variant, returns the mask of the active rays entering this aabb with 0 <= t <= t_max[i]
+  // unlike intersects(ray) an aabb behind the ray origin is not intersected
+  template <size_t W>
+  uint32_t intersects(const RayPacket<FLOAT, N, W> & packet, const std::array<FLOAT, W> & t_max,
+                      uint32_t active = RayPacket<FLOAT, N, W>::ALL) const;
 };
 
 // a sphere with a center and a radius
@@ -83,6 +147,14 @@ protected:
   FLOAT radius;
 public:
   Sphere(Vector<FLOAT,N> center, FLOAT radius);
+
+  // the smallest sphere containing the points, which must not be empty, in expected linear time
+  // (Welzl's algorithm in the move-to-front variant of Gaertner for a random order of the points)
+  explicit Sphere(std::span<const Vector<FLOAT, N>> points);
+
+  Vector<FLOAT, N> get_center() const;
+
+  FLOAT get_radius() const;
   
   // returns true iff this Sphere intersects with the given sphere
   bool intersects(Sphere<FLOAT, N> sphere) const;
@@ -99,13 +171,70 @@ public:
   
   // returns true iff the given point is inside this Sphere
   bool inside(const Vector<FLOAT, N> p) const;
+
+  // continuous collision detection: returns the time of impact, the smallest t >= 0 such that the given sphere
+  // moved by t * relative_velocity intersects this sphere, 0 if they intersect already and INFINITY if they never do
+  FLOAT sweep_intersects(Sphere<FLOAT, N> sphere, Vector<FLOAT, N> relative_velocity) const;
+
+  // returns the smallest aabb containing this sphere
+  AxisAlignedBoundingBox<FLOAT, N> bounding_box() const;
+
+  // packet variant of intersects(ray) for the nearest intersection of many spheres:
+  // returns the mask of the active rays i which intersect this sphere with 0 < t' < t[i], t[i] is set to t' for them
+  template <size_t W>
+  uint32_t intersects(const RayPacket<FLOAT, N, W> & packet, std::array<FLOAT, W> & t,
+                      uint32_t active = RayPacket<FLOAT, N, W>::ALL) const;
+};
+
+// a box with orthonormal axes (the columns of a rotation matrix)
+template <class FLOAT, size_t N>
+class OrientedBoundingBox {
+  Vector<FLOAT, N> center;
+  SquareMatrix<FLOAT, N> axes;
+  Vector<FLOAT, N> half_edge_length;  // along the axes
+public:
+  OrientedBoundingBox(Vector<FLOAT, N> center, SquareMatrix<FLOAT, N> axes, Vector<FLOAT, N> half_edge_length);
+
+  // the box along the principal axes of the points (the eigenvectors of their covariance matrix),
+  // which must not be empty, tight for elongated point sets but not the box of the smallest volume
+  explicit OrientedBoundingBox(std::span<const Vector<FLOAT, N>> points);
+
+  // returns true iff the point is inside this box or on its surface
+  bool inside(const Vector<FLOAT, N> & point) const;
+
+  FLOAT volume() const;
+
+  // returns the smallest aabb containing this box
+  AxisAlignedBoundingBox<FLOAT, N> bounding_box() const;
+
+  Vector<FLOAT, N> get_center() const;
+
+  const SquareMatrix<FLOAT, N> & get_axes() const;
+
+  Vector<FLOAT, N> get_half_edge_length() const;
+};
+
+// the bounding volumes of the vertices of a mesh, computed once when the mesh is loaded
+// the vertices are in model coordinates, transformations with uniform scaling scale the radius of the sphere
+template <class FLOAT>
+struct MeshBounds {
+  Sphere<FLOAT, 3u> sphere;                 // the smallest sphere
+  AxisAlignedBoundingBox<FLOAT, 3u> box;
+  OrientedBoundingBox<FLOAT, 3u> oriented;  // along the principal axes
+
+  // the points must not be empty
+  explicit MeshBounds(std::span<const Vector<FLOAT, 3u>> points);
 };
 
+template <class FLOAT, size_t N>
+class PrecomputedTriangle;
+
 template <class FLOAT, size_t N>
 class Triangle {
 protected:
   Vector<FLOAT, N> a, b, c;
   Vector<FLOAT, N> na, nb, nc;  // normal vectors for each point
+  friend class PrecomputedTriangle<FLOAT, N>;
 public:
   // creates a triangle with the given edge points a,b,c
   // the normals point away from the surface given by clockwise orientation of a,b,c
@@ -120,8 +249,11 @@ public:
   Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> na, Vector<FLOAT, N> nb, Vector<FLOAT, N> nc);
 
   // returns true if this Triangle intersects the given ray
+  // watertight: a ray through the common edge of two triangles intersects at least one of them
+  // both faces are hit, compile with -DGEOMETRY_BACKFACE_CULLING to hit only triangles whose points a, b, c
+  //   appear clockwise from the ray origin
   // if an intersection occured, than intersection is set to the intersection point
-  //   u and v are set to the barycentric coordinates of the intersection
+  //   u and v are set to the barycentric coordinates of a and b of the intersection (c: 1 - u - v)
   //   t is set to a value with intersection = ray.origin + t * ray.direction
   //   normal points away from the surface (clockwise order of a,b, and c)
   bool intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & intersection, FLOAT & u, FLOAT & v, FLOAT & t) const;
@@ -132,12 +264,343 @@ public:
   //   context.t is set to a value with intersection = ray.origin + t * ray.direction
   //   context.normal points away from the surface (clockwise order of a,b, and c)
   bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // returns the smallest aabb containing the points a, b, and c
+  AxisAlignedBoundingBox<FLOAT, N> bounding_box() const;
+
+  // returns the point of this triangle closest to the given point
+  Vector<FLOAT, N> closest_point(const Vector<FLOAT, N> & point) const;
+
+  // packet variant for the nearest intersection of many triangles, the test of PrecomputedTriangle (not watertight)
+  // with the planes computed once per packet:
+  // returns the mask of the active rays i which intersect this triangle with 0 <= t' < t[i], t[i] is set to t' for them
+  template <size_t W>
+  uint32_t intersects(const RayPacket<FLOAT, N, W> & packet, std::array<FLOAT, W> & t,
+                      uint32_t active = RayPacket<FLOAT, N, W>::ALL) const;
+};
+
+
+/*
+ a triangle prepared for many intersection tests (Havel, Herout: Yet Faster Ray-Triangle Intersection, 2010),
+ 48 bytes for float: three planes (normal, distance)
+
+   plane:    normal = (b - a) x (c - a), normal * p = distance for the points p of the triangle
+   plane_b:  (c - a) x normal / |normal|^2, plane_b * p + distance_b is the barycentric coordinate of b
+   plane_c:  normal x (b - a) / |normal|^2, plane_c * p + distance_c is the barycentric coordinate of c
+
+ a test needs three scalar products and one division, but no cross product and no square root
+ unlike Triangle it is not watertight: a ray through the common edge of two triangles may miss both
+*/
+template <class FLOAT, size_t N>
+class PrecomputedTriangle {
+  static_assert(N == 3u);
+  std::array<FLOAT, 12u> planes;  // plane, plane_b, plane_c (x, y, z, distance)
+public:
+  // creates the triangle with the given edge points a,b,c (clockwise orientation)
+  PrecomputedTriangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c);
+
+  explicit PrecomputedTriangle(const Triangle<FLOAT, N> & triangle);
+
+  // returns true if this triangle intersects the given ray, context is set like Triangle::intersects does:
+  // context.u and context.v are the barycentric coordinates of a and b,
+  // context.normal is (b - a).cross_product(c - a)
+  // degenerated triangles (with zero area) are never hit
+  bool intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // returns the smallest aabb containing the points a, b, and c (reconstructed from the planes)
+  AxisAlignedBoundingBox<FLOAT, N> bounding_box() const;
+
+  // packet variant: returns the mask of the active rays i which intersect this triangle with 0 <= t' < t[i],
+  // t[i] is set to t' for them
+  template <size_t W>
+  uint32_t intersects(const RayPacket<FLOAT, N, W> & packet, std::array<FLOAT, W> & t,
+                      uint32_t active = RayPacket<FLOAT, N, W>::ALL) const;
+
+  template <class F, size_t K, size_t WIDTH>
+  friend class TriangleBlock;
+};
+
+/*
+ WIDTH precomputed triangles stored as a structure of arrays: the i-th plane value of all triangles
+ is stored contiguously, so the float variant tests four triangles per SSE instruction against one ray
+ e.g. for the leaves of an acceleration structure
+*/
+template <class FLOAT, size_t N, size_t WIDTH>
+class TriangleBlock {
+  static_assert(N == 3u && WIDTH % 4u == 0u);
+  alignas(16) std::array< std::array<FLOAT, WIDTH>, 12u > planes;  // plane, plane_b, plane_c (x, y, z, distance)
+  size_t count;
+public:
+  // takes up to WIDTH triangles
+  explicit TriangleBlock(std::span< const PrecomputedTriangle<FLOAT, N> > triangles);
+
+  size_t size() const;
+
+  // returns the index of the triangle with the nearest intersection with t < t_max, or WIDTH if no triangle is hit
+  // context is set for that intersection like PrecomputedTriangle::intersects does
+  size_t intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context, FLOAT t_max = INFINITY) const;
+
+private:
+  // context values of the intersection with the triangle at index, which is known to be hit
+  void set_context(size_t index, const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+};
+
+
+// a convex polygon in the x/y plane for the separating axis test (SAT),
+// the normals of the edges (the axes of the test) are computed once
+template <class FLOAT>
+class ConvexPolygon {
+  std::vector< Vector<FLOAT, 2u> > points;
+  std::vector< Vector<FLOAT, 2u> > normals;  // normals[i] is perpendicular to the edge from points[i] to points[i + 1]
+  std::vector< std::pair<FLOAT, FLOAT> > extents;  // the projection of this polygon on normals[i]
+  AxisAlignedBoundingBox<FLOAT, 2u> bounds;
+public:
+  // the points have to be convex, in clockwise or counterclockwise order
+  // two points are a line segment, e.g. the movement of a torpedo during a tick
+  explicit ConvexPolygon(std::span<const Vector<FLOAT, 2u>> points);
+
+  // returns the convex hull of the given points (monotone chain), counterclockwise without collinear points
+  static ConvexPolygon convex_hull(std::span<const Vector<FLOAT, 2u>> points);
+
+  // returns true iff the given polygon moved by offset intersects (or touches) this polygon,
+  // i.e. no edge normal of both polygons separates their projections
+  bool intersects(const ConvexPolygon<FLOAT> & polygon, Vector<FLOAT, 2u> offset = {}) const;
+
+  // returns true iff the line segment from start to end intersects (or touches) this polygon,
+  // like intersects() with the polygon of both points, but without building it
+  bool intersects_segment(Vector<FLOAT, 2u> start, Vector<FLOAT, 2u> end) const;
+
+  // returns true iff the given polygon rotated around the origin by the angle of cosine and sine and moved by offset
+  // intersects this polygon, the axes are rotated instead of the points (the extents stay valid)
+  bool intersects_rotated(const ConvexPolygon<FLOAT> & polygon, FLOAT cosine, FLOAT sine, Vector<FLOAT, 2u> offset) const;
+
+  // returns this polygon rotated by angle (in radians) and scaled around the origin
+  ConvexPolygon transformed(FLOAT angle, FLOAT scale) const;
+
+  const std::vector< Vector<FLOAT, 2u> > & get_points() const;
+
+  AxisAlignedBoundingBox<FLOAT, 2u> bounding_box() const;
+};
+
+
+// a simple polygon (the outline of a game object) decomposed into few convex polygons:
+// the outline is triangulated by ear clipping and neighbouring parts are merged as long as they stay convex
+// (Hertel-Mehlhorn), it is a narrow phase test for pairs whose bounding circles collide
+template <class FLOAT>
+class ConvexDecomposition {
+  std::vector< ConvexPolygon<FLOAT> > parts;
+  AxisAlignedBoundingBox<FLOAT, 2u> bounds;  // of all parts
+public:
+  // the outline has to be simple (without self intersections), in clockwise or counterclockwise order,
+  // a closing point equal to the first one and repeated points are skipped
+  explicit ConvexDecomposition(std::span<const Vector<FLOAT, 2u>> outline);
+
+  explicit ConvexDecomposition(std::vector< ConvexPolygon<FLOAT> > parts);
+
+  // returns true iff any part of the given decomposition moved by offset intersects any part of this one
+  bool intersects(const ConvexDecomposition<FLOAT> & decomposition, Vector<FLOAT, 2u> offset = {}) const;
+
+  // returns true iff the given polygon moved by offset intersects any part of this decomposition
+  bool intersects(const ConvexPolygon<FLOAT> & polygon, Vector<FLOAT, 2u> offset = {}) const;
+
+  // returns true iff the line segment from start to end intersects any part of this decomposition
+  bool intersects_segment(Vector<FLOAT, 2u> start, Vector<FLOAT, 2u> end) const;
+
+  // returns true iff any part of the given decomposition rotated by angle (in radians) around the origin
+  // and moved by offset intersects any part of this one, like intersects(decomposition.transformed(angle, 1), offset)
+  // without allocating the rotated decomposition
+  bool intersects_rotated(const ConvexDecomposition<FLOAT> & decomposition, FLOAT angle, Vector<FLOAT, 2u> offset) const;
+
+  // returns this decomposition rotated by angle (in radians) and scaled around the origin
+  ConvexDecomposition transformed(FLOAT angle, FLOAT scale) const;
+
+  const std::vector< ConvexPolygon<FLOAT> > & get_parts() const;
+};
+
+// the simplex of the last GJK run of a pair of ConvexVertices, the next run of the pair starts with it (warm start):
+// the support points are cached as point indices and only transformed again, without evaluating support functions
+// persistent pairs, which move little per frame, mostly need a single support evaluation or none at all
+template <class FLOAT>
+struct GJKCache {
+  std::array<std::array<uint32_t, 2u>, 4u> simplex;  // the point indices of the first and the second vertex set
+  uint32_t count = 0u;
+  uint32_t iterations = 0u;  // the number of support evaluations of the last run
+};
+
+// the result of ConvexVertices::contact
+template <class FLOAT>
+struct ConvexContact {
+  bool intersecting;
+  FLOAT distance;                    // between the hulls, the penetration depth if they intersect
+  Vector<FLOAT, 3u> normal;          // unit vector from the first hull to the second one,
+                                     // moving the second one by distance * normal separates intersecting hulls
+  Vector<FLOAT, 3u> point1, point2;  // the closest (or deepest) points of both hulls
+};
+
+// the convex hull of a set of points (e.g. the vertices of a mesh imported by WavefrontImporter)
+// for the collision and distance tests of GJK (Gilbert-Johnson-Keerthi) and the penetration depth of EPA
+// (expanding polytope algorithm), the hull itself is never built, both need only the support function
+// the points are stored as a structure of arrays, the support function tests four points per SSE instruction
+// the vertex sets are placed by affine transformations without shear (rotation, uniform scaling, translation)
+template <class FLOAT>
+class ConvexVertices {
+  std::array<std::vector<FLOAT>, 3u> coordinates;  // padded to a multiple of four with copies of the first point
+  size_t count;
+  Vector<FLOAT, 3u> center;
+  FLOAT radius;  // of a sphere around center containing all points
+public:
+  static constexpr size_t MAX_ITERATIONS = 64u;  // of GJK and of EPA
+
+  // the points must not be empty
+  explicit ConvexVertices(std::span<const Vector<FLOAT, 3u>> points);
+
+  // returns the index of the point with the largest projection on direction (the first one of equal points)
+  size_t support(const Vector<FLOAT, 3u> & direction) const;
+
+  Vector<FLOAT, 3u> operator[](size_t index) const;
+
+  size_t size() const;
+
+  Vector<FLOAT, 3u> get_center() const;
+
+  FLOAT get_radius() const;
+
+  // returns true iff the hull placed by transformation intersects the hull of other placed by other_transformation,
+  // the bounding spheres are tested first, GJK stops at the first separating axis
+  // cache belongs to the pair, it is read and updated
+  bool intersects(const Affine3<FLOAT> & transformation, const ConvexVertices<FLOAT> & other,
+                  const Affine3<FLOAT> & other_transformation, GJKCache<FLOAT> & cache) const;
+
+  // returns the distance and the closest points (GJK) of separated hulls,
+  // the penetration depth and the deepest points (EPA) of intersecting ones
+  ConvexContact<FLOAT> contact(const Affine3<FLOAT> & transformation, const ConvexVertices<FLOAT> & other,
+                               const Affine3<FLOAT> & other_transformation, GJKCache<FLOAT> & cache) const;
+};
+
+// the signed distance field of a closed triangle mesh (e.g. imported by WavefrontImporter), negative inside,
+// for point and sphere queries with one trilinear lookup instead of tests against all triangles
+// the distances are sampled at the points of a grid of cubic cells around the mesh, only within the narrow band
+// around the surface: the grid is split into bricks of BRICK^3 cells, a brick farther than band from the surface
+// stores only whether it is inside or outside, the others store all of their (BRICK + 1)^3 points,
+// so the eight points of a cell are always in one brick
+// inside and outside are decided by the majority of the intersection parities along the rows of the three axes,
+// holes of a mesh which is not closed disturb only the rows through them
+template <class FLOAT>
+class SignedDistanceField {
+public:
+  static constexpr size_t BRICK = 8u;
+private:
+  static constexpr size_t BRICK_POINTS = (BRICK + 1u) * (BRICK + 1u) * (BRICK + 1u);
+  static constexpr uint32_t OUTSIDE = ~0u;
+  static constexpr uint32_t INSIDE = ~0u - 1u;
+  Vector<FLOAT, 3u> origin;                       // the first grid point
+  FLOAT cell_size = 1.0;
+  FLOAT band = 0.0;
+  std::array<uint32_t, 3u> bricks = {0u, 0u, 0u};  // per axis
+  std::vector<uint32_t> brick_table;              // the brick number in values, INSIDE or OUTSIDE
+  std::vector<FLOAT> values;
+public:
+  // an empty field, band (zero) everywhere, e.g. for load
+  SignedDistanceField() = default;
+
+  // bakes the field of the triangles with the given cell size, the bricks are computed in threads
+  // (0: the number of hardware threads), band is at least cell_size
+  SignedDistanceField(const std::vector< Triangle<FLOAT, 3u> > & triangles, FLOAT cell_size, FLOAT band,
+                      unsigned threads = 0u);
+
+  // returns the trilinear interpolation of the signed distances of the grid points around point,
+  // clamped to [-band, band]
+  FLOAT distance(const Vector<FLOAT, 3u> & point) const;
+
+  // returns true iff the sphere touches the surface or is inside, its radius must be smaller than band
+  bool intersects(const Sphere<FLOAT, 3u> & sphere) const;
+
+  FLOAT get_cell_size() const;
+
+  FLOAT get_band() const;
+
+  // returns the number of bricks with stored distances
+  size_t stored_bricks() const;
+
+  // writes the field in a binary format (native byte order), returns false if writing failed
+  bool save(std::ostream & out) const;
+
+  // reads a field written by save, returns false and keeps this field if in does not contain one
+  bool load(std::istream & in);
+};
+
+/*
+ a bounding volume hierarchy over primitives with bounding_box() and intersects(ray, context),
+ i.e. Triangle, PrecomputedTriangle, Sphere, and AxisAlignedBoundingBox
+
+ built top-down with the surface area heuristic (SAH): the primitives of a node are sorted by their
+ centroids into BINS slices per axis, the node is split at the slice border with the smallest
+ sum of (area of the bounding box * number of primitives) of both children,
+ or it becomes a leaf if that is cheaper than testing all of its primitives
+
+ the nodes are stored depth first in one array, the left child directly follows its parent,
+ the primitives are copied in leaf order, so a traversal walks forward through both arrays
+*/
+template <class PRIMITIVE>
+class BVH;
+
+template <template <class, size_t> class PRIMITIVE, class FLOAT, size_t N>
+class BVH< PRIMITIVE<FLOAT, N> > {
+public:
+  static constexpr size_t BINS = 16u;
+  static constexpr size_t MAX_LEAF_SIZE = 8u;
+  static constexpr size_t MAX_DEPTH = 64u;  // size of the traversal stack
+
+  // 32 bytes for the 3D float variant, two nodes per cache line
+  // the slab test loads the three floats of min and max, no padding is needed
+  struct Node {
+    std::array<FLOAT, N> min, max;  // bounding box of all primitives below this node
+    uint32_t index;                  // a leaf: first primitive, an inner node: the right child
+    uint16_t count;                  // number of primitives of a leaf, 0 for inner nodes
+    uint16_t axis;                   // split axis of an inner node
+  };
+
+  explicit BVH(const std::vector< PRIMITIVE<FLOAT, N> > & primitives);
+
+  // returns the primitive with the nearest intersection or nullptr if the ray misses all primitives
+  // context is set by the intersects(ray, context) of the returned primitive
+  const PRIMITIVE<FLOAT, N> * closest_hit(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const;
+
+  // returns true iff any primitive is intersected with t < t_max, e.g. for shadow rays,
+  // stops at the first intersection found
+  bool any_hit(const Ray<FLOAT, N> &ray, FLOAT t_max = INFINITY) const;
+
+  // the primitives in leaf order
+  const std::vector< PRIMITIVE<FLOAT, N> > & get_primitives() const;
+
+  const std::vector<Node> & get_nodes() const;
+
+private:
+  struct Reference {
+    std::array<FLOAT, N> min, max, centroid;
+    uint32_t primitive;
+  };
+
+  std::vector< PRIMITIVE<FLOAT, N> > primitives;
+  std::vector<Node> nodes;
+
+  // appends the node for references[begin, end) and its children
+  void build(std::vector<Reference> & references, size_t begin, size_t end, size_t depth);
+
+  // returns true iff the ray enters the box of node with 0 <= t <= t_max
+  static bool enters(const Node & node, const PreparedRay<FLOAT, N> & ray, FLOAT t_max);
 };
 
 
 typedef Ray<float, 2u> Ray2df;
 typedef Ray<float, 3u> Ray3df;
 
+typedef RayPacket<float, 3u, 4u> RayPacket4df;
+typedef RayPacket<float, 3u, 8u> RayPacket8df;
+
+typedef PreparedRay<float, 2u> PreparedRay2df;
+typedef PreparedRay<float, 3u> PreparedRay3df;
+
 typedef AxisAlignedBoundingBox<float, 2u> AABB2df;
 typedef AxisAlignedBoundingBox<float, 3u> AABB3df;
 
@@ -146,5 +609,27 @@ typedef Sphere<float, 3u> Sphere3df;
 
 typedef Triangle<float, 3u> Triangle3df;
 
+typedef OrientedBoundingBox<float, 2u> OBB2df;
+typedef OrientedBoundingBox<float, 3u> OBB3df;
+typedef MeshBounds<float> MeshBounds3df;
+
+typedef PrecomputedTriangle<float, 3u> PrecomputedTriangle3df;
+typedef TriangleBlock<float, 3u, 4u> TriangleBlock4df;
+typedef TriangleBlock<float, 3u, 8u> TriangleBlock8df;
+
+typedef ConvexPolygon<float> ConvexPolygon2df;
+typedef ConvexDecomposition<float> ConvexDecomposition2df;
+
+typedef ConvexVertices<float> ConvexVertices3df;
+typedef GJKCache<float> GJKCache3df;
+typedef ConvexContact<float> ConvexContact3df;
+
+typedef SignedDistanceField<float> SignedDistanceField3df;
+
+typedef BVH<Triangle3df> TriangleBVH3df;
+typedef BVH<PrecomputedTriangle3df> PrecomputedTriangleBVH3df;
+typedef BVH<Sphere3df> SphereBVH3df;
+typedef BVH<AABB3df> AABBBVH3df;
+
 
 #endif
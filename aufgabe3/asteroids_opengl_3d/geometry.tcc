@@ -1,9 +1,30 @@
+#include "vector_expression.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+#include <random>
+
 template <class FLOAT, size_t N>
 AxisAlignedBoundingBox<FLOAT, N>::AxisAlignedBoundingBox(Vector<FLOAT,N> center, Vector<FLOAT,N> half_edge_length)
   : center(center), half_edge_length(half_edge_length)
 {
 }
 
+template <class FLOAT, size_t N>
+AxisAlignedBoundingBox<FLOAT, N>::AxisAlignedBoundingBox(std::span<const Vector<FLOAT, N>> points) {
+  assert(!points.empty());
+  Vector<FLOAT, N> minimum = points[0], maximum = points[0];
+  for (const Vector<FLOAT, N> & point : points.subspan(1u)) {
+    for (size_t i = 0; i < N; i++) {
+      minimum[i] = std::min(minimum[i], point[i]);
+      maximum[i] = std::max(maximum[i], point[i]);
+    }
+  }
+  center = static_cast<FLOAT>(0.5) * (minimum + maximum);
+  half_edge_length = static_cast<FLOAT>(0.5) * (maximum - minimum);
+}
+
 
 template <class FLOAT, size_t N>
 bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N> aabb) const {
@@ -17,18 +38,8 @@ bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N
 
 template <class FLOAT, size_t N>
 bool AxisAlignedBoundingBox<FLOAT, N>::intersects(Ray<FLOAT,N> ray) const {
-    FLOAT tmin;
-    FLOAT tmax;
-    FLOAT tminimum = -INFINITY;
-    FLOAT tmaximum = INFINITY;
-    
-    for (size_t i = 0; i < N; i++) {
-      tmin = (center[i] - ray.origin[i] - half_edge_length[i]) / ray.direction[i];
-      tmax = (center[i] - ray.origin[i] + half_edge_length[i]) / ray.direction[i];
-      tminimum = std::max(tminimum, std::min(tmin, tmax) );
-      tmaximum = std::min(tmaximum, std::max(tmin, tmax) );      
-    }
-    return tmaximum >= tminimum;
+  auto [t_near, t_far] = slab_interval(PreparedRay<FLOAT, N>(ray));
+  return t_far >= t_near;
 }
 
 
@@ -42,29 +53,74 @@ bool AxisAlignedBoundingBox<FLOAT, N>::intersects(AxisAlignedBoundingBox<FLOAT,N
 template <class FLOAT, size_t N>
 Vector<FLOAT, N> AxisAlignedBoundingBox<FLOAT, N>::sweep_intersects(AxisAlignedBoundingBox<FLOAT,N> aabb, Vector<FLOAT, N> direction) const {
     Vector<FLOAT, N> normal = {0.0, };
-    FLOAT tmin[N];
-    FLOAT tmax[N];
-    
-    for (size_t i = 0; i < N; i++) {
-      tmin[i] = (center[i] - aabb.center[i] - (half_edge_length[i] + aabb.half_edge_length[i])) / direction[i];
-      tmax[i] = (center[i] - aabb.center[i] + (half_edge_length[i] + aabb.half_edge_length[i])) / direction[i];
-    }
-    FLOAT tminimum = -INFINITY;
-    FLOAT tmaximum = INFINITY;
-    for (size_t i = 0; i < N; i++) { 
-      tminimum = std::max(tminimum, std::min(tmin[i], tmax[i]) );
-      tmaximum = std::min(tmaximum, std::max(tmin[i], tmax[i]) );
-    }
-
-    
-    if (tmaximum >= tminimum) {    
-      for (size_t i = 0; i < N; i++) {         
-        normal[i] = - ( (tminimum == tmin[i]) | (tminimum == tmax[i]) ) * direction[i];
+    Vector<FLOAT, N> extended = half_edge_length + aabb.half_edge_length;
+    PreparedRay<FLOAT, N> ray(Ray<FLOAT, N>{ aabb.center, direction });
+    auto [tminimum, tmaximum] = AxisAlignedBoundingBox<FLOAT, N>(center, extended).slab_interval(ray);
+
+    if (tmaximum >= tminimum) {
+      for (size_t i = 0; i < N; i++) {
+        bool negative = (ray.sign_bits >> i) & 1u;
+        FLOAT tmin = (center[i] + (negative ? extended[i] : -extended[i]) - aabb.center[i]) * ray.inverse[i];
+        FLOAT tmax = (center[i] + (negative ? -extended[i] : extended[i]) - aabb.center[i]) * ray.inverse[i];
+        normal[i] = - ( (tminimum == tmin) | (tminimum == tmax) ) * direction[i];
       }
     }
     return normal;
 }
 
+template <class FLOAT, size_t N>
+bool AxisAlignedBoundingBox<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  FLOAT t_near = -INFINITY;
+  FLOAT t_far = INFINITY;
+  size_t near_axis = 0u;
+  size_t far_axis = 0u;
+
+  for (size_t i = 0; i < N; i++) {
+    FLOAT t0 = (center[i] - half_edge_length[i] - ray.origin[i]) / ray.direction[i];
+    FLOAT t1 = (center[i] + half_edge_length[i] - ray.origin[i]) / ray.direction[i];
+    if (t0 > t1) {
+      std::swap(t0, t1);
+    }
+    if (t0 > t_near) {
+      t_near = t0;
+      near_axis = i;
+    }
+    if (t1 < t_far) {
+      t_far = t1;
+      far_axis = i;
+    }
+  }
+  if (t_near > t_far || t_far <= 0.0) {
+    return false;
+  }
+
+  bool inside = t_near <= 0.0;
+  size_t axis = inside ? far_axis : near_axis;
+  context.t = inside ? t_far : t_near;
+  context.u = 0.0;
+  context.v = 0.0;
+  context.intersection = ray.origin + context.t * ray.direction;
+  context.normal = Vector<FLOAT, N>{};
+  // the entry face faces against the ray, from inside the normal of the exit face points to the inside
+  context.normal[axis] = ray.direction[axis] < 0.0 ? 1.0 : -1.0;
+  return true;
+}
+
+template <class FLOAT, size_t N>
+Vector<FLOAT, N> AxisAlignedBoundingBox<FLOAT, N>::get_center() const {
+  return center;
+}
+
+template <class FLOAT, size_t N>
+Vector<FLOAT, N> AxisAlignedBoundingBox<FLOAT, N>::get_half_edge_length() const {
+  return half_edge_length;
+}
+
+template <class FLOAT, size_t N>
+AxisAlignedBoundingBox<FLOAT, N> AxisAlignedBoundingBox<FLOAT, N>::bounding_box() const {
+  return *this;
+}
+
 template <class FLOAT, size_t N>
 Sphere<FLOAT,N>::Sphere(Vector<FLOAT,N> center, FLOAT radius)
  : center(center), radius(radius)
@@ -81,6 +137,28 @@ bool Sphere<FLOAT,N>::inside(const Vector<FLOAT, N> p) const {
   return  (p - center) * (p - center) <= radius * radius;
 }
 
+// solution of ( (sphere.center - center) + t relative_velocity )^2 = (radius + sphere.radius)^2,
+// the smaller root (-b - sqrt(d)) / a is computed as c / (-b + sqrt(d)) without cancellation
+template <class FLOAT, size_t N>
+FLOAT Sphere<FLOAT,N>::sweep_intersects(Sphere<FLOAT, N> sphere, Vector<FLOAT, N> relative_velocity) const {
+  Vector<FLOAT, N> distance = sphere.center - center;
+  FLOAT r = radius + sphere.radius,
+        c = distance * distance - r * r;
+  if (c <= 0.0) {
+    return 0.0;
+  }
+  FLOAT b = distance * relative_velocity;
+  if (b >= 0.0) {
+    return INFINITY; // the spheres rest or move apart
+  }
+  FLOAT a = relative_velocity * relative_velocity,
+        d = b * b - a * c;
+  if (d < 0.0) {
+    return INFINITY;
+  }
+  return c / (-b + std::sqrt(d));
+}
+
 // solution via
 // (g(t) - center )^2  = ( (ray.origin - center) + t ray.direction)^2 = r^2 
 // and abc-formula
@@ -118,280 +196,2491 @@ bool Sphere<FLOAT,N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<
 }
 
 template <class FLOAT, size_t N>
-Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> na, Vector<FLOAT, N> nb, Vector<FLOAT, N> nc)
- : a(a), b(b), c(c), na(na), nb(nb), nc(nc) { }
+AxisAlignedBoundingBox<FLOAT, N> Sphere<FLOAT,N>::bounding_box() const {
+  Vector<FLOAT, N> half_edge_length;
+  for (size_t i = 0; i < N; i++) {
+    half_edge_length[i] = radius;
+  }
+  return AxisAlignedBoundingBox<FLOAT, N>(center, half_edge_length);
+}
 
+namespace welzl {
 
+// the ball through the support points, center * center - radius * radius is not needed
 template <class FLOAT, size_t N>
-Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> normal)
- : Triangle<FLOAT, N>::Triangle(a, b, c, normal, normal, normal) { }
+struct Ball {
+  Vector<FLOAT, N> center;
+  FLOAT square_radius;
+};
+
+// the smallest ball with the count support points on its surface, its center lies in their affine hull
+// and solves the gram system 2 (v_j * v_l) lambda_l = v_j * v_j for v_j = support[j + 1] - support[0],
+// returns false if the support points are affinely dependent
+template <class FLOAT, size_t N>
+bool circumsphere(const std::array<Vector<FLOAT, N>, N + 1u> & support, size_t count, Ball<FLOAT, N> & ball) {
+  std::array<Vector<FLOAT, N>, N> v;
+  std::array<std::array<FLOAT, N + 1u>, N> a;
+  size_t k = count - 1u;
+  FLOAT scale = 0.0;
+  for (size_t j = 0; j < k; j++) {
+    v[j] = support[j + 1u] - support[0];
+  }
+  for (size_t j = 0; j < k; j++) {
+    for (size_t l = 0; l < k; l++) {
+      a[j][l] = static_cast<FLOAT>(2.0) * (v[j] * v[l]);
+    }
+    a[j][k] = v[j] * v[j];
+    scale = std::max(scale, a[j][j]);
+  }
+  for (size_t j = 0; j < k; j++) {
+    size_t pivot = j;
+    for (size_t l = j + 1u; l < k; l++) {
+      if (std::abs(a[l][j]) > std::abs(a[pivot][j])) {
+        pivot = l;
+      }
+    }
+    if (std::abs(a[pivot][j]) <= static_cast<FLOAT>(100.0) * std::numeric_limits<FLOAT>::epsilon() * scale) {
+      return false;
+    }
+    std::swap(a[j], a[pivot]);
+    for (size_t l = j + 1u; l < k; l++) {
+      FLOAT factor = a[l][j] / a[j][j];
+      for (size_t m = j; m <= k; m++) {
+        a[l][m] -= factor * a[j][m];
+      }
+    }
+  }
+  ball.center = support[0];
+  for (size_t j = k; j-- > 0; ) {
+    FLOAT lambda = a[j][k];
+    for (size_t l = j + 1u; l < k; l++) {
+      lambda -= a[j][l] * a[l][k];
+    }
+    a[j][k] = lambda / a[j][j];
+    ball.center += a[j][k] * v[j];
+  }
+  ball.square_radius = (ball.center - support[0]).square_of_length();
+  return true;
+}
 
+// the relative tolerance absorbs the rounding errors of the circumsphere of points on the surface
 template <class FLOAT, size_t N>
-Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c)
-  :  Triangle<FLOAT, N>::Triangle(a, b, c, (c - a).cross_product(b - a) ) { }
+bool outside(const Ball<FLOAT, N> & ball, const Vector<FLOAT, N> & point) {
+  constexpr FLOAT tolerance = static_cast<FLOAT>(64.0) * std::numeric_limits<FLOAT>::epsilon();
+  return (point - ball.center).square_of_length() > ball.square_radius * (static_cast<FLOAT>(1.0) + tolerance);
+}
 
-  
+// the smallest ball of the first end points in order with the count support points on its surface,
+// points outside of the ball are moved to the front of order (Gaertner's move-to-front heuristic),
+// affinely dependent support points are skipped and only cost tightness, the caller grows the ball to contain them
 template <class FLOAT, size_t N>
-bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
-  return intersects(ray, context.normal, context.intersection, context.u, context.v, context.t);
+void move_to_front(std::span<const Vector<FLOAT, N>> points, std::vector<uint32_t> & order, size_t end,
+                   std::array<Vector<FLOAT, N>, N + 1u> & support, size_t count, Ball<FLOAT, N> & ball) {
+  if (count == N + 1u) {
+    return;
+  }
+  for (size_t i = 0; i < end; i++) {
+    const Vector<FLOAT, N> & point = points[order[i]];
+    if (!outside(ball, point)) {
+      continue;
+    }
+    support[count] = point;
+    if (!circumsphere(support, count + 1u, ball)) {
+      continue;
+    }
+    move_to_front(points, order, i, support, count + 1u, ball);
+    std::rotate(order.begin(), order.begin() + i, order.begin() + i + 1u);
+  }
 }
 
+} // namespace welzl
 
 template <class FLOAT, size_t N>
-bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & p, FLOAT & u, FLOAT & v, FLOAT & t) const {
-    const FLOAT EPSILON = 10e-7;
-    normal =  (b-a).cross_product(c-a);  // points away from triangle surface (clockwise order)
+Sphere<FLOAT,N>::Sphere(std::span<const Vector<FLOAT, N>> points) {
+  assert(!points.empty());
+  std::vector<uint32_t> order(points.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::mt19937 generator(static_cast<uint32_t>(points.size()));  // a fixed seed keeps the result reproducible
+  std::shuffle(order.begin(), order.end(), generator);
+
+  std::array<Vector<FLOAT, N>, N + 1u> support;
+  welzl::Ball<FLOAT, N> ball{Vector<FLOAT, N>{}, static_cast<FLOAT>(-1.0)};  // empty, every point is outside
+  welzl::move_to_front(points, order, order.size(), support, 0u, ball);
+
+  FLOAT square_radius = 0.0;
+  for (const Vector<FLOAT, N> & point : points) {
+    square_radius = std::max(square_radius, (point - ball.center).square_of_length());
+  }
+  center = ball.center;
+  radius = std::sqrt(square_radius) * (static_cast<FLOAT>(1.0) + std::numeric_limits<FLOAT>::epsilon());
+}
 
-    FLOAT normalRayProduct =  normal * ray.direction;
-    FLOAT area = normal.length(); // used for u-v-parameter calculation
+template <class FLOAT, size_t N>
+Vector<FLOAT, N> Sphere<FLOAT,N>::get_center() const {
+  return center;
+}
+
+template <class FLOAT, size_t N>
+FLOAT Sphere<FLOAT,N>::get_radius() const {
+  return radius;
+}
 
+namespace pca {
 
-    if ( fabs(normalRayProduct) < EPSILON ) { // backface culling off
-      return false;
+// the eigenvectors (columns) of a symmetric matrix by cyclic Jacobi rotations
+template <class FLOAT, size_t N>
+SquareMatrix<FLOAT, N> eigenvectors(SquareMatrix<FLOAT, N> a) {
+  SquareMatrix<FLOAT, N> v;
+  for (size_t i = 0; i < N; i++) {
+    v.at(i, i) = 1.0;
+  }
+  for (size_t sweep = 0; sweep < 32u; sweep++) {
+    FLOAT off = 0.0, diagonal = 0.0;
+    for (size_t p = 0; p < N; p++) {
+      diagonal += a.at(p, p) * a.at(p, p);
+      for (size_t q = p + 1u; q < N; q++) {
+        off += a.at(p, q) * a.at(p, q);
+      }
+    }
+    if (off <= std::numeric_limits<FLOAT>::epsilon() * std::numeric_limits<FLOAT>::epsilon() * diagonal) {
+      break;
+    }
+    for (size_t p = 0; p < N; p++) {
+      for (size_t q = p + 1u; q < N; q++) {
+        if (a.at(p, q) == 0.0) {
+          continue;
+        }
+        // the rotation by the angle phi with tan(2 phi) = 2 a_pq / (a_qq - a_pp) zeroes a_pq
+        FLOAT theta = (a.at(q, q) - a.at(p, p)) / (static_cast<FLOAT>(2.0) * a.at(p, q)),
+              t = std::copysign(static_cast<FLOAT>(1.0), theta) / (std::abs(theta) + std::sqrt(theta * theta + static_cast<FLOAT>(1.0))),
+              c = static_cast<FLOAT>(1.0) / std::sqrt(t * t + static_cast<FLOAT>(1.0)),
+              s = t * c;
+        for (size_t k = 0; k < N; k++) {
+          FLOAT akp = a.at(k, p), akq = a.at(k, q);
+          a.at(k, p) = c * akp - s * akq;
+          a.at(k, q) = s * akp + c * akq;
+        }
+        for (size_t k = 0; k < N; k++) {
+          FLOAT apk = a.at(p, k), aqk = a.at(q, k);
+          a.at(p, k) = c * apk - s * aqk;
+          a.at(q, k) = s * apk + c * aqk;
+        }
+        for (size_t k = 0; k < N; k++) {
+          FLOAT vkp = v.at(k, p), vkq = v.at(k, q);
+          v.at(k, p) = c * vkp - s * vkq;
+          v.at(k, q) = s * vkp + c * vkq;
+        }
+      }
     }
+  }
+  return v;
+}
 
-    FLOAT d = normal * a;
-    t = (d - normal * ray.origin) / normalRayProduct;
+} // namespace pca
 
-    if ( t < 0.0 ) {
-      return false;
+template <class FLOAT, size_t N>
+OrientedBoundingBox<FLOAT, N>::OrientedBoundingBox(Vector<FLOAT, N> center, SquareMatrix<FLOAT, N> axes, Vector<FLOAT, N> half_edge_length)
+  : center(center), axes(axes), half_edge_length(half_edge_length)
+{
+}
+
+template <class FLOAT, size_t N>
+OrientedBoundingBox<FLOAT, N>::OrientedBoundingBox(std::span<const Vector<FLOAT, N>> points) {
+  assert(!points.empty());
+  Vector<FLOAT, N> mean;
+  for (const Vector<FLOAT, N> & point : points) {
+    mean += point;
+  }
+  mean = (static_cast<FLOAT>(1.0) / static_cast<FLOAT>(points.size())) * mean;
+
+  SquareMatrix<FLOAT, N> covariance;
+  for (const Vector<FLOAT, N> & point : points) {
+    Vector<FLOAT, N> d = point - mean;
+    for (size_t i = 0; i < N; i++) {
+      for (size_t j = i; j < N; j++) {
+        covariance.at(i, j) += d[i] * d[j];
+      }
     }
-   
-    p = ray.origin + t * ray.direction;
-   
-    Vector<FLOAT, N> vector = (b - a).cross_product(p - a );
-    if ( normal * vector < 0.0 ) { 
-      return false;
+  }
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = 0; j < i; j++) {
+      covariance.at(i, j) = covariance.at(j, i);
     }
+  }
+  axes = pca::eigenvectors(covariance);
+  if (axes.determinant() < 0.0) {
+    axes[N - 1u] = static_cast<FLOAT>(-1.0) * axes[N - 1u];  // a rotation without reflection
+  }
 
-    
-    vector = (c - b).cross_product(p - b );
-    if ( normal * vector < 0.0 ) { 
-      return false;
+  Vector<FLOAT, N> minimum, maximum;
+  for (size_t i = 0; i < N; i++) {
+    minimum[i] = std::numeric_limits<FLOAT>::max();
+    maximum[i] = std::numeric_limits<FLOAT>::lowest();
+  }
+  for (const Vector<FLOAT, N> & point : points) {
+    Vector<FLOAT, N> local = axes.transpose() * (point - mean);
+    for (size_t i = 0; i < N; i++) {
+      minimum[i] = std::min(minimum[i], local[i]);
+      maximum[i] = std::max(maximum[i], local[i]);
     }
+  }
+  center = mean + axes * (static_cast<FLOAT>(0.5) * (minimum + maximum));
+  half_edge_length = static_cast<FLOAT>(0.5) * (maximum - minimum);
+}
 
-    u = vector.length()  / area;
+template <class FLOAT, size_t N>
+bool OrientedBoundingBox<FLOAT, N>::inside(const Vector<FLOAT, N> & point) const {
+  Vector<FLOAT, N> local = axes.transpose() * (point - center);
+  bool inside = true;
+  for (size_t i = 0; i < N; i++) {
+    inside &= std::abs(local[i]) <= half_edge_length[i];
+  }
+  return inside;
+}
 
-    vector = (a-c).cross_product(p - c );
-    if (normal * vector < 0.0 ) {
-      return false;
+template <class FLOAT, size_t N>
+FLOAT OrientedBoundingBox<FLOAT, N>::volume() const {
+  FLOAT volume = 1.0;
+  for (size_t i = 0; i < N; i++) {
+    volume *= static_cast<FLOAT>(2.0) * half_edge_length[i];
+  }
+  return volume;
+}
+
+// the half edge length of the aabb along axis i is the sum of |axes(i, j)| * half_edge_length[j]
+template <class FLOAT, size_t N>
+AxisAlignedBoundingBox<FLOAT, N> OrientedBoundingBox<FLOAT, N>::bounding_box() const {
+  Vector<FLOAT, N> extent;
+  for (size_t i = 0; i < N; i++) {
+    for (size_t j = 0; j < N; j++) {
+      extent[i] += std::abs(axes.at(i, j)) * half_edge_length[j];
     }
+  }
+  return AxisAlignedBoundingBox<FLOAT, N>(center, extent);
+}
 
-    v = vector.length() / area;
+template <class FLOAT, size_t N>
+Vector<FLOAT, N> OrientedBoundingBox<FLOAT, N>::get_center() const {
+  return center;
+}
 
-    return true;
+template <class FLOAT, size_t N>
+const SquareMatrix<FLOAT, N> & OrientedBoundingBox<FLOAT, N>::get_axes() const {
+  return axes;
 }
 
+template <class FLOAT, size_t N>
+Vector<FLOAT, N> OrientedBoundingBox<FLOAT, N>::get_half_edge_length() const {
+  return half_edge_length;
+}
 
+template <class FLOAT>
+MeshBounds<FLOAT>::MeshBounds(std::span<const Vector<FLOAT, 3u>> points)
+  : sphere(points), box(points), oriented(points)
+{
+}
 
-/*    
 template <class FLOAT, size_t N>
-bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & p, FLOAT & u, FLOAT & v, FLOAT & t) const {
-  const FLOAT EPSILON = 10e-7;
-  Vector<FLOAT, N> ca = a - c;
-  Vector<FLOAT, N> cb = b - c;
-  normal = ca.cross_product(cb);
+Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> na, Vector<FLOAT, N> nb, Vector<FLOAT, N> nc)
+ : a(a), b(b), c(c), na(na), nb(nb), nc(nc) { }
+
+
+template <class FLOAT, size_t N>
+Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c, Vector<FLOAT, N> normal)
+ : Triangle<FLOAT, N>::Triangle(a, b, c, normal, normal, normal) { }
+
+template <class FLOAT, size_t N>
+Triangle<FLOAT, N>::Triangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c)
+  :  Triangle<FLOAT, N>::Triangle(a, b, c, (c - a).cross_product(b - a) ) { }
 
-  FLOAT d = normal * a;
-  FLOAT normal_direction = normal * ray.direction;
   
-//  std::cerr << "normal_direction = " << normal_direction << std::endl;
+template <class FLOAT, size_t N>
+bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  return intersects(ray, context.normal, context.intersection, context.u, context.v, context.t);
+}
 
-  if ( 
-    //normal_direction > -EPSILON && // backface culling off 
-    normal_direction < EPSILON
-    ) { 
-    return false;
+template <class FLOAT, size_t N>
+AxisAlignedBoundingBox<FLOAT, N> Triangle<FLOAT, N>::bounding_box() const {
+  Vector<FLOAT, N> center, half_edge_length;
+  for (size_t i = 0; i < N; i++) {
+    FLOAT min = std::min({a[i], b[i], c[i]});
+    FLOAT max = std::max({a[i], b[i], c[i]});
+    center[i] = 0.5 * (min + max);
+    half_edge_length[i] = 0.5 * (max - min);
   }
-  
-  t = (d - normal * ray.origin) / normal_direction;
+  return AxisAlignedBoundingBox<FLOAT, N>(center, half_edge_length);
+}
+
+// the Voronoi regions of the points, edges and the face (Ericson, Real-Time Collision Detection, 5.1.5)
+template <class FLOAT, size_t N>
+Vector<FLOAT, N> Triangle<FLOAT, N>::closest_point(const Vector<FLOAT, N> & point) const {
+  // the point of the edge from p to q for the parameter numerator / denominator, p for a degenerated edge
+  auto on_edge = [](const Vector<FLOAT, N> & p, const Vector<FLOAT, N> & q, FLOAT numerator, FLOAT denominator) {
+    return denominator > 0.0 ? p + (numerator / denominator) * (q - p) : p;
+  };
+  Vector<FLOAT, N> ab = b - a;
+  Vector<FLOAT, N> ac = c - a;
+  FLOAT d1 = ab * (point - a);
+  FLOAT d2 = ac * (point - a);
+  if (d1 <= 0.0 && d2 <= 0.0) {
+    return a;
+  }
+  FLOAT d3 = ab * (point - b);
+  FLOAT d4 = ac * (point - b);
+  if (d3 >= 0.0 && d4 <= d3) {
+    return b;
+  }
+  FLOAT vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+    return on_edge(a, b, d1, d1 - d3);
+  }
+  FLOAT d5 = ab * (point - c);
+  FLOAT d6 = ac * (point - c);
+  if (d6 >= 0.0 && d5 <= d6) {
+    return c;
+  }
+  FLOAT vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+    return on_edge(a, c, d2, d2 - d6);
+  }
+  FLOAT va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0) {
+    return on_edge(b, c, d4 - d3, (d4 - d3) + (d5 - d6));
+  }
+  FLOAT denominator = va + vb + vc;
+  if (!(denominator > 0.0)) {
+    return a;  // all points are equal
+  }
+  return a + (vb / denominator) * ab + (vc / denominator) * ac;
+}
 
-  //std::cerr << "t = " << t << std::endl;
 
-  if (t < 0.0) {  
-    return false;
+// watertight ray/triangle intersection (Woop, Benthin, Wald: Watertight Ray/Triangle Intersection, 2013)
+// the points are transformed into a ray space, in which the ray starts at the origin and runs along the z axis,
+// the signs of the 2D edge functions U, V, W decide inside or outside consistently for neighbouring triangles:
+// a ray through a common edge or point hits at least one of them
+template <class FLOAT, size_t N>
+bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & p, FLOAT & u, FLOAT & v, FLOAT & t) const {
+  static_assert(N == 3u);
+
+  // kz is the dimension with the largest absolute direction value,
+  // kx and ky are swapped for a negative direction to keep the winding order of the points
+  size_t kz = 0u;
+  for (size_t i = 1u; i < 3u; i++) {
+    if (std::fabs(ray.direction[i]) > std::fabs(ray.direction[kz])) {
+      kz = i;
+    }
   }
-  
-  p = ray.origin + t * ray.direction;
-  
-  Vector<FLOAT, N> cp = p - c;
-
-  size_t c1 = 0,
-         c2 = 1;
-  FLOAT d_inv = (ca[0] * cb[1] - ca[1] * cb[0]);
-
-  if ( fabs(d_inv) > EPSILON ) {
-    c1 = 0;
-    c2 = 1;
-  } else if (fabs(d_inv = (ca[0] * cb[2] - ca[2] * cb[0])) > EPSILON ) {
-    c1 = 0;
-    c2 = 2;
-  } else if (fabs(d_inv = (ca[1] * cb[2] - ca[2] * cb[1])) > EPSILON ) {
-    c1 = 1;
-    c2 = 2;
-  } else {
-    std::cerr << "degenerated case of triangle" << std::endl;
+  size_t kx = kz == 2u ? 0u : kz + 1u;
+  size_t ky = kx == 2u ? 0u : kx + 1u;
+  if (ray.direction[kz] < 0.0) {
+    std::swap(kx, ky);
   }
-  
-  d_inv = 1.0 / d_inv;
-    
-  u = d_inv * (cp[c1] * cb[c2] - cp[c2] * cb[c1]);
 
-  //std::cerr << "u = " << u << std::endl;
+  // shear, so that the ray direction becomes (0, 0, 1)
+  FLOAT sz = static_cast<FLOAT>(1.0) / ray.direction[kz];
+  FLOAT sx = ray.direction[kx] * sz;
+  FLOAT sy = ray.direction[ky] * sz;
+
+  Vector<FLOAT, N> oa = a - ray.origin;
+  Vector<FLOAT, N> ob = b - ray.origin;
+  Vector<FLOAT, N> oc = c - ray.origin;
+  FLOAT ax = oa[kx] - sx * oa[kz], ay = oa[ky] - sy * oa[kz];
+  FLOAT bx = ob[kx] - sx * ob[kz], by = ob[ky] - sy * ob[kz];
+  FLOAT cx = oc[kx] - sx * oc[kz], cy = oc[ky] - sy * oc[kz];
+
+  // twice the areas of the triangles (ray, b, c), (ray, c, a), and (ray, a, b) in the x/y plane
+  FLOAT edge_u = cx * by - cy * bx;
+  FLOAT edge_v = ax * cy - ay * cx;
+  FLOAT edge_w = bx * ay - by * ax;
+
+  // a ray through an edge: the sign of the zero is recomputed with double precision
+  if (edge_u == 0.0 || edge_v == 0.0 || edge_w == 0.0) {
+    edge_u = static_cast<FLOAT>(static_cast<double>(cx) * by - static_cast<double>(cy) * bx);
+    edge_v = static_cast<FLOAT>(static_cast<double>(ax) * cy - static_cast<double>(ay) * cx);
+    edge_w = static_cast<FLOAT>(static_cast<double>(bx) * ay - static_cast<double>(by) * ax);
+  }
 
-  if ( (u < 0.0) || (u > 1.0) ) {
+#ifdef GEOMETRY_BACKFACE_CULLING
+  // inside iff no edge function is positive, i.e. a, b, and c appear clockwise from the ray origin
+  if ((edge_u > 0.0) | (edge_v > 0.0) | (edge_w > 0.0)) {
     return false;
   }
+#else
+  // inside iff all edge functions have the same sign
+  if (((edge_u < 0.0) | (edge_v < 0.0) | (edge_w < 0.0)) & ((edge_u > 0.0) | (edge_v > 0.0) | (edge_w > 0.0))) {
+    return false;
+  }
+#endif
 
-  v = d_inv * (ca[c1] * cp[c2] - ca[c2] * cp[c1]);
-
-  //std::cerr << "v = " << v << std::endl;
+  FLOAT determinant = edge_u + edge_v + edge_w;
+  if (determinant == 0.0) {  // the ray is parallel to the triangle
+    return false;
+  }
 
-  if ( (v < 0.0) || ((u + v) > 1.0) ) {
+  // t * determinant, the sign of t is checked before the division
+  FLOAT scaled_t = sz * (edge_u * oa[kz] + edge_v * ob[kz] + edge_w * oc[kz]);
+  if ((determinant < 0.0) ? (scaled_t > 0.0) : (scaled_t < 0.0)) {
     return false;
   }
-    
-  return t > 0.0;
+
+  FLOAT inverse = static_cast<FLOAT>(1.0) / determinant;
+  u = edge_u * inverse;  // barycentric coordinate of a
+  v = edge_v * inverse;  // barycentric coordinate of b
+  t = scaled_t * inverse;
+  p = ray.origin + t * ray.direction;
+  normal = (b - a).cross_product(c - a);  // points away from triangle surface (clockwise order)
+  return true;
 }
-*/
 
 
-// Möller-Trumbore, still BUGGY
-/*
 template <class FLOAT, size_t N>
-bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & p, FLOAT & u, FLOAT & v, FLOAT & t) const {
-  const FLOAT EPSILON = 10e-7;
-  Vector<FLOAT, N> ca = a - c;
-  Vector<FLOAT, N> cb = b - c;
+bool refract(FLOAT refraction_index, Vector<FLOAT, N> normal, Vector<FLOAT, N> direction, Vector<FLOAT, N> & transmission) {
+   FLOAT cos_theta = expr::lazy(direction) * expr::lazy(normal); // both vectors need to be normalized
+   FLOAT sin_phi_squared = refraction_index * refraction_index * (static_cast<FLOAT>(1.0) - cos_theta * cos_theta);
+     
+   if ( sin_phi_squared > static_cast<FLOAT>(1.0f) ) {
+     return false; // total internal reflection
+   }
+   FLOAT cos_phi = sqrt( static_cast<FLOAT>(1.0f) - sin_phi_squared );
+   // expression templates: evaluated in one pass without temporary Vectors
+   transmission = refraction_index * (expr::lazy(direction) - cos_theta * expr::lazy(normal)) - cos_phi * expr::lazy(normal);
+   
+   return true;
+}
 
-  normal = ray.direction.cross_product( cb );
 
-  
-//  std::cerr << "ca = ( " << ca[0] << ", " << ca[1] << ", " << ca[2] << ") " << std::endl; 
-//  std::cerr << "cb = ( " << cb[0] << ", " << cb[1] << ", " << cb[2] << ") " << std::endl; 
-//  std::cerr << "normal = ( " << normal[0] << ", " << normal[1] << ", " << normal[2] << ") " << std::endl; 
-  FLOAT det = normal * ca; 
 
-//  std::cout << "det = " << det << std::endl;
+namespace triangle {
 
-  if ( 
-      // det > -EPSILON &&  // backface culling off
-      fabs(det) < EPSILON) { 
-    std::cerr << "|det| < epsilon" << std::endl;
+// the intersection test of PrecomputedTriangle with the 12 plane values planes[0], planes[stride], ...
+// the SSE variant of TriangleBlock computes the same operations in the same order
+template <class FLOAT, size_t N>
+bool intersects(const FLOAT * planes, size_t stride, const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) {
+  auto value = [planes, stride](size_t i) { return planes[i * stride]; };
+  const Vector<FLOAT, N> & o = ray.origin;
+  const Vector<FLOAT, N> & d = ray.direction;
+
+  FLOAT determinant = value(0) * d[0] + value(1) * d[1] + value(2) * d[2];
+  FLOAT scaled_t = value(3) - (value(0) * o[0] + value(1) * o[1] + value(2) * o[2]);
+  // the intersection point scaled by the determinant
+  FLOAT px = determinant * o[0] + scaled_t * d[0];
+  FLOAT py = determinant * o[1] + scaled_t * d[1];
+  FLOAT pz = determinant * o[2] + scaled_t * d[2];
+  FLOAT scaled_b = value(4) * px + value(5) * py + value(6) * pz + determinant * value(7);
+  FLOAT scaled_c = value(8) * px + value(9) * py + value(10) * pz + determinant * value(11);
+  FLOAT scaled_a = determinant - scaled_b - scaled_c;
+
+  // t and the barycentric coordinates are not negative iff their scaled values have the sign of the determinant
+  if (!((determinant != 0.0) & (scaled_t * determinant >= 0.0) & (scaled_a * determinant >= 0.0)
+        & (scaled_b * determinant >= 0.0) & (scaled_c * determinant >= 0.0))) {
     return false;
   }
+  FLOAT inverse = static_cast<FLOAT>(1.0) / determinant;
+  context.t = scaled_t * inverse;
+  context.u = scaled_a * inverse;
+  context.v = scaled_b * inverse;
+  context.intersection = ray.origin + context.t * ray.direction;
+  context.normal = Vector<FLOAT, N>{value(0), value(1), value(2)};
+  return true;
+}
 
-  det = 1.0 / det;  
-
-  Vector<FLOAT, N> co = ray.origin - c;
-  std::cerr << "co = ( " << co[0] << ", " << co[1] << ", " << co[2] << ") " << std::endl; 
-  
-  
-  u = (normal * co) * det;
+}
 
-  std::cerr << "u = " << u << std::endl;
-  
-  if ( (u < 0.0) || (u > 1.0) ) {
-    return false;
+template <class FLOAT, size_t N>
+PrecomputedTriangle<FLOAT, N>::PrecomputedTriangle(Vector<FLOAT, N> a, Vector<FLOAT, N> b, Vector<FLOAT, N> c) {
+  planes.fill(0.0);
+  Vector<FLOAT, N> ab = b - a;
+  Vector<FLOAT, N> ac = c - a;
+  Vector<FLOAT, 3u> normal = ab.cross_product(ac);
+  FLOAT area_squared = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+  if (area_squared == 0.0) {
+    return; // the determinant is always zero
   }
-  
-  Vector<FLOAT, N> f = co.cross_product(ca);
-  v = (ray.direction * f) * det;
-
-  std::cerr << "v = " << v << std::endl;
-  
-  if ( (v < 0.0) || ((u + v) > 1.0) ) {
-    return false;
+  Vector<FLOAT, 3u> normal_b = ac.cross_product(normal);
+  Vector<FLOAT, 3u> normal_c = normal.cross_product(ab);
+  for (size_t i = 0; i < 3u; i++) {
+    planes[i] = normal[i];
+    planes[4u + i] = normal_b[i] / area_squared;
+    planes[8u + i] = normal_c[i] / area_squared;
+    planes[3u] += normal[i] * a[i];
+    planes[7u] -= planes[4u + i] * a[i];
+    planes[11u] -= planes[8u + i] * a[i];
   }
+}
 
-  t = ( f * cb ) * det;
-  
-  std::cerr << "t = " << t << std::endl;
-  if (t > 0.0) {
-    p = ray.origin + t * ray.direction;
-    return true;
-  }
-  
-  return false;
+template <class FLOAT, size_t N>
+PrecomputedTriangle<FLOAT, N>::PrecomputedTriangle(const Triangle<FLOAT, N> & triangle)
+  : PrecomputedTriangle(triangle.a, triangle.b, triangle.c) { }
+
+template <class FLOAT, size_t N>
+bool PrecomputedTriangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  return triangle::intersects(planes.data(), 1u, ray, context);
 }
-*/
 
-/*
+// with n = normal, n_b = planes[4 .. 6], n_c = planes[8 .. 10]:
+// b - a = n_c x n, c - a = n x n_b, a = distance / |n|^2 * n - distance_b * (b - a) - distance_c * (c - a)
 template <class FLOAT, size_t N>
-bool Triangle<FLOAT, N>::intersects(const Ray<FLOAT, N> &ray, Vector<FLOAT, N> & normal, Vector<FLOAT, N> & p, FLOAT & u, FLOAT & v, FLOAT & t) const {
-  const FLOAT EPSILON = 10e-7;
-  Vector<FLOAT, N> ca = a - c;
-  Vector<FLOAT, N> cb = b - c;
-  normal = cb.cross_product( ca );
-
-  //this->print(std::cerr);
-  //std::cerr << "ray.origin = ( " << ray.origin[0] << ", " << ray.origin[1] << ", " << ray.origin[2] << ")" << std::endl;  
-  //std::cerr << "ray.direction = ( " << ray.direction[0] << ", " << ray.direction[1] << ", " << ray.direction[2] << ")" << std::endl;  
-  //std::cerr << "ca = ( " << ca[0] << ", " << ca[1] << ", " << ca[2] << ") " << std::endl; 
-  //std::cerr << "cb = ( " << cb[0] << ", " << cb[1] << ", " << cb[2] << ") " << std::endl; 
-  //std::cerr << "normal = ( " << normal[0] << ", " << normal[1] << ", " << normal[2] << ") " << std::endl; 
-
-  FLOAT det = ray.direction * normal; 
-  
-  //std::cerr << "det = " << det << std::endl;
+AxisAlignedBoundingBox<FLOAT, N> PrecomputedTriangle<FLOAT, N>::bounding_box() const {
+  std::array<double, 12u> p;
+  std::copy(planes.begin(), planes.end(), p.begin());
+  double area_squared = p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+  Vector<FLOAT, N> center, half_edge_length;
+  if (area_squared == 0.0) {
+    return AxisAlignedBoundingBox<FLOAT, N>(center, half_edge_length);
+  }
+  Vector<double, 3u> n = {p[0], p[1], p[2]};
+  Vector<double, 3u> ab = Vector<double, 3u>{p[8], p[9], p[10]}.cross_product(n);
+  Vector<double, 3u> ac = n.cross_product(Vector<double, 3u>{p[4], p[5], p[6]});
+  for (size_t i = 0; i < 3u; i++) {
+    double a = p[3] / area_squared * p[i] - p[7] * ab[i] - p[11] * ac[i];
+    double min = std::min({a, a + ab[i], a + ac[i]});
+    double max = std::max({a, a + ab[i], a + ac[i]});
+    // widened by the rounding errors of the planes
+    double error = 4.0 * std::numeric_limits<FLOAT>::epsilon() * std::max(std::fabs(min), std::fabs(max));
+    center[i] = 0.5 * (min + max);
+    half_edge_length[i] = 0.5 * (max - min) + error;
+  }
+  return AxisAlignedBoundingBox<FLOAT, N>(center, half_edge_length);
+}
 
-  if ( -det  < EPSILON ) { // backface culling on
-    //std::cerr << "|det| < epsilon" << std::endl;
-    return false;
+template <class FLOAT, size_t N, size_t WIDTH>
+TriangleBlock<FLOAT, N, WIDTH>::TriangleBlock(std::span< const PrecomputedTriangle<FLOAT, N> > triangles)
+  : count(std::min(triangles.size(), WIDTH))
+{
+  assert(triangles.size() <= WIDTH);
+  for (auto & values : planes) {
+    values.fill(0.0); // the determinant of the unused lanes is zero, they are never hit
+  }
+  for (size_t lane = 0; lane < count; lane++) {
+    for (size_t i = 0; i < 12u; i++) {
+      planes[i][lane] = triangles[lane].planes[i];
+    }
   }
+}
 
-  det = 1.0 / det;  
+template <class FLOAT, size_t N, size_t WIDTH>
+size_t TriangleBlock<FLOAT, N, WIDTH>::size() const {
+  return count;
+}
 
-  Vector<FLOAT, N> co = ray.origin - c;
-  //std::cerr << "co = ( " << co[0] << ", " << co[1] << ", " << co[2] << ") " << std::endl; 
-  
-  
-  u = (ray.direction * ( cb.cross_product(co) ) ) * det;
+template <class FLOAT, size_t N, size_t WIDTH>
+void TriangleBlock<FLOAT, N, WIDTH>::set_context(size_t index, const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  triangle::intersects(&planes[0][index], WIDTH, ray, context);
+}
 
+template <class FLOAT, size_t N, size_t WIDTH>
+size_t TriangleBlock<FLOAT, N, WIDTH>::intersects(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context, FLOAT t_max) const {
+  size_t nearest = WIDTH;
+  FLOAT t_nearest = t_max;
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT, float>) {
+    __m128 o[3], d[3];
+    for (size_t i = 0; i < 3u; i++) {
+      o[i] = _mm_set1_ps(ray.origin[i]);
+      d[i] = _mm_set1_ps(ray.direction[i]);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t first = 0; first < WIDTH; first += 4u) {
+      __m128 p[12];
+      for (size_t i = 0; i < 12u; i++) {
+        p[i] = _mm_load_ps(planes[i].data() + first);
+      }
+      __m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], d[0]), _mm_mul_ps(p[1], d[1])), _mm_mul_ps(p[2], d[2]));
+      __m128 scaled_t = _mm_sub_ps(p[3], _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], o[0]), _mm_mul_ps(p[1], o[1])), _mm_mul_ps(p[2], o[2])));
+      __m128 px = _mm_add_ps(_mm_mul_ps(determinant, o[0]), _mm_mul_ps(scaled_t, d[0]));
+      __m128 py = _mm_add_ps(_mm_mul_ps(determinant, o[1]), _mm_mul_ps(scaled_t, d[1]));
+      __m128 pz = _mm_add_ps(_mm_mul_ps(determinant, o[2]), _mm_mul_ps(scaled_t, d[2]));
+      __m128 scaled_b = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p[4], px), _mm_mul_ps(p[5], py)), _mm_mul_ps(p[6], pz)),
+                                   _mm_mul_ps(determinant, p[7]));
+      __m128 scaled_c = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p[8], px), _mm_mul_ps(p[9], py)), _mm_mul_ps(p[10], pz)),
+                                   _mm_mul_ps(determinant, p[11]));
+      __m128 scaled_a = _mm_sub_ps(_mm_sub_ps(determinant, scaled_b), scaled_c);
+
+      __m128 hit = _mm_cmpneq_ps(determinant, zero);
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_mul_ps(scaled_t, determinant), zero));
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_mul_ps(scaled_a, determinant), zero));
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_mul_ps(scaled_b, determinant), zero));
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_mul_ps(scaled_c, determinant), zero));
+      __m128 t = _mm_mul_ps(scaled_t, _mm_div_ps(one, determinant));
+      hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_set1_ps(t_nearest)));
+
+      int lanes = _mm_movemask_ps(hit);
+      if (lanes != 0) {
+        alignas(16) float values[4];
+        _mm_store_ps(values, t);
+        for (size_t lane = 0; lane < 4u; lane++) {
+          if ((lanes & (1 << lane)) && values[lane] < t_nearest) {
+            t_nearest = values[lane];
+            nearest = first + lane;
+          }
+        }
+      }
+    }
+    if (nearest < WIDTH) {
+      set_context(nearest, ray, context);
+    }
+    return nearest;
+  }
+#endif
+  Intersection_Context<FLOAT, N> candidate;
+  for (size_t lane = 0; lane < count; lane++) {
+    if (triangle::intersects(&planes[0][lane], WIDTH, ray, candidate) && candidate.t < t_nearest) {
+      t_nearest = candidate.t;
+      nearest = lane;
+      context = candidate;
+    }
+  }
+  return nearest;
+}
 
-  //std::cerr << "u = " << u << std::endl;
-  
-  if ( (u < 0.0) || (u > 1.0) ) {
-    return false;
-  } 
-  
-  v = (ray.direction * (co.cross_product(ca)) ) * det;
 
-  //std::cerr << "v = " << v << std::endl;
-  
-  if ( (v < 0.0) || ((u + v) > 1.0) ) {
-    return false;
+template <class FLOAT, size_t N, size_t W>
+Ray<FLOAT, N> RayPacket<FLOAT, N, W>::get(size_t i) const {
+  Ray<FLOAT, N> ray;
+  for (size_t axis = 0; axis < N; axis++) {
+    ray.origin[axis] = origin[axis][i];
+    ray.direction[axis] = direction[axis][i];
   }
+  return ray;
+}
 
-  t = -( co * normal ) * det;
-  
-  //std::cerr << "t = " << t << std::endl;
-  if (t > 0.0) {
-    p = ray.origin + t * ray.direction;
-    //Vector<FLOAT, N> pp = u * a + v * b + ( static_cast<FLOAT>(1.0) - u - v) * c;
-    
-    //std::cerr << "p = (" << p[0] << ", " << p[1] << ", " << p[2] << ")" << std::endl;
-    //std::cerr << "pp = (" << pp[0] << ", " << pp[1] << ", " << pp[2] << ")" << std::endl;
-    normal = static_cast<FLOAT>(-1.0) * normal;
-    return true;
+template <class FLOAT, size_t N, size_t W>
+void RayPacket<FLOAT, N, W>::set(size_t i, const Ray<FLOAT, N> & ray) {
+  for (size_t axis = 0; axis < N; axis++) {
+    origin[axis][i] = ray.origin[axis];
+    direction[axis][i] = ray.direction[axis];
   }
-  
-  return false;
 }
-*/
 
+#ifdef MATH_SIMD
+namespace masks {
+
+// the lanes [first, first + 4) of a mask as an SSE mask
+inline __m128 lanes(uint32_t mask, size_t first) {
+  mask >>= first;
+  return _mm_castsi128_ps(_mm_set_epi32(-((mask >> 3) & 1u), -((mask >> 2) & 1u), -((mask >> 1) & 1u), -(mask & 1u)));
+}
+
+// value1 in the lanes of mask, value2 in the others
+inline __m128 select(__m128 mask, __m128 value1, __m128 value2) {
+  return _mm_or_ps(_mm_and_ps(mask, value1), _mm_andnot_ps(mask, value2));
+}
+
+}
+#endif
 
 template <class FLOAT, size_t N>
-bool refract(FLOAT refraction_index, Vector<FLOAT, N> normal, Vector<FLOAT, N> direction, Vector<FLOAT, N> & transmission) {
-   FLOAT cos_theta = direction * normal; // both vectors need to be normalized
-   FLOAT sin_phi_squared = refraction_index * refraction_index * (static_cast<FLOAT>(1.0) - cos_theta * cos_theta);
-     
-   if ( sin_phi_squared > static_cast<FLOAT>(1.0f) ) {
-     return false; // total internal reflection
-   }
-   FLOAT cos_phi = sqrt( static_cast<FLOAT>(1.0f) - sin_phi_squared );
-   transmission = refraction_index * (direction - cos_theta * normal  ) - cos_phi * normal;
-   
-   return true;
+template <size_t W>
+uint32_t AxisAlignedBoundingBox<FLOAT, N>::intersects(const RayPacket<FLOAT, N, W> & packet, const std::array<FLOAT, W> & t_max,
+                                                      uint32_t active) const {
+  uint32_t hits = 0u;
+  size_t first = 0u;
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT, float>) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; first + 4u <= W; first += 4u) {
+      __m128 t_near = _mm_setzero_ps();
+      __m128 t_far = _mm_load_ps(t_max.data() + first);
+      for (size_t i = 0; i < N; i++) {
+        __m128 origin = _mm_load_ps(packet.origin[i].data() + first);
+        __m128 inverse = _mm_div_ps(one, _mm_load_ps(packet.direction[i].data() + first));
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(center[i] - half_edge_length[i]), origin), inverse);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(center[i] + half_edge_length[i]), origin), inverse);
+        // the operand order keeps t_near and t_far for NaN, like std::max(t_near, std::min(t0, t1))
+        t_near = _mm_max_ps(_mm_min_ps(t1, t0), t_near);
+        t_far = _mm_min_ps(_mm_max_ps(t1, t0), t_far);
+      }
+      hits |= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmple_ps(t_near, t_far))) << first;
+    }
+  }
+#endif
+  for (; first < W; first++) {
+    FLOAT t_near = 0.0;
+    FLOAT t_far = t_max[first];
+    for (size_t i = 0; i < N; i++) {
+      FLOAT inverse = static_cast<FLOAT>(1.0) / packet.direction[i][first];
+      FLOAT t0 = (center[i] - half_edge_length[i] - packet.origin[i][first]) * inverse;
+      FLOAT t1 = (center[i] + half_edge_length[i] - packet.origin[i][first]) * inverse;
+      t_near = std::max(t_near, std::min(t0, t1));
+      t_far = std::min(t_far, std::max(t0, t1));
+    }
+    hits |= static_cast<uint32_t>(t_near <= t_far) << first;
+  }
+  return hits & active;
+}
+
+// the quadratic equation of intersects(ray) for four rays
+template <class FLOAT, size_t N>
+template <size_t W>
+uint32_t Sphere<FLOAT, N>::intersects(const RayPacket<FLOAT, N, W> & packet, std::array<FLOAT, W> & t, uint32_t active) const {
+  uint32_t hits = 0u;
+  size_t first = 0u;
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT, float>) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (; first + 4u <= W; first += 4u) {
+      __m128 a = zero, b = zero, c = zero;
+      for (size_t i = 0; i < N; i++) {
+        __m128 om = _mm_sub_ps(_mm_load_ps(packet.origin[i].data() + first), _mm_set1_ps(center[i]));
+        __m128 direction = _mm_load_ps(packet.direction[i].data() + first);
+        a = _mm_add_ps(a, _mm_mul_ps(direction, direction));
+        b = _mm_add_ps(b, _mm_mul_ps(om, direction));
+        c = _mm_add_ps(c, _mm_mul_ps(om, om));
+      }
+      b = _mm_add_ps(b, b);
+      c = _mm_sub_ps(c, _mm_set1_ps(radius * radius));
+      __m128 d = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(4.0f), a), c));
+      __m128 hit = _mm_cmpge_ps(d, zero);
+      d = _mm_sqrt_ps(_mm_max_ps(d, zero));
+
+      __m128 far = _mm_add_ps(_mm_sub_ps(zero, b), d);
+      __m128 near = _mm_sub_ps(_mm_sub_ps(zero, b), d);
+      // the origin inside: the far intersection, otherwise the near one (negative if the sphere is behind)
+      __m128 inside = _mm_cmple_ps(c, zero);
+      __m128 value = masks::select(inside, far, _mm_min_ps(_mm_max_ps(zero, far), near));
+      value = _mm_div_ps(_mm_mul_ps(half, value), a);
+
+      __m128 nearest = _mm_load_ps(t.data() + first);
+      hit = _mm_and_ps(hit, _mm_and_ps(_mm_cmpgt_ps(value, zero), _mm_cmplt_ps(value, nearest)));
+      hit = _mm_and_ps(hit, masks::lanes(active, first));
+      _mm_store_ps(t.data() + first, masks::select(hit, value, nearest));
+      hits |= static_cast<uint32_t>(_mm_movemask_ps(hit)) << first;
+    }
+  }
+#endif
+  for (; first < W; first++) {
+    if (active & (1u << first)) {
+      FLOAT value = intersects(packet.get(first));
+      if (value > 0.0 && value < t[first]) {
+        t[first] = value;
+        hits |= 1u << first;
+      }
+    }
+  }
+  return hits;
+}
+
+template <class FLOAT, size_t N>
+template <size_t W>
+uint32_t PrecomputedTriangle<FLOAT, N>::intersects(const RayPacket<FLOAT, N, W> & packet, std::array<FLOAT, W> & t,
+                                                   uint32_t active) const {
+  uint32_t hits = 0u;
+  size_t first = 0u;
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT, float>) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 p[12];
+    for (size_t i = 0; i < 12u; i++) {
+      p[i] = _mm_set1_ps(planes[i]);
+    }
+    for (; first + 4u <= W; first += 4u) {
+      __m128 o[3], d[3];
+      for (size_t i = 0; i < 3u; i++) {
+        o[i] = _mm_load_ps(packet.origin[i].data() + first);
+        d[i] = _mm_load_ps(packet.direction[i].data() + first);
+      }
+      // the operations of triangle::intersects
+      __m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], d[0]), _mm_mul_ps(p[1], d[1])), _mm_mul_ps(p[2], d[2]));
+      __m128 scaled_t = _mm_sub_ps(p[3], _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], o[0]), _mm_mul_ps(p[1], o[1])), _mm_mul_ps(p[2], o[2])));
+      __m128 px = _mm_add_ps(_mm_mul_ps(determinant, o[0]), _mm_mul_ps(scaled_t, d[0]));
+      __m128 py = _mm_add_ps(_mm_mul_ps(determinant, o[1]), _mm_mul_ps(scaled_t, d[1]));
+      __m128 pz = _mm_add_ps(_mm_mul_ps(determinant, o[2]), _mm_mul_ps(scaled_t, d[2]));
+      __m128 scaled_b = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p[4], px), _mm_mul_ps(p[5], py)), _mm_mul_ps(p[6], pz)),
+                                   _mm_mul_ps(determinant, p[7]));
+      __m128 scaled_c = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(p[8], px), _mm_mul_ps(p[9], py)), _mm_mul_ps(p[10], pz)),
+                                   _mm_mul_ps(determinant, p[11]));
+      __m128 scaled_a = _mm_sub_ps(_mm_sub_ps(determinant, scaled_b), scaled_c);
+
+      __m128 hit = _mm_cmpneq_ps(determinant, zero);
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_mul_ps(scaled_t, determinant), zero));
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_mul_ps(scaled_a, determinant), zero));
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_mul_ps(scaled_b, determinant), zero));
+      hit = _mm_and_ps(hit, _mm_cmpge_ps(_mm_mul_ps(scaled_c, determinant), zero));
+      __m128 value = _mm_mul_ps(scaled_t, _mm_div_ps(one, determinant));
+
+      __m128 nearest = _mm_load_ps(t.data() + first);
+      hit = _mm_and_ps(hit, _mm_cmplt_ps(value, nearest));
+      hit = _mm_and_ps(hit, masks::lanes(active, first));
+      _mm_store_ps(t.data() + first, masks::select(hit, value, nearest));
+      hits |= static_cast<uint32_t>(_mm_movemask_ps(hit)) << first;
+    }
+  }
+#endif
+  Intersection_Context<FLOAT, N> context;
+  for (; first < W; first++) {
+    if ((active & (1u << first)) && intersects(packet.get(first), context) && context.t < t[first]) {
+      t[first] = context.t;
+      hits |= 1u << first;
+    }
+  }
+  return hits;
+}
+
+template <class FLOAT, size_t N>
+template <size_t W>
+uint32_t Triangle<FLOAT, N>::intersects(const RayPacket<FLOAT, N, W> & packet, std::array<FLOAT, W> & t, uint32_t active) const {
+  return PrecomputedTriangle<FLOAT, N>(a, b, c).intersects(packet, t, active);
+}
+
+
+template <class FLOAT, size_t N>
+PreparedRay<FLOAT, N>::PreparedRay(const Ray<FLOAT, N> & ray)
+  : origin(ray.origin), direction(ray.direction), sign_bits(0u)
+{
+  for (size_t i = 0; i < N; i++) {
+    inverse[i] = static_cast<FLOAT>(1.0) / direction[i];
+    sign_bits |= static_cast<uint32_t>(std::signbit(direction[i])) << i;
+  }
+}
+
+namespace slab {
+
+// the slab test of the box [min, max] for the prepared ray, restricted to [t_near, t_far]
+// the sign of the direction selects the near and the far plane of each axis, no min/max per axis is needed,
+// a zero direction value and the origin on a slab plane give 0 * infinity = NaN, which the comparisons ignore
+// the SSE variant reads exactly three values from min and max, they need not be padded
+template <class FLOAT, size_t N>
+std::pair<FLOAT, FLOAT> interval(const FLOAT * min, const FLOAT * max, const PreparedRay<FLOAT, N> & ray, FLOAT t_near, FLOAT t_far) {
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT, float> && N == 3u) {
+    // {x, y} and {z, 0} combined to {x, y, z, 0}
+    auto load = [](const float * values) {
+      return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64 *>(values)), _mm_load_ss(values + 2));
+    };
+    __m128 lower = load(min);
+    __m128 upper = load(max);
+    __m128 origin = simd::load(ray.origin);
+    __m128 inverse = simd::load(ray.inverse);
+    __m128 negative = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(inverse), 31));
+    __m128 near = _mm_mul_ps(_mm_sub_ps(masks::select(negative, upper, lower), origin), inverse);
+    __m128 far = _mm_mul_ps(_mm_sub_ps(masks::select(negative, lower, upper), origin), inverse);
+    // for NaN _mm_max_ps and _mm_min_ps return the second operand
+    near = _mm_max_ps(near, _mm_set1_ps(t_near));
+    far = _mm_min_ps(far, _mm_set1_ps(t_far));
+    near = _mm_max_ss(_mm_max_ss(near, _mm_shuffle_ps(near, near, 1)), _mm_shuffle_ps(near, near, 2));
+    far = _mm_min_ss(_mm_min_ss(far, _mm_shuffle_ps(far, far, 1)), _mm_shuffle_ps(far, far, 2));
+    return {_mm_cvtss_f32(near), _mm_cvtss_f32(far)};
+  }
+#endif
+  for (size_t i = 0; i < N; i++) {
+    bool negative = (ray.sign_bits >> i) & 1u;
+    FLOAT near = ((negative ? max[i] : min[i]) - ray.origin[i]) * ray.inverse[i];
+    FLOAT far = ((negative ? min[i] : max[i]) - ray.origin[i]) * ray.inverse[i];
+    t_near = near > t_near ? near : t_near;
+    t_far = far < t_far ? far : t_far;
+  }
+  return {t_near, t_far};
+}
+
+}
+
+template <class FLOAT, size_t N>
+std::pair<FLOAT, FLOAT> AxisAlignedBoundingBox<FLOAT, N>::slab_interval(const PreparedRay<FLOAT, N> & ray, FLOAT t_min, FLOAT t_max) const {
+  Vector<FLOAT, N> min = center - half_edge_length;
+  Vector<FLOAT, N> max = center + half_edge_length;
+  return slab::interval(min.vector.data(), max.vector.data(), ray, t_min, t_max);
+}
+
+
+namespace polygon {
+
+// the z value of the cross product of b - a and c - a, positive iff a, b, c are in counterclockwise order
+template <class FLOAT>
+FLOAT orientation(const Vector<FLOAT, 2u> & a, const Vector<FLOAT, 2u> & b, const Vector<FLOAT, 2u> & c) {
+  return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+template <class FLOAT>
+bool equal(const Vector<FLOAT, 2u> & a, const Vector<FLOAT, 2u> & b) {
+  return a[0] == b[0] && a[1] == b[1];
+}
+
+template <class FLOAT>
+AxisAlignedBoundingBox<FLOAT, 2u> bounds(std::span<const Vector<FLOAT, 2u>> points) {
+  assert(!points.empty());
+  Vector<FLOAT, 2u> min = points[0];
+  Vector<FLOAT, 2u> max = points[0];
+  for (const auto & point : points) {
+    for (size_t axis = 0; axis < 2u; axis++) {
+      min[axis] = std::min(min[axis], point[axis]);
+      max[axis] = std::max(max[axis], point[axis]);
+    }
+  }
+  return AxisAlignedBoundingBox<FLOAT, 2u>(static_cast<FLOAT>(0.5) * (min + max), static_cast<FLOAT>(0.5) * (max - min));
+}
+
+// returns the aabb of all parts
+template <class FLOAT>
+AxisAlignedBoundingBox<FLOAT, 2u> union_bounds(const std::vector< ConvexPolygon<FLOAT> > & parts) {
+  std::vector< Vector<FLOAT, 2u> > corners;
+  for (const auto & part : parts) {
+    AxisAlignedBoundingBox<FLOAT, 2u> box = part.bounding_box();
+    corners.push_back(box.get_center() - box.get_half_edge_length());
+    corners.push_back(box.get_center() + box.get_half_edge_length());
+  }
+  if (corners.empty()) {
+    corners.push_back( Vector<FLOAT, 2u>{} );
+  }
+  return bounds<FLOAT>(corners);
+}
+
+// returns true iff the boxes intersect, box2 moved by offset
+template <class FLOAT>
+bool intersects(const AxisAlignedBoundingBox<FLOAT, 2u> & box1, const AxisAlignedBoundingBox<FLOAT, 2u> & box2, const Vector<FLOAT, 2u> & offset) {
+  return box1.intersects( AxisAlignedBoundingBox<FLOAT, 2u>(box2.get_center() + offset, box2.get_half_edge_length()) );
+}
+
+// returns v rotated around the origin by the angle of cosine and sine
+template <class FLOAT>
+Vector<FLOAT, 2u> rotate(const Vector<FLOAT, 2u> & v, FLOAT cosine, FLOAT sine) {
+  return Vector<FLOAT, 2u>{cosine * v[0] - sine * v[1], sine * v[0] + cosine * v[1]};
+}
+
+// returns the aabb of the given box rotated around the origin by the angle of cosine and sine
+template <class FLOAT>
+AxisAlignedBoundingBox<FLOAT, 2u> rotate(const AxisAlignedBoundingBox<FLOAT, 2u> & box, FLOAT cosine, FLOAT sine) {
+  Vector<FLOAT, 2u> half = box.get_half_edge_length();
+  FLOAT c = std::abs(cosine);
+  FLOAT s = std::abs(sine);
+  return AxisAlignedBoundingBox<FLOAT, 2u>(rotate(box.get_center(), cosine, sine),
+                                           Vector<FLOAT, 2u>{c * half[0] + s * half[1], s * half[0] + c * half[1]});
+}
+
+// returns the interval of the projections of the points on axis
+template <class FLOAT>
+std::pair<FLOAT, FLOAT> project(const std::vector< Vector<FLOAT, 2u> > & points, const Vector<FLOAT, 2u> & axis) {
+  FLOAT min = INFINITY;
+  FLOAT max = -INFINITY;
+  for (const auto & point : points) {
+    FLOAT projection = point * axis;
+    min = std::min(min, projection);
+    max = std::max(max, projection);
+  }
+  return {min, max};
+}
+
+// returns true iff one of the axes separates the projections of a polygon (extents, precomputed per axis)
+// and the points of another one moved by offset
+template <class FLOAT>
+bool separated(const std::vector< Vector<FLOAT, 2u> > & axes, const std::vector< std::pair<FLOAT, FLOAT> > & extents,
+               const std::vector< Vector<FLOAT, 2u> > & points, const Vector<FLOAT, 2u> & offset) {
+  for (size_t i = 0; i < axes.size(); i++) {
+    auto [min, max] = project(points, axes[i]);
+    FLOAT shift = offset * axes[i];
+    if (extents[i].second < min + shift || max + shift < extents[i].first) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// returns true iff p is inside of (or on) the counterclockwise triangle a, b, c
+template <class FLOAT>
+bool inside(const Vector<FLOAT, 2u> & p, const Vector<FLOAT, 2u> & a, const Vector<FLOAT, 2u> & b, const Vector<FLOAT, 2u> & c) {
+  return orientation(a, b, p) >= 0.0 && orientation(b, c, p) >= 0.0 && orientation(c, a, p) >= 0.0;
+}
+
+// returns the union of the counterclockwise polygons (indices of points) if they share an edge
+// and the union is convex, otherwise an empty polygon
+template <class FLOAT>
+std::vector<size_t> unite(const std::vector<size_t> & polygon1, const std::vector<size_t> & polygon2,
+                          const std::vector< Vector<FLOAT, 2u> > & points) {
+  size_t n1 = polygon1.size();
+  size_t n2 = polygon2.size();
+  for (size_t i = 0; i < n1; i++) {
+    for (size_t j = 0; j < n2; j++) {
+      // the edge u -> v of polygon1 is the edge v -> u of polygon2
+      if (polygon1[i] != polygon2[(j + 1) % n2] || polygon1[(i + 1) % n1] != polygon2[j]) {
+        continue;
+      }
+      std::vector<size_t> united;
+      for (size_t k = 1; k <= n1; k++) {
+        united.push_back(polygon1[(i + k) % n1]);  // from v around to u
+      }
+      for (size_t k = 2; k < n2; k++) {
+        united.push_back(polygon2[(j + k) % n2]);  // behind u up to v
+      }
+      size_t n = united.size();
+      for (size_t k = 0; k < n; k++) {
+        if (orientation(points[united[k]], points[united[(k + 1) % n]], points[united[(k + 2) % n]]) < 0.0) {
+          return {};
+        }
+      }
+      return united;
+    }
+  }
+  return {};
+}
+
+}
+
+template <class FLOAT>
+ConvexPolygon<FLOAT>::ConvexPolygon(std::span<const Vector<FLOAT, 2u>> points)
+  : points(points.begin(), points.end()), bounds(polygon::bounds(points))
+{
+  // the two edges of a line segment have the same axis
+  size_t edges = points.size() == 2u ? 1u : points.size();
+  for (size_t i = 0; i < edges; i++) {
+    Vector<FLOAT, 2u> edge = points[(i + 1) % points.size()] - points[i];
+    normals.push_back( Vector<FLOAT, 2u>{edge[1], -edge[0]} );
+    extents.push_back( polygon::project(this->points, normals.back()) );
+  }
+}
+
+template <class FLOAT>
+ConvexPolygon<FLOAT> ConvexPolygon<FLOAT>::convex_hull(std::span<const Vector<FLOAT, 2u>> points) {
+  std::vector< Vector<FLOAT, 2u> > sorted(points.begin(), points.end());
+  std::sort(sorted.begin(), sorted.end(), [](const Vector<FLOAT, 2u> & a, const Vector<FLOAT, 2u> & b) {
+    return a[0] < b[0] || (a[0] == b[0] && a[1] < b[1]);
+  });
+  if (sorted.size() < 3u) {
+    return ConvexPolygon<FLOAT>(sorted);
+  }
+  std::vector< Vector<FLOAT, 2u> > hull(2u * sorted.size());
+  size_t k = 0;
+  for (size_t i = 0; i < sorted.size(); i++) {  // lower hull
+    while (k >= 2u && polygon::orientation(hull[k - 2], hull[k - 1], sorted[i]) <= 0.0) {
+      k--;
+    }
+    hull[k++] = sorted[i];
+  }
+  for (size_t i = sorted.size() - 1, lower = k + 1; i > 0; i--) {  // upper hull
+    while (k >= lower && polygon::orientation(hull[k - 2], hull[k - 1], sorted[i - 1]) <= 0.0) {
+      k--;
+    }
+    hull[k++] = sorted[i - 1];
+  }
+  hull.resize(k - 1);  // the first point is repeated at the end
+  return ConvexPolygon<FLOAT>(hull);
+}
+
+template <class FLOAT>
+bool ConvexPolygon<FLOAT>::intersects(const ConvexPolygon<FLOAT> & polygon, Vector<FLOAT, 2u> offset) const {
+  if (!polygon::intersects(bounds, polygon.bounds, offset)) {
+    return false;
+  }
+  return !polygon::separated(normals, extents, polygon.points, offset)
+      && !polygon::separated(polygon.normals, polygon.extents, points, static_cast<FLOAT>(-1.0) * offset);
+}
+
+template <class FLOAT>
+bool ConvexPolygon<FLOAT>::intersects_segment(Vector<FLOAT, 2u> start, Vector<FLOAT, 2u> end) const {
+  const std::array< Vector<FLOAT, 2u>, 2u > segment = {start, end};
+  if (!polygon::intersects(bounds, polygon::bounds<FLOAT>(segment), Vector<FLOAT, 2u>{})) {
+    return false;
+  }
+  for (size_t i = 0; i < normals.size(); i++) {
+    FLOAT projection1 = start * normals[i];
+    FLOAT projection2 = end * normals[i];
+    if (extents[i].second < std::min(projection1, projection2) || std::max(projection1, projection2) < extents[i].first) {
+      return false;
+    }
+  }
+  // the normal of the segment, both points have the same projection
+  Vector<FLOAT, 2u> edge = end - start;
+  Vector<FLOAT, 2u> axis = {edge[1], -edge[0]};
+  auto [min, max] = polygon::project(points, axis);
+  FLOAT projection = start * axis;
+  return min <= projection && projection <= max;
+}
+
+template <class FLOAT>
+bool ConvexPolygon<FLOAT>::intersects_rotated(const ConvexPolygon<FLOAT> & polygon, FLOAT cosine, FLOAT sine,
+                                              Vector<FLOAT, 2u> offset) const {
+  if (!polygon::intersects(bounds, polygon::rotate(polygon.bounds, cosine, sine), offset)) {
+    return false;
+  }
+  // the rotated points projected on an axis of this polygon are the points projected on the axis rotated backwards
+  for (size_t i = 0; i < normals.size(); i++) {
+    auto [min, max] = polygon::project(polygon.points, polygon::rotate(normals[i], cosine, -sine));
+    FLOAT shift = offset * normals[i];
+    if (extents[i].second < min + shift || max + shift < extents[i].first) {
+      return false;
+    }
+  }
+  // the rotated polygon projected on its rotated axes gives its extents
+  for (size_t i = 0; i < polygon.normals.size(); i++) {
+    Vector<FLOAT, 2u> axis = polygon::rotate(polygon.normals[i], cosine, sine);
+    auto [min, max] = polygon::project(points, axis);
+    FLOAT shift = offset * axis;
+    if (max < polygon.extents[i].first + shift || polygon.extents[i].second + shift < min) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class FLOAT>
+ConvexPolygon<FLOAT> ConvexPolygon<FLOAT>::transformed(FLOAT angle, FLOAT scale) const {
+  FLOAT cosine = scale * std::cos(angle);
+  FLOAT sine = scale * std::sin(angle);
+  std::vector< Vector<FLOAT, 2u> > result;
+  for (const auto & point : points) {
+    result.push_back( polygon::rotate(point, cosine, sine) );
+  }
+  return ConvexPolygon<FLOAT>(result);
+}
+
+template <class FLOAT>
+const std::vector< Vector<FLOAT, 2u> > & ConvexPolygon<FLOAT>::get_points() const {
+  return points;
+}
+
+template <class FLOAT>
+AxisAlignedBoundingBox<FLOAT, 2u> ConvexPolygon<FLOAT>::bounding_box() const {
+  return bounds;
+}
+
+template <class FLOAT>
+ConvexDecomposition<FLOAT>::ConvexDecomposition(std::span<const Vector<FLOAT, 2u>> outline)
+  : bounds(Vector<FLOAT, 2u>{}, Vector<FLOAT, 2u>{})
+{
+  std::vector< Vector<FLOAT, 2u> > points;
+  for (const auto & point : outline) {
+    if (points.empty() || !polygon::equal(point, points.back())) {
+      points.push_back(point);
+    }
+  }
+  while (points.size() > 1u && polygon::equal(points.front(), points.back())) {
+    points.pop_back();
+  }
+  FLOAT area = 0.0;
+  for (size_t i = 0; i < points.size(); i++) {
+    area += polygon::orientation(Vector<FLOAT, 2u>{}, points[i], points[(i + 1) % points.size()]);
+  }
+  if (area < 0.0) {
+    std::reverse(points.begin(), points.end());
+  }
+
+  // ear clipping: a convex corner without other points inside of its triangle is cut off
+  std::vector< std::vector<size_t> > polygons;
+  std::vector<size_t> remaining(points.size());
+  std::iota(remaining.begin(), remaining.end(), 0u);
+  bool clipped = true;
+  while (remaining.size() > 3u && clipped) {
+    clipped = false;
+    for (size_t i = 0; i < remaining.size() && !clipped; i++) {
+      size_t previous = remaining[(i + remaining.size() - 1) % remaining.size()];
+      size_t current = remaining[i];
+      size_t next = remaining[(i + 1) % remaining.size()];
+      FLOAT turn = polygon::orientation(points[previous], points[current], points[next]);
+      bool ear = turn >= 0.0;
+      for (size_t k = 0; k < remaining.size() && ear && turn > 0.0; k++) {
+        size_t other = remaining[k];
+        ear = other == previous || other == current || other == next
+              || !polygon::inside(points[other], points[previous], points[current], points[next]);
+      }
+      if (ear) {
+        if (turn > 0.0) {
+          polygons.push_back( {previous, current, next} );
+        }
+        remaining.erase(remaining.begin() + i);  // collinear points are dropped
+        clipped = true;
+      }
+    }
+  }
+  if (remaining.size() == 3u && polygon::orientation(points[remaining[0]], points[remaining[1]], points[remaining[2]]) > 0.0) {
+    polygons.push_back(remaining);
+  }
+
+  // Hertel-Mehlhorn: parts sharing a diagonal are merged as long as the union stays convex
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (size_t i = 0; i < polygons.size() && !merged; i++) {
+      for (size_t j = i + 1; j < polygons.size() && !merged; j++) {
+        std::vector<size_t> united = polygon::unite(polygons[i], polygons[j], points);
+        if (!united.empty()) {
+          polygons[i] = united;
+          polygons.erase(polygons.begin() + j);
+          merged = true;
+        }
+      }
+    }
+  }
+  for (const auto & indices : polygons) {
+    std::vector< Vector<FLOAT, 2u> > part;
+    for (size_t index : indices) {
+      part.push_back(points[index]);
+    }
+    parts.push_back( ConvexPolygon<FLOAT>(part) );
+  }
+  // an outline with self intersections can not be clipped completely, its rest is covered by the convex hull
+  if (remaining.size() > 3u) {
+    std::vector< Vector<FLOAT, 2u> > rest;
+    for (size_t index : remaining) {
+      rest.push_back(points[index]);
+    }
+    parts.push_back( ConvexPolygon<FLOAT>::convex_hull(rest) );
+  }
+  bounds = polygon::union_bounds(parts);
+}
+
+template <class FLOAT>
+ConvexDecomposition<FLOAT>::ConvexDecomposition(std::vector< ConvexPolygon<FLOAT> > parts)
+  : parts(std::move(parts)), bounds(polygon::union_bounds(this->parts))
+{
+}
+
+template <class FLOAT>
+bool ConvexDecomposition<FLOAT>::intersects(const ConvexDecomposition<FLOAT> & decomposition, Vector<FLOAT, 2u> offset) const {
+  if (!polygon::intersects(bounds, decomposition.bounds, offset)) {
+    return false;
+  }
+  for (const auto & part : decomposition.parts) {
+    if (intersects(part, offset)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class FLOAT>
+bool ConvexDecomposition<FLOAT>::intersects(const ConvexPolygon<FLOAT> & polygon, Vector<FLOAT, 2u> offset) const {
+  if (!polygon::intersects(bounds, polygon.bounding_box(), offset)) {
+    return false;
+  }
+  for (const auto & part : parts) {
+    if (part.intersects(polygon, offset)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class FLOAT>
+bool ConvexDecomposition<FLOAT>::intersects_segment(Vector<FLOAT, 2u> start, Vector<FLOAT, 2u> end) const {
+  const std::array< Vector<FLOAT, 2u>, 2u > segment = {start, end};
+  if (!polygon::intersects(bounds, polygon::bounds<FLOAT>(segment), Vector<FLOAT, 2u>{})) {
+    return false;
+  }
+  for (const auto & part : parts) {
+    if (part.intersects_segment(start, end)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class FLOAT>
+bool ConvexDecomposition<FLOAT>::intersects_rotated(const ConvexDecomposition<FLOAT> & decomposition, FLOAT angle,
+                                                    Vector<FLOAT, 2u> offset) const {
+  FLOAT cosine = std::cos(angle);
+  FLOAT sine = std::sin(angle);
+  if (!polygon::intersects(bounds, polygon::rotate(decomposition.bounds, cosine, sine), offset)) {
+    return false;
+  }
+  for (const auto & other : decomposition.parts) {
+    for (const auto & part : parts) {
+      if (part.intersects_rotated(other, cosine, sine, offset)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template <class FLOAT>
+ConvexDecomposition<FLOAT> ConvexDecomposition<FLOAT>::transformed(FLOAT angle, FLOAT scale) const {
+  std::vector< ConvexPolygon<FLOAT> > result;
+  for (const auto & part : parts) {
+    result.push_back( part.transformed(angle, scale) );
+  }
+  return ConvexDecomposition<FLOAT>(result);
+}
+
+template <class FLOAT>
+const std::vector< ConvexPolygon<FLOAT> > & ConvexDecomposition<FLOAT>::get_parts() const {
+  return parts;
+}
+
+
+template <class FLOAT>
+ConvexVertices<FLOAT>::ConvexVertices(std::span<const Vector<FLOAT, 3u>> points) : count(points.size()) {
+  assert(!points.empty());
+  size_t padded = (count + 3u) / 4u * 4u;
+  Vector<FLOAT, 3u> min = points[0], max = points[0];
+  for (size_t axis = 0; axis < 3u; axis++) {
+    coordinates[axis].resize(padded, points[0][axis]);
+    for (size_t i = 0; i < count; i++) {
+      coordinates[axis][i] = points[i][axis];
+      min[axis] = std::min(min[axis], points[i][axis]);
+      max[axis] = std::max(max[axis], points[i][axis]);
+    }
+  }
+  center = static_cast<FLOAT>(0.5) * (min + max);
+  FLOAT radius_squared = 0.0;
+  for (const auto & point : points) {
+    radius_squared = std::max(radius_squared, (point - center).square_of_length());
+  }
+  radius = sqrt(radius_squared);
+}
+
+template <class FLOAT>
+size_t ConvexVertices<FLOAT>::support(const Vector<FLOAT, 3u> & direction) const {
+  size_t best = 0u;
+  FLOAT best_value = -INFINITY;
+  size_t first = 0u;
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT, float>) {
+    const __m128 dx = _mm_set1_ps(direction[0]);
+    const __m128 dy = _mm_set1_ps(direction[1]);
+    const __m128 dz = _mm_set1_ps(direction[2]);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i best_indices = _mm_setzero_si128();
+    __m128 best_values = _mm_set1_ps(-INFINITY);
+    // the largest value and its first index per lane
+    for (; first < coordinates[0].size(); first += 4u) {
+      __m128 values = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(coordinates[0].data() + first), dx),
+                                            _mm_mul_ps(_mm_loadu_ps(coordinates[1].data() + first), dy)),
+                                 _mm_mul_ps(_mm_loadu_ps(coordinates[2].data() + first), dz));
+      __m128 greater = _mm_cmpgt_ps(values, best_values);
+      best_values = masks::select(greater, values, best_values);
+      best_indices = _mm_castps_si128(masks::select(greater, _mm_castsi128_ps(indices), _mm_castsi128_ps(best_indices)));
+      indices = _mm_add_epi32(indices, step);
+    }
+    alignas(16) std::array<float, 4u> values;
+    alignas(16) std::array<int32_t, 4u> lane_indices;
+    _mm_store_ps(values.data(), best_values);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lane_indices.data()), best_indices);
+    for (size_t lane = 0; lane < 4u; lane++) {
+      size_t index = static_cast<size_t>(lane_indices[lane]);
+      if (values[lane] > best_value || (values[lane] == best_value && index < best)) {
+        best_value = values[lane];
+        best = index;
+      }
+    }
+    // the padding copies the first point, it never wins against it
+    return best < count ? best : 0u;
+  }
+#endif
+  for (; first < count; first++) {
+    FLOAT value = coordinates[0][first] * direction[0] + coordinates[1][first] * direction[1]
+                + coordinates[2][first] * direction[2];
+    if (value > best_value) {
+      best_value = value;
+      best = first;
+    }
+  }
+  return best;
+}
+
+template <class FLOAT>
+Vector<FLOAT, 3u> ConvexVertices<FLOAT>::operator[](size_t index) const {
+  return Vector<FLOAT, 3u>{coordinates[0][index], coordinates[1][index], coordinates[2][index]};
+}
+
+template <class FLOAT>
+size_t ConvexVertices<FLOAT>::size() const {
+  return count;
+}
+
+template <class FLOAT>
+Vector<FLOAT, 3u> ConvexVertices<FLOAT>::get_center() const {
+  return center;
+}
+
+template <class FLOAT>
+FLOAT ConvexVertices<FLOAT>::get_radius() const {
+  return radius;
+}
+
+
+namespace gjk {
+
+template <class FLOAT>
+FLOAT tolerance() {
+  return static_cast<FLOAT>(100.0) * std::numeric_limits<FLOAT>::epsilon();
+}
+
+// a point of the Minkowski difference of both hulls, w = point1 - point2
+template <class FLOAT>
+struct Vertex {
+  Vector<FLOAT, 3u> w, point1, point2;
+  std::array<uint32_t, 2u> index;
+};
+
+// the closest point to the origin is the sum of lambda[i] * vertices[i].w
+template <class FLOAT>
+struct Simplex {
+  std::array<Vertex<FLOAT>, 4u> vertices;
+  std::array<FLOAT, 4u> lambda;
+  uint32_t count = 0u;
+};
+
+// the vertices of a simplex spanning its closest point to the origin and their barycentric coordinates
+template <class FLOAT>
+struct Feature {
+  std::array<uint32_t, 3u> kept;
+  std::array<FLOAT, 3u> lambda;
+  uint32_t count;
+  FLOAT distance_squared;
+};
+
+// two placed vertex sets, the support function of their Minkowski difference
+// the directions are transformed into the model spaces (by the transposed linear parts) instead of the points
+template <class FLOAT>
+struct Pair {
+  const ConvexVertices<FLOAT> & shape1;
+  const ConvexVertices<FLOAT> & shape2;
+  const Affine3<FLOAT> & transformation1;
+  const Affine3<FLOAT> & transformation2;
+  SquareMatrix<FLOAT, 3u> transposed1, transposed2;
+
+  Pair(const ConvexVertices<FLOAT> & shape1, const Affine3<FLOAT> & transformation1,
+       const ConvexVertices<FLOAT> & shape2, const Affine3<FLOAT> & transformation2)
+    : shape1(shape1), shape2(shape2), transformation1(transformation1), transformation2(transformation2),
+      transposed1(transformation1.get_linear().transpose()), transposed2(transformation2.get_linear().transpose()) {}
+
+  Vertex<FLOAT> vertex(uint32_t index1, uint32_t index2) const {
+    Vector<FLOAT, 3u> point1 = transformation1 * shape1[index1];
+    Vector<FLOAT, 3u> point2 = transformation2 * shape2[index2];
+    return {point1 - point2, point1, point2, {index1, index2}};
+  }
+
+  Vertex<FLOAT> support(const Vector<FLOAT, 3u> & direction) const {
+    return vertex(static_cast<uint32_t>(shape1.support(transposed1 * direction)),
+                  static_cast<uint32_t>(shape2.support(static_cast<FLOAT>(-1.0) * (transposed2 * direction))));
+  }
+
+  // a point of the Minkowski difference, the start direction of a run without cached simplex
+  Vector<FLOAT, 3u> center_difference() const {
+    return transformation1 * shape1.get_center() - transformation2 * shape2.get_center();
+  }
+};
+
+template <class FLOAT>
+Feature<FLOAT> segment(const Simplex<FLOAT> & simplex, uint32_t i, uint32_t j) {
+  const Vector<FLOAT, 3u> & a = simplex.vertices[i].w;
+  const Vector<FLOAT, 3u> & b = simplex.vertices[j].w;
+  Vector<FLOAT, 3u> ab = b - a;
+  FLOAT numerator = static_cast<FLOAT>(-1.0) * (a * ab);
+  FLOAT denominator = ab * ab;
+  if (numerator <= 0.0 || denominator <= 0.0) {
+    return {{i, 0u, 0u}, {1.0, 0.0, 0.0}, 1u, a * a};
+  }
+  if (numerator >= denominator) {
+    return {{j, 0u, 0u}, {1.0, 0.0, 0.0}, 1u, b * b};
+  }
+  FLOAT t = numerator / denominator;
+  Vector<FLOAT, 3u> closest = a + t * ab;
+  return {{i, j, 0u}, {static_cast<FLOAT>(1.0) - t, t, 0.0}, 2u, closest * closest};
+}
+
+// the Voronoi regions of the vertices, edges and the face (Ericson, Real-Time Collision Detection, 5.1.5)
+template <class FLOAT>
+Feature<FLOAT> triangle(const Simplex<FLOAT> & simplex, uint32_t i, uint32_t j, uint32_t k) {
+  const Vector<FLOAT, 3u> & a = simplex.vertices[i].w;
+  const Vector<FLOAT, 3u> & b = simplex.vertices[j].w;
+  const Vector<FLOAT, 3u> & c = simplex.vertices[k].w;
+  Vector<FLOAT, 3u> ab = b - a;
+  Vector<FLOAT, 3u> ac = c - a;
+  FLOAT d1 = static_cast<FLOAT>(-1.0) * (ab * a);
+  FLOAT d2 = static_cast<FLOAT>(-1.0) * (ac * a);
+  if (d1 <= 0.0 && d2 <= 0.0) {
+    return {{i, 0u, 0u}, {1.0, 0.0, 0.0}, 1u, a * a};
+  }
+  FLOAT d3 = static_cast<FLOAT>(-1.0) * (ab * b);
+  FLOAT d4 = static_cast<FLOAT>(-1.0) * (ac * b);
+  if (d3 >= 0.0 && d4 <= d3) {
+    return {{j, 0u, 0u}, {1.0, 0.0, 0.0}, 1u, b * b};
+  }
+  FLOAT vc = d1 * d4 - d3 * d2;
+  if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+    return segment(simplex, i, j);
+  }
+  FLOAT d5 = static_cast<FLOAT>(-1.0) * (ab * c);
+  FLOAT d6 = static_cast<FLOAT>(-1.0) * (ac * c);
+  if (d6 >= 0.0 && d5 <= d6) {
+    return {{k, 0u, 0u}, {1.0, 0.0, 0.0}, 1u, c * c};
+  }
+  FLOAT vb = d5 * d2 - d1 * d6;
+  if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+    return segment(simplex, i, k);
+  }
+  FLOAT va = d3 * d6 - d5 * d4;
+  if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0) {
+    return segment(simplex, j, k);
+  }
+  FLOAT denominator = va + vb + vc;
+  if (!(denominator > 0.0)) {
+    // degenerated to a line, the closest point is on one of the edges
+    Feature<FLOAT> best = segment(simplex, i, j);
+    for (const Feature<FLOAT> & edge : {segment(simplex, i, k), segment(simplex, j, k)}) {
+      if (edge.distance_squared < best.distance_squared) {
+        best = edge;
+      }
+    }
+    return best;
+  }
+  FLOAT v = vb / denominator;
+  FLOAT w = vc / denominator;
+  Vector<FLOAT, 3u> closest = a + v * ab + w * ac;
+  return {{i, j, k}, {static_cast<FLOAT>(1.0) - v - w, v, w}, 3u, closest * closest};
+}
+
+// reduces the simplex to the vertices spanning its closest point v to the origin
+// returns true iff the simplex is a tetrahedron containing the origin (then v is not changed)
+template <class FLOAT>
+bool closest(Simplex<FLOAT> & simplex, Vector<FLOAT, 3u> & v) {
+  Feature<FLOAT> feature;
+  if (simplex.count == 1u) {
+    feature = {{0u, 0u, 0u}, {1.0, 0.0, 0.0}, 1u, 0.0};
+  } else if (simplex.count == 2u) {
+    feature = segment(simplex, 0u, 1u);
+  } else if (simplex.count == 3u) {
+    feature = triangle(simplex, 0u, 1u, 2u);
+  } else {
+    // the closest of the faces whose plane separates the origin from the opposite vertex
+    // all faces of a flat tetrahedron are tested
+    static constexpr std::array<std::array<uint32_t, 4u>, 4u> FACES = {{{0u, 1u, 2u, 3u}, {0u, 2u, 3u, 1u},
+                                                                         {0u, 3u, 1u, 2u}, {1u, 3u, 2u, 0u}}};
+    const auto & w = simplex.vertices;
+    Vector<FLOAT, 3u> ab = w[1].w - w[0].w, ac = w[2].w - w[0].w, ad = w[3].w - w[0].w;
+    FLOAT volume = ab * ac.cross_product(ad);
+    bool flat = std::abs(volume) <= tolerance<FLOAT>() * ab.length() * ac.length() * ad.length();
+    feature.distance_squared = INFINITY;
+    for (const auto & face : FACES) {
+      Vector<FLOAT, 3u> a = w[face[0]].w;
+      Vector<FLOAT, 3u> normal = (w[face[1]].w - a).cross_product(w[face[2]].w - a);
+      if (flat || (static_cast<FLOAT>(-1.0) * (normal * a)) * (normal * (w[face[3]].w - a)) < 0.0) {
+        Feature<FLOAT> candidate = triangle(simplex, face[0], face[1], face[2]);
+        if (candidate.distance_squared < feature.distance_squared) {
+          feature = candidate;
+        }
+      }
+    }
+    if (feature.distance_squared == INFINITY) {
+      return true;
+    }
+  }
+  std::array<Vertex<FLOAT>, 3u> kept;
+  for (uint32_t i = 0; i < feature.count; i++) {
+    kept[i] = simplex.vertices[feature.kept[i]];
+  }
+  v = Vector<FLOAT, 3u>{};
+  for (uint32_t i = 0; i < feature.count; i++) {
+    simplex.vertices[i] = kept[i];
+    simplex.lambda[i] = feature.lambda[i];
+    v += feature.lambda[i] * kept[i].w;
+  }
+  simplex.count = feature.count;
+  return false;
+}
+
+// the square of the largest vertex of the simplex, the scale of the tolerances
+template <class FLOAT>
+FLOAT scale_squared(const Simplex<FLOAT> & simplex) {
+  FLOAT result = 0.0;
+  for (uint32_t i = 0; i < simplex.count; i++) {
+    result = std::max(result, simplex.vertices[i].w * simplex.vertices[i].w);
+  }
+  return result;
+}
+
+// true iff the closest point v of the simplex is the origin within the tolerance
+template <class FLOAT>
+bool touching(const Simplex<FLOAT> & simplex, const Vector<FLOAT, 3u> & v) {
+  return v * v <= tolerance<FLOAT>() * tolerance<FLOAT>() * scale_squared(simplex);
 }
 
+// GJK starting with the cached simplex, returns true iff the hulls intersect (or touch)
+// if separation_only, it stops at the first separating axis,
+// otherwise simplex spans the closest point of separated hulls when it returns false
+template <class FLOAT>
+bool run(const Pair<FLOAT> & pair, GJKCache<FLOAT> & cache, Simplex<FLOAT> & simplex, bool separation_only) {
+  auto finish = [&cache, &simplex](bool intersecting) {
+    cache.count = simplex.count;
+    for (uint32_t i = 0; i < simplex.count; i++) {
+      cache.simplex[i] = simplex.vertices[i].index;
+    }
+    return intersecting;
+  };
+  cache.iterations = 0u;
+  simplex.count = 0u;
+  for (uint32_t i = 0; i < std::min(cache.count, 4u); i++) {
+    if (cache.simplex[i][0] >= pair.shape1.size() || cache.simplex[i][1] >= pair.shape2.size()) {
+      simplex.count = 0u;  // the cache belongs to another pair
+      break;
+    }
+    simplex.vertices[simplex.count++] = pair.vertex(cache.simplex[i][0], cache.simplex[i][1]);
+  }
+  Vector<FLOAT, 3u> v = pair.center_difference();
+  FLOAT previous = INFINITY;
+  if (simplex.count > 0u) {
+    if (closest(simplex, v)) {
+      return finish(true);
+    }
+    previous = v * v;
+  }
+  if (v * v == 0.0) {
+    v = Vector<FLOAT, 3u>{1.0, 0.0, 0.0};
+  }
+  for (size_t iteration = 0; iteration < ConvexVertices<FLOAT>::MAX_ITERATIONS; iteration++) {
+    if (simplex.count > 0u && touching(simplex, v)) {
+      return finish(true);  // touching
+    }
+    Vertex<FLOAT> w = pair.support(static_cast<FLOAT>(-1.0) * v);
+    cache.iterations++;
+    FLOAT vw = v * w.w;
+    if (separation_only && vw > 0.0) {
+      return finish(false);  // v is a separating axis
+    }
+    bool known = false;
+    for (uint32_t i = 0; i < simplex.count; i++) {
+      known |= simplex.vertices[i].index == w.index;
+    }
+    if (simplex.count > 0u && (known || v * v - vw <= tolerance<FLOAT>() * (v * v))) {
+      return finish(touching(simplex, v));  // converged
+    }
+    simplex.vertices[simplex.count++] = w;
+    if (closest(simplex, v)) {
+      return finish(true);
+    }
+    FLOAT length_squared = v * v;
+    if (length_squared >= previous) {
+      // no progress due to rounding errors
+      return finish(touching(simplex, v));
+    }
+    previous = length_squared;
+  }
+  return finish(touching(simplex, v));
+}
+
+// a face of the EPA polytope with the outer unit normal and its distance to the origin
+template <class FLOAT>
+struct Face {
+  std::array<uint32_t, 3u> vertices;
+  Vector<FLOAT, 3u> normal;
+  FLOAT distance;
+};
+
+// returns false for a degenerated face
+template <class FLOAT>
+bool make_face(const std::vector<Vertex<FLOAT>> & vertices, uint32_t a, uint32_t b, uint32_t c, Face<FLOAT> & face) {
+  Vector<FLOAT, 3u> normal = (vertices[b].w - vertices[a].w).cross_product(vertices[c].w - vertices[a].w);
+  FLOAT length = normal.length();
+  if (!(length > 0.0)) {
+    return false;
+  }
+  face.vertices = {a, b, c};
+  face.normal = (static_cast<FLOAT>(1.0) / length) * normal;
+  face.distance = face.normal * vertices[a].w;
+  return true;
+}
+
+// extends the simplex of an intersecting (or touching) GJK run to a tetrahedron,
+// returns false if the Minkowski difference is flat
+template <class FLOAT>
+bool blow_up(const Pair<FLOAT> & pair, Simplex<FLOAT> & simplex, GJKCache<FLOAT> & cache) {
+  static const std::array<Vector<FLOAT, 3u>, 3u> AXES = {Vector<FLOAT, 3u>{1.0, 0.0, 0.0}, Vector<FLOAT, 3u>{0.0, 1.0, 0.0},
+                                                         Vector<FLOAT, 3u>{0.0, 0.0, 1.0}};
+  auto & w = simplex.vertices;
+  FLOAT epsilon = tolerance<FLOAT>() * std::max(scale_squared(simplex), std::numeric_limits<FLOAT>::min());
+  // tries the direction and its opposite, returns true iff the new vertex is accepted
+  auto extend = [&](const Vector<FLOAT, 3u> & direction, auto accept) {
+    for (FLOAT sign : {static_cast<FLOAT>(1.0), static_cast<FLOAT>(-1.0)}) {
+      Vertex<FLOAT> vertex = pair.support(sign * direction);
+      cache.iterations++;
+      if (accept(vertex.w)) {
+        w[simplex.count++] = vertex;
+        return true;
+      }
+    }
+    return false;
+  };
+  // degenerated simplices of touching hulls are reduced to their largest part first
+  if (simplex.count == 4u) {
+    FLOAT largest = 0.0;
+    uint32_t dropped = 3u;
+    for (uint32_t i = 0; i < 4u; i++) {
+      const auto & a = w[(i + 1u) % 4u].w;
+      FLOAT area = (w[(i + 2u) % 4u].w - a).cross_product(w[(i + 3u) % 4u].w - a).square_of_length();
+      if (area > largest) {
+        largest = area;
+        dropped = i;
+      }
+    }
+    Vector<FLOAT, 3u> normal = (w[(dropped + 2u) % 4u].w - w[(dropped + 1u) % 4u].w)
+                                   .cross_product(w[(dropped + 3u) % 4u].w - w[(dropped + 1u) % 4u].w);
+    if (std::abs(normal * (w[dropped].w - w[(dropped + 1u) % 4u].w))
+        <= tolerance<FLOAT>() * std::sqrt(largest * scale_squared(simplex))) {
+      w[dropped] = w[3];
+      simplex.count = 3u;
+    }
+  }
+  if (simplex.count == 3u && (w[1].w - w[0].w).cross_product(w[2].w - w[0].w).square_of_length() <= epsilon * epsilon) {
+    uint32_t dropped = 2u;
+    FLOAT longest = (w[1].w - w[0].w).square_of_length();
+    for (uint32_t i = 0; i < 2u; i++) {
+      FLOAT length = (w[2].w - w[i].w).square_of_length();
+      if (length > longest) {
+        longest = length;
+        dropped = 1u - i;
+      }
+    }
+    w[dropped] = w[2];
+    simplex.count = 2u;
+  }
+  if (simplex.count == 2u && (w[1].w - w[0].w).square_of_length() <= epsilon) {
+    simplex.count = 1u;
+  }
+  if (simplex.count == 1u) {
+    bool extended = false;
+    for (size_t i = 0; i < 3u && !extended; i++) {
+      extended = extend(AXES[i], [&](const Vector<FLOAT, 3u> & p) { return (p - w[0].w).square_of_length() > epsilon; });
+    }
+    if (!extended) {
+      return false;
+    }
+  }
+  if (simplex.count == 2u) {
+    Vector<FLOAT, 3u> d = w[1].w - w[0].w;
+    // the axis least parallel to the segment
+    size_t axis = 0u;
+    for (size_t i = 1; i < 3u; i++) {
+      if (std::abs(d[i]) < std::abs(d[axis])) {
+        axis = i;
+      }
+    }
+    Vector<FLOAT, 3u> e1 = d.cross_product(AXES[axis]);
+    Vector<FLOAT, 3u> e2 = d.cross_product(e1);
+    auto accept = [&](const Vector<FLOAT, 3u> & p) {
+      return d.cross_product(p - w[0].w).square_of_length() > epsilon * d.square_of_length();
+    };
+    if (!extend(e1, accept) && !extend(e2, accept)) {
+      return false;
+    }
+  }
+  if (simplex.count == 3u) {
+    Vector<FLOAT, 3u> normal = (w[1].w - w[0].w).cross_product(w[2].w - w[0].w);
+    FLOAT length = normal.length();
+    auto accept = [&](const Vector<FLOAT, 3u> & p) {
+      return std::abs(normal * (p - w[0].w)) > tolerance<FLOAT>() * length * std::sqrt(scale_squared(simplex));
+    };
+    if (!extend(normal, accept)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// EPA: expands the polytope inside the Minkowski difference towards its boundary face closest to the origin
+template <class FLOAT>
+ConvexContact<FLOAT> expand(const Pair<FLOAT> & pair, Simplex<FLOAT> & simplex, GJKCache<FLOAT> & cache) {
+  ConvexContact<FLOAT> contact;
+  contact.intersecting = true;
+  // a flat Minkowski difference, the hulls only touch
+  auto touching = [&pair, &simplex, &contact]() {
+    contact.distance = 0.0;
+    contact.normal = static_cast<FLOAT>(-1.0) * pair.center_difference();
+    FLOAT length = contact.normal.length();
+    contact.normal = length > 0.0 ? (static_cast<FLOAT>(1.0) / length) * contact.normal : Vector<FLOAT, 3u>{1.0, 0.0, 0.0};
+    contact.point1 = simplex.vertices[0].point1;
+    contact.point2 = simplex.vertices[0].point2;
+    return contact;
+  };
+  if (!blow_up(pair, simplex, cache)) {
+    return touching();
+  }
+  std::vector<Vertex<FLOAT>> vertices(simplex.vertices.begin(), simplex.vertices.end());
+  Vector<FLOAT, 3u> centroid = static_cast<FLOAT>(0.25) * (vertices[0].w + vertices[1].w + vertices[2].w + vertices[3].w);
+  std::vector<Face<FLOAT>> faces;
+  for (const auto & [a, b, c] : {std::array<uint32_t, 3u>{0u, 1u, 2u}, std::array<uint32_t, 3u>{0u, 3u, 1u},
+                                 std::array<uint32_t, 3u>{0u, 2u, 3u}, std::array<uint32_t, 3u>{1u, 3u, 2u}}) {
+    Face<FLOAT> face;
+    if (!make_face(vertices, a, b, c, face)) {
+      continue;
+    }
+    if (face.normal * (vertices[a].w - centroid) < 0.0) {
+      make_face(vertices, a, c, b, face);
+    }
+    faces.push_back(face);
+  }
+  if (faces.size() < 4u) {
+    return touching();
+  }
+  FLOAT scale = std::sqrt(scale_squared(simplex));
+  Face<FLOAT> best = faces[0];
+  std::vector<std::array<uint32_t, 2u>> horizon;
+  for (size_t iteration = 0; iteration < ConvexVertices<FLOAT>::MAX_ITERATIONS; iteration++) {
+    best = *std::min_element(faces.begin(), faces.end(),
+                             [](const Face<FLOAT> & f1, const Face<FLOAT> & f2) { return f1.distance < f2.distance; });
+    Vertex<FLOAT> w = pair.support(best.normal);
+    cache.iterations++;
+    bool known = false;
+    for (const auto & vertex : vertices) {
+      known |= vertex.index == w.index;
+    }
+    if (known || best.normal * w.w - best.distance <= tolerance<FLOAT>() * scale) {
+      break;
+    }
+    uint32_t added = static_cast<uint32_t>(vertices.size());
+    vertices.push_back(w);
+    // removes the faces seen from w, their edges without twin form the horizon
+    horizon.clear();
+    for (size_t i = 0; i < faces.size();) {
+      if (faces[i].normal * (w.w - vertices[faces[i].vertices[0]].w) > 0.0) {
+        for (size_t e = 0; e < 3u; e++) {
+          std::array<uint32_t, 2u> edge = {faces[i].vertices[e], faces[i].vertices[(e + 1u) % 3u]};
+          auto twin = std::find(horizon.begin(), horizon.end(), std::array<uint32_t, 2u>{edge[1], edge[0]});
+          if (twin != horizon.end()) {
+            horizon.erase(twin);
+          } else {
+            horizon.push_back(edge);
+          }
+        }
+        faces[i] = faces.back();
+        faces.pop_back();
+      } else {
+        i++;
+      }
+    }
+    bool degenerated = false;
+    for (const auto & edge : horizon) {
+      Face<FLOAT> face;
+      degenerated |= !make_face(vertices, edge[0], edge[1], added, face);
+      faces.push_back(face);
+    }
+    if (degenerated || faces.empty()) {
+      break;
+    }
+  }
+  // the barycentric coordinates of the projected origin on the closest face
+  const Vertex<FLOAT> & a = vertices[best.vertices[0]];
+  const Vertex<FLOAT> & b = vertices[best.vertices[1]];
+  const Vertex<FLOAT> & c = vertices[best.vertices[2]];
+  Vector<FLOAT, 3u> p = best.distance * best.normal;
+  Vector<FLOAT, 3u> v0 = b.w - a.w, v1 = c.w - a.w, v2 = p - a.w;
+  FLOAT d00 = v0 * v0, d01 = v0 * v1, d11 = v1 * v1, d20 = v2 * v0, d21 = v2 * v1;
+  FLOAT denominator = d00 * d11 - d01 * d01;
+  FLOAT u = 0.0, v = 0.0;
+  if (denominator > 0.0) {
+    u = (d11 * d20 - d01 * d21) / denominator;
+    v = (d00 * d21 - d01 * d20) / denominator;
+  }
+  FLOAT t = static_cast<FLOAT>(1.0) - u - v;
+  contact.distance = std::max(best.distance, static_cast<FLOAT>(0.0));
+  contact.normal = best.normal;
+  contact.point1 = t * a.point1 + u * b.point1 + v * c.point1;
+  contact.point2 = t * a.point2 + u * b.point2 + v * c.point2;
+  return contact;
+}
+
+}
+
+template <class FLOAT>
+bool ConvexVertices<FLOAT>::intersects(const Affine3<FLOAT> & transformation, const ConvexVertices<FLOAT> & other,
+                                       const Affine3<FLOAT> & other_transformation, GJKCache<FLOAT> & cache) const {
+  // the longest column of the linear part is the scaling factor (without shear)
+  auto scale = [](const Affine3<FLOAT> & t) {
+    const SquareMatrix<FLOAT, 3u> & linear = t.get_linear();
+    return std::sqrt(std::max({linear[0].square_of_length(), linear[1].square_of_length(), linear[2].square_of_length()}));
+  };
+  FLOAT radii = radius * scale(transformation) + other.radius * scale(other_transformation);
+  if ((transformation * center - other_transformation * other.center).square_of_length() > radii * radii) {
+    cache.iterations = 0u;
+    return false;
+  }
+  gjk::Pair<FLOAT> pair(*this, transformation, other, other_transformation);
+  gjk::Simplex<FLOAT> simplex;
+  return gjk::run(pair, cache, simplex, true);
+}
+
+template <class FLOAT>
+ConvexContact<FLOAT> ConvexVertices<FLOAT>::contact(const Affine3<FLOAT> & transformation, const ConvexVertices<FLOAT> & other,
+                                                    const Affine3<FLOAT> & other_transformation, GJKCache<FLOAT> & cache) const {
+  gjk::Pair<FLOAT> pair(*this, transformation, other, other_transformation);
+  gjk::Simplex<FLOAT> simplex;
+  if (gjk::run(pair, cache, simplex, false)) {
+    return gjk::expand(pair, simplex, cache);
+  }
+  ConvexContact<FLOAT> result;
+  result.intersecting = false;
+  Vector<FLOAT, 3u> v;
+  for (uint32_t i = 0; i < simplex.count; i++) {
+    v += simplex.lambda[i] * simplex.vertices[i].w;
+    result.point1 += simplex.lambda[i] * simplex.vertices[i].point1;
+    result.point2 += simplex.lambda[i] * simplex.vertices[i].point2;
+  }
+  result.distance = v.length();
+  result.normal = (static_cast<FLOAT>(-1.0) / result.distance) * v;
+  return result;
+}
+
+
+namespace bvh {
+
+// the half of the surface area of a box, proportional to the probability that a random ray hits the box
+// (the perimeter for N = 2)
+template <class FLOAT, size_t N>
+FLOAT half_area(const std::array<FLOAT, N> & min, const std::array<FLOAT, N> & max) {
+  if constexpr (N == 1u) {
+    return max[0] - min[0];
+  } else if constexpr (N == 2u) {
+    return (max[0] - min[0]) + (max[1] - min[1]);
+  } else {
+    FLOAT area = 0.0;
+    for (size_t i = 0; i < N; i++) {
+      for (size_t j = i + 1; j < N; j++) {
+        area += (max[i] - min[i]) * (max[j] - min[j]);
+      }
+    }
+    return area;
+  }
+}
+
+template <class FLOAT, size_t N>
+struct Bounds {
+  std::array<FLOAT, N> min, max;
+
+  Bounds() {
+    min.fill(std::numeric_limits<FLOAT>::infinity());
+    max.fill(-std::numeric_limits<FLOAT>::infinity());
+  }
+
+  void extend(const std::array<FLOAT, N> & min, const std::array<FLOAT, N> & max) {
+    for (size_t i = 0; i < N; i++) {
+      this->min[i] = std::min(this->min[i], min[i]);
+      this->max[i] = std::max(this->max[i], max[i]);
+    }
+  }
+
+  void extend(const Bounds & bounds) {
+    extend(bounds.min, bounds.max);
+  }
+};
+
+}
+
+template <template <class, size_t> class PRIMITIVE, class FLOAT, size_t N>
+BVH< PRIMITIVE<FLOAT, N> >::BVH(const std::vector< PRIMITIVE<FLOAT, N> > & primitives) {
+  assert(primitives.size() < std::numeric_limits<uint32_t>::max());
+  std::vector<Reference> references;
+  references.reserve(primitives.size());
+  for (size_t i = 0; i < primitives.size(); i++) {
+    AxisAlignedBoundingBox<FLOAT, N> box = primitives[i].bounding_box();
+    Vector<FLOAT, N> center = box.get_center();
+    Vector<FLOAT, N> half_edge_length = box.get_half_edge_length();
+    Reference reference;
+    for (size_t axis = 0; axis < N; axis++) {
+      reference.min[axis] = center[axis] - half_edge_length[axis];
+      reference.max[axis] = center[axis] + half_edge_length[axis];
+      reference.centroid[axis] = center[axis];
+    }
+    reference.primitive = static_cast<uint32_t>(i);
+    references.push_back(reference);
+  }
+
+  if (!references.empty()) {
+    nodes.reserve(2u * references.size());
+    build(references, 0u, references.size(), 0u);
+  }
+
+  this->primitives.reserve(primitives.size());
+  for (const auto & reference : references) {
+    this->primitives.push_back(primitives[reference.primitive]);
+  }
+}
+
+template <template <class, size_t> class PRIMITIVE, class FLOAT, size_t N>
+void BVH< PRIMITIVE<FLOAT, N> >::build(std::vector<Reference> & references, size_t begin, size_t end, size_t depth) {
+  size_t index = nodes.size();
+  nodes.push_back(Node{});
+
+  bvh::Bounds<FLOAT, N> bounds, centroids;
+  for (size_t i = begin; i < end; i++) {
+    bounds.extend(references[i].min, references[i].max);
+    centroids.extend(references[i].centroid, references[i].centroid);
+  }
+  nodes[index].min = bounds.min;
+  nodes[index].max = bounds.max;
+  size_t count = end - begin;
+
+  // the best border between the bins of all axes, split_bin is the last bin of the left child
+  FLOAT best_cost = std::numeric_limits<FLOAT>::infinity();
+  size_t best_axis = 0u;
+  size_t best_bin = 0u;
+  std::array<FLOAT, N> scale{};
+  for (size_t axis = 0; axis < N && count > 1u; axis++) {
+    FLOAT extent = centroids.max[axis] - centroids.min[axis];
+    if (extent <= 0.0) {
+      continue;
+    }
+    scale[axis] = static_cast<FLOAT>(BINS) * static_cast<FLOAT>(0.9999) / extent;
+
+    std::array<bvh::Bounds<FLOAT, N>, BINS> bins;
+    std::array<size_t, BINS> bin_counts{};
+    for (size_t i = begin; i < end; i++) {
+      size_t bin = std::min(BINS - 1u, static_cast<size_t>((references[i].centroid[axis] - centroids.min[axis]) * scale[axis]));
+      bins[bin].extend(references[i].min, references[i].max);
+      bin_counts[bin]++;
+    }
+
+    // right_costs[bin] is the cost of the bins bin + 1 ... BINS - 1
+    std::array<FLOAT, BINS> right_costs{};
+    bvh::Bounds<FLOAT, N> right;
+    size_t right_count = 0u;
+    for (size_t bin = BINS - 1u; bin > 0u; bin--) {
+      right.extend(bins[bin]);
+      right_count += bin_counts[bin];
+      right_costs[bin - 1u] = right_count > 0u ? bvh::half_area(right.min, right.max) * right_count : 0.0;
+    }
+
+    bvh::Bounds<FLOAT, N> left;
+    size_t left_count = 0u;
+    for (size_t bin = 0u; bin + 1u < BINS; bin++) {
+      left.extend(bins[bin]);
+      left_count += bin_counts[bin];
+      if (left_count == 0u || left_count == count) {
+        continue;
+      }
+      FLOAT cost = bvh::half_area(left.min, left.max) * left_count + right_costs[bin];
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_bin = bin;
+      }
+    }
+  }
+
+  // costs relative to one primitive intersection, traversing a node costs about the same
+  FLOAT area = bvh::half_area(bounds.min, bounds.max);
+  bool split_is_cheaper = best_cost < std::numeric_limits<FLOAT>::infinity()
+                          && area + best_cost < area * count;
+  if (count <= MAX_LEAF_SIZE && (!split_is_cheaper || depth + 1u >= MAX_DEPTH)) {
+    nodes[index].index = static_cast<uint32_t>(begin);
+    nodes[index].count = static_cast<uint16_t>(count);
+    return;
+  }
+
+  size_t middle;
+  if (best_cost < std::numeric_limits<FLOAT>::infinity() && depth < MAX_DEPTH / 2u) {
+    auto first = references.begin();
+    middle = std::partition(first + begin, first + end, [&](const Reference & reference) {
+      return std::min(BINS - 1u, static_cast<size_t>((reference.centroid[best_axis] - centroids.min[best_axis]) * scale[best_axis])) <= best_bin;
+    }) - first;
+  } else {
+    // equal centroids or a deep (unbalanced) hierarchy: the median split limits the depth to MAX_DEPTH
+    size_t axis = 0u;
+    for (size_t i = 1; i < N; i++) {
+      if (centroids.max[i] - centroids.min[i] > centroids.max[axis] - centroids.min[axis]) {
+        axis = i;
+      }
+    }
+    best_axis = axis;
+    middle = begin + count / 2u;
+    auto first = references.begin();
+    std::nth_element(first + begin, first + middle, first + end, [axis](const Reference & r1, const Reference & r2) {
+      return r1.centroid[axis] < r2.centroid[axis];
+    });
+  }
+
+  nodes[index].axis = static_cast<uint16_t>(best_axis);
+  nodes[index].count = 0u;
+  build(references, begin, middle, depth + 1u);
+  nodes[index].index = static_cast<uint32_t>(nodes.size());
+  build(references, middle, end, depth + 1u);
+}
+
+template <template <class, size_t> class PRIMITIVE, class FLOAT, size_t N>
+bool BVH< PRIMITIVE<FLOAT, N> >::enters(const Node & node, const PreparedRay<FLOAT, N> & ray, FLOAT t_max) {
+  auto [t_near, t_far] = slab::interval(node.min.data(), node.max.data(), ray, static_cast<FLOAT>(0.0), t_max);
+  return t_near <= t_far;
+}
+
+template <template <class, size_t> class PRIMITIVE, class FLOAT, size_t N>
+const PRIMITIVE<FLOAT, N> * BVH< PRIMITIVE<FLOAT, N> >::closest_hit(const Ray<FLOAT, N> &ray, Intersection_Context<FLOAT, N> & context) const {
+  const PRIMITIVE<FLOAT, N> * closest = nullptr;
+  if (nodes.empty()) {
+    return closest;
+  }
+  PreparedRay<FLOAT, N> prepared(ray);
+
+  FLOAT t_closest = INFINITY;
+  Intersection_Context<FLOAT, N> candidate;
+  std::array<uint32_t, MAX_DEPTH> stack;
+  size_t stack_size = 0u;
+  uint32_t current = 0u;
+  while (true) {
+    const Node & node = nodes[current];
+    if (enters(node, prepared, t_closest)) {
+      if (node.count == 0u) {
+        // visit the child on the side of the ray origin first, the other one is probably pruned by t_closest
+        bool right_first = (prepared.sign_bits >> node.axis) & 1u;
+        stack[stack_size++] = right_first ? current + 1u : node.index;
+        current = right_first ? node.index : current + 1u;
+        continue;
+      }
+      for (size_t i = node.index; i < node.index + node.count; i++) {
+        if (primitives[i].intersects(ray, candidate) && candidate.t < t_closest) {
+          t_closest = candidate.t;
+          context = candidate;
+          closest = &primitives[i];
+        }
+      }
+    }
+    if (stack_size == 0u) {
+      return closest;
+    }
+    current = stack[--stack_size];
+  }
+}
+
+template <template <class, size_t> class PRIMITIVE, class FLOAT, size_t N>
+bool BVH< PRIMITIVE<FLOAT, N> >::any_hit(const Ray<FLOAT, N> &ray, FLOAT t_max) const {
+  if (nodes.empty()) {
+    return false;
+  }
+  PreparedRay<FLOAT, N> prepared(ray);
+
+  Intersection_Context<FLOAT, N> candidate;
+  std::array<uint32_t, MAX_DEPTH> stack;
+  size_t stack_size = 0u;
+  uint32_t current = 0u;
+  while (true) {
+    const Node & node = nodes[current];
+    if (enters(node, prepared, t_max)) {
+      if (node.count == 0u) {
+        stack[stack_size++] = node.index;
+        current++;
+        continue;
+      }
+      for (size_t i = node.index; i < node.index + node.count; i++) {
+        if (primitives[i].intersects(ray, candidate) && candidate.t < t_max) {
+          return true;
+        }
+      }
+    }
+    if (stack_size == 0u) {
+      return false;
+    }
+    current = stack[--stack_size];
+  }
+}
+
+template <template <class, size_t> class PRIMITIVE, class FLOAT, size_t N>
+const std::vector< PRIMITIVE<FLOAT, N> > & BVH< PRIMITIVE<FLOAT, N> >::get_primitives() const {
+  return primitives;
+}
+
+template <template <class, size_t> class PRIMITIVE, class FLOAT, size_t N>
+const std::vector<typename BVH< PRIMITIVE<FLOAT, N> >::Node> & BVH< PRIMITIVE<FLOAT, N> >::get_nodes() const {
+  return nodes;
+}
+
+
+
+template <class FLOAT>
+SignedDistanceField<FLOAT>::SignedDistanceField(const std::vector< Triangle<FLOAT, 3u> > & triangles, FLOAT cell_size,
+                                                FLOAT band, unsigned threads)
+  : cell_size(cell_size), band(std::max(band, cell_size)) {
+  if (triangles.empty()) {
+    return;
+  }
+  band = this->band;
+  std::vector< std::array<Vector<FLOAT, 3u>, 2u> > boxes;
+  Vector<FLOAT, 3u> min = {INFINITY, INFINITY, INFINITY}, max = {-INFINITY, -INFINITY, -INFINITY};
+  for (const auto & triangle : triangles) {
+    AxisAlignedBoundingBox<FLOAT, 3u> box = triangle.bounding_box();
+    boxes.push_back({box.get_center() - box.get_half_edge_length(), box.get_center() + box.get_half_edge_length()});
+    for (size_t i = 0; i < 3u; i++) {
+      min[i] = std::min(min[i], boxes.back()[0][i]);
+      max[i] = std::max(max[i], boxes.back()[1][i]);
+    }
+  }
+  // the grid covers the bounding box and a margin of band and one cell, the grid points on its border are outside
+  FLOAT margin = band + cell_size;
+  std::array<size_t, 3u> points;
+  for (size_t i = 0; i < 3u; i++) {
+    origin[i] = min[i] - margin;
+    size_t cells = static_cast<size_t>(std::ceil((max[i] - min[i] + 2.0 * margin) / cell_size));
+    bricks[i] = static_cast<uint32_t>(std::max<size_t>((cells + BRICK - 1u) / BRICK, 1u));
+    points[i] = bricks[i] * BRICK + 1u;
+  }
+  size_t brick_count = static_cast<size_t>(bricks[0]) * bricks[1] * bricks[2];
+  auto brick_position = [this](size_t brick) {
+    return std::array<size_t, 3u>{brick % bricks[0], brick / bricks[0] % bricks[1], brick / bricks[0] / bricks[1]};
+  };
+
+  // the unsigned distances of the bricks near the surface, the triangles are culled by their boxes
+  // the bricks are visited with a stride, which spreads the bricks near the surface over the threads
+  size_t stride = brick_count % 7919u == 0u ? 7907u : 7919u;
+  std::vector< std::vector<FLOAT> > brick_distances(brick_count);
+  blocked::parallel_for(brick_count, 1u, [&](size_t first, size_t last) {
+    std::vector<size_t> candidates;
+    for (size_t i = first; i < last; i++) {
+      size_t brick = i * stride % brick_count;
+      std::array<size_t, 3u> position = brick_position(brick);
+      Vector<FLOAT, 3u> low, high;
+      for (size_t axis = 0; axis < 3u; axis++) {
+        low[axis] = origin[axis] + static_cast<FLOAT>(position[axis] * BRICK) * cell_size;
+        high[axis] = low[axis] + static_cast<FLOAT>(BRICK) * cell_size;
+      }
+      candidates.clear();
+      for (size_t t = 0; t < triangles.size(); t++) {
+        bool overlaps = true;
+        for (size_t axis = 0; axis < 3u; axis++) {
+          overlaps &= boxes[t][0][axis] <= high[axis] + band && boxes[t][1][axis] >= low[axis] - band;
+        }
+        if (overlaps) {
+          candidates.push_back(t);
+        }
+      }
+      if (candidates.empty()) {
+        continue;
+      }
+      // the squared distances, each triangle updates only the points within band of its box
+      std::vector<FLOAT> distances(BRICK_POINTS, band * band);
+      for (size_t t : candidates) {
+        std::array<size_t, 3u> first_point, last_point;
+        for (size_t axis = 0; axis < 3u; axis++) {
+          FLOAT first = std::ceil((boxes[t][0][axis] - band - low[axis]) / cell_size);
+          FLOAT last = std::floor((boxes[t][1][axis] + band - low[axis]) / cell_size);
+          first_point[axis] = static_cast<size_t>(std::max(first, static_cast<FLOAT>(0.0)));
+          last_point[axis] = static_cast<size_t>(std::min(last, static_cast<FLOAT>(BRICK)));
+        }
+        for (size_t z = first_point[2]; z <= last_point[2]; z++) {
+          for (size_t y = first_point[1]; y <= last_point[1]; y++) {
+            for (size_t x = first_point[0]; x <= last_point[0]; x++) {
+              Vector<FLOAT, 3u> point = low + cell_size * Vector<FLOAT, 3u>{static_cast<FLOAT>(x), static_cast<FLOAT>(y),
+                                                                            static_cast<FLOAT>(z)};
+              FLOAT & distance = distances[(z * (BRICK + 1u) + y) * (BRICK + 1u) + x];
+              distance = std::min(distance, (triangles[t].closest_point(point) - point).square_of_length());
+            }
+          }
+        }
+      }
+      bool near = false;
+      for (FLOAT & distance : distances) {
+        near |= distance < band * band;
+        distance = std::sqrt(distance);
+      }
+      if (near) {
+        brick_distances[brick] = std::move(distances);
+      }
+    }
+  }, threads);
+
+  // votes[point] is the number of rows through point with an odd number of intersections before it
+  std::vector<uint8_t> votes(points[0] * points[1] * points[2], 0u);
+  BVH< Triangle<FLOAT, 3u> > bvh(triangles);
+  const FLOAT epsilon = static_cast<FLOAT>(0.001) * cell_size;
+  for (size_t axis = 0; axis < 3u; axis++) {
+    size_t u = (axis + 1u) % 3u;
+    size_t v = (axis + 2u) % 3u;
+    blocked::parallel_for(points[u] * points[v], 64u, [&](size_t first, size_t last) {
+      std::vector<FLOAT> crossings;
+      for (size_t row = first; row < last; row++) {
+        std::array<size_t, 3u> index;
+        index[u] = row % points[u];
+        index[v] = row / points[u];
+        index[axis] = 0u;
+        // the rays start one cell before the first grid point of the row, equal intersections of neighbouring
+        // triangles are counted once, the rows are moved slightly off the grid lines, which would graze
+        // the faces and edges of meshes aligned with the grid
+        Ray<FLOAT, 3u> ray;
+        for (size_t i = 0; i < 3u; i++) {
+          ray.origin[i] = origin[i] + static_cast<FLOAT>(index[i]) * cell_size;
+          ray.direction[i] = i == axis ? 1.0 : 0.0;
+        }
+        ray.origin[axis] -= cell_size;
+        ray.origin[u] += static_cast<FLOAT>(0.00137) * cell_size;
+        ray.origin[v] += static_cast<FLOAT>(0.00071) * cell_size;
+        Vector<FLOAT, 3u> start = ray.origin;
+        crossings.clear();
+        FLOAT offset = 0.0;
+        Intersection_Context<FLOAT, 3u> context;
+        for (size_t i = 0; i < triangles.size() && bvh.closest_hit(ray, context) != nullptr; i++) {
+          offset += context.t;
+          crossings.push_back(offset);
+          offset += epsilon;
+          ray.origin = start + offset * ray.direction;
+        }
+        size_t crossed = 0u;
+        for (size_t i = 0; i < points[axis]; i++) {
+          FLOAT s = static_cast<FLOAT>(i + 1u) * cell_size;
+          while (crossed < crossings.size() && crossings[crossed] < s) {
+            crossed++;
+          }
+          index[axis] = i;
+          votes[(index[2] * points[1] + index[1]) * points[0] + index[0]] += crossed % 2u;
+        }
+      }
+    }, threads);
+  }
+
+  brick_table.assign(brick_count, OUTSIDE);
+  for (size_t brick = 0; brick < brick_count; brick++) {
+    std::array<size_t, 3u> position = brick_position(brick);
+    size_t first = ((position[2] * points[1] + position[1]) * points[0] + position[0]) * BRICK;
+    size_t inside = 0u;
+    if (!brick_distances[brick].empty()) {
+      brick_table[brick] = static_cast<uint32_t>(values.size() / BRICK_POINTS);
+    }
+    for (size_t z = 0, index = 0; z <= BRICK; z++) {
+      for (size_t y = 0; y <= BRICK; y++) {
+        for (size_t x = 0; x <= BRICK; x++, index++) {
+          bool point_inside = votes[first + (z * points[1] + y) * points[0] + x] >= 2u;
+          inside += point_inside;
+          if (!brick_distances[brick].empty()) {
+            values.push_back(point_inside ? -brick_distances[brick][index] : brick_distances[brick][index]);
+          }
+        }
+      }
+    }
+    if (brick_distances[brick].empty() && 2u * inside > BRICK_POINTS) {
+      brick_table[brick] = INSIDE;
+    }
+  }
+}
+
+template <class FLOAT>
+FLOAT SignedDistanceField<FLOAT>::distance(const Vector<FLOAT, 3u> & point) const {
+  if (brick_table.empty()) {
+    return band;
+  }
+  std::array<size_t, 3u> cell;
+  std::array<FLOAT, 3u> fraction;
+  for (size_t i = 0; i < 3u; i++) {
+    FLOAT p = (point[i] - origin[i]) / cell_size;
+    size_t cells = bricks[i] * BRICK;
+    if (!(p >= 0.0 && p < static_cast<FLOAT>(cells))) {
+      return band;  // NaN, too
+    }
+    cell[i] = std::min(static_cast<size_t>(p), cells - 1u);
+    fraction[i] = p - static_cast<FLOAT>(cell[i]);
+  }
+  uint32_t entry = brick_table[((cell[2] / BRICK) * bricks[1] + cell[1] / BRICK) * bricks[0] + cell[0] / BRICK];
+  if (entry == OUTSIDE) {
+    return band;
+  }
+  if (entry == INSIDE) {
+    return -band;
+  }
+  constexpr size_t Y = BRICK + 1u;
+  constexpr size_t Z = Y * Y;
+  const FLOAT * p = values.data() + entry * BRICK_POINTS
+                    + ((cell[2] % BRICK) * Y + cell[1] % BRICK) * Y + cell[0] % BRICK;
+  FLOAT x00 = p[0] + fraction[0] * (p[1] - p[0]);
+  FLOAT x10 = p[Y] + fraction[0] * (p[Y + 1u] - p[Y]);
+  FLOAT x01 = p[Z] + fraction[0] * (p[Z + 1u] - p[Z]);
+  FLOAT x11 = p[Z + Y] + fraction[0] * (p[Z + Y + 1u] - p[Z + Y]);
+  FLOAT y0 = x00 + fraction[1] * (x10 - x00);
+  FLOAT y1 = x01 + fraction[1] * (x11 - x01);
+  return y0 + fraction[2] * (y1 - y0);
+}
+
+template <class FLOAT>
+bool SignedDistanceField<FLOAT>::intersects(const Sphere<FLOAT, 3u> & sphere) const {
+  AxisAlignedBoundingBox<FLOAT, 3u> box = sphere.bounding_box();
+  return distance(box.get_center()) <= box.get_half_edge_length()[0];
+}
+
+template <class FLOAT>
+FLOAT SignedDistanceField<FLOAT>::get_cell_size() const {
+  return cell_size;
+}
+
+template <class FLOAT>
+FLOAT SignedDistanceField<FLOAT>::get_band() const {
+  return band;
+}
+
+template <class FLOAT>
+size_t SignedDistanceField<FLOAT>::stored_bricks() const {
+  return values.size() / BRICK_POINTS;
+}
+
+namespace sdf {
+
+// the file starts with MAGIC, the size of FLOAT, and BRICK
+inline constexpr std::array<char, 4u> MAGIC = {'S', 'D', 'F', '1'};
+
+template <class T>
+void write(std::ostream & out, const T * data, size_t count) {
+  out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(sizeof(T) * count));
+}
+
+template <class T>
+bool read(std::istream & in, T * data, size_t count) {
+  in.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(sizeof(T) * count));
+  return static_cast<bool>(in);
+}
+
+// reads count values in chunks, so a corrupt count fails at the end of the stream
+// instead of allocating its size up front
+template <class T>
+bool read(std::istream & in, std::vector<T> & data, uint64_t count) {
+  constexpr uint64_t CHUNK = 65536u;
+  data.clear();
+  while (data.size() < count) {
+    size_t size = data.size(),
+           chunk = static_cast<size_t>(std::min(CHUNK, count - size));
+    data.resize(size + chunk);
+    if (!read(in, data.data() + size, chunk)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+template <class FLOAT>
+bool SignedDistanceField<FLOAT>::save(std::ostream & out) const {
+  const std::array<uint32_t, 2u> sizes = {static_cast<uint32_t>(sizeof(FLOAT)), static_cast<uint32_t>(BRICK)};
+  const std::array<FLOAT, 5u> grid = {origin[0], origin[1], origin[2], cell_size, band};
+  const uint64_t value_count = values.size();
+  sdf::write(out, sdf::MAGIC.data(), sdf::MAGIC.size());
+  sdf::write(out, sizes.data(), sizes.size());
+  sdf::write(out, grid.data(), grid.size());
+  sdf::write(out, bricks.data(), bricks.size());
+  sdf::write(out, &value_count, 1u);
+  sdf::write(out, brick_table.data(), brick_table.size());
+  sdf::write(out, values.data(), values.size());
+  return static_cast<bool>(out);
+}
+
+template <class FLOAT>
+bool SignedDistanceField<FLOAT>::load(std::istream & in) {
+  std::array<char, 4u> magic;
+  std::array<uint32_t, 2u> sizes;
+  std::array<FLOAT, 5u> grid;
+  std::array<uint32_t, 3u> brick_counts;
+  uint64_t value_count;
+  if (!sdf::read(in, magic.data(), magic.size()) || magic != sdf::MAGIC
+      || !sdf::read(in, sizes.data(), sizes.size()) || sizes[0] != sizeof(FLOAT) || sizes[1] != BRICK
+      || !sdf::read(in, grid.data(), grid.size()) || !(grid[3] > 0.0) || !(grid[4] >= 0.0)
+      || !sdf::read(in, brick_counts.data(), brick_counts.size()) || !sdf::read(in, &value_count, 1u)
+      || value_count % BRICK_POINTS != 0u) {
+    return false;
+  }
+  uint64_t brick_count = static_cast<uint64_t>(brick_counts[0]) * brick_counts[1];
+  if (brick_counts[2] != 0u && brick_count > std::numeric_limits<uint64_t>::max() / brick_counts[2]) {
+    return false;
+  }
+  brick_count *= brick_counts[2];
+  std::vector<uint32_t> table;
+  std::vector<FLOAT> data;
+  if (!sdf::read(in, table, brick_count) || !sdf::read(in, data, value_count)) {
+    return false;
+  }
+  for (uint32_t entry : table) {
+    if (entry != INSIDE && entry != OUTSIDE && entry >= value_count / BRICK_POINTS) {
+      return false;
+    }
+  }
+  origin = {grid[0], grid[1], grid[2]};
+  cell_size = grid[3];
+  band = grid[4];
+  bricks = brick_counts;
+  brick_table = std::move(table);
+  values = std::move(data);
+  return true;
+}
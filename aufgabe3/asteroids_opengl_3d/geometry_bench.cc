@@ -0,0 +1,611 @@
+#include "geometry.h"
+#include "wavefront.h"
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+// compares the linear scan over all triangles of teapot.obj (about 6k triangles)
+// with the bounding volume hierarchy BVH: build time, closest hit, and any hit (shadow rays)
+// and the watertight ray/triangle intersection with the former method based on cross products,
+// the precomputed triangles, and blocks of 4 and 8 precomputed triangles tested at once
+// and the primary rays of a camera traced one by one and as packets of 4 and 8 rays
+// and the slab test with divisions per box with the one of a PreparedRay
+// and the bounding sphere test of persistent pairs of asteroid.obj and spaceship.obj with GJK (cold and warm started)
+// and with the contact (distance or penetration depth by EPA)
+// and the signed distance field of the teapot: baking (one thread and all threads), loading a baked field,
+// and point queries compared with the closest points of all triangles
+// and the bounds (smallest sphere, aabb, oriented box) of the vertices of asteroid.obj, spaceship.obj and teapot.obj
+
+#ifndef TEAPOT_FILE
+#define TEAPOT_FILE "teapot.obj"
+#endif
+
+#ifndef ASTEROID_FILE
+#define ASTEROID_FILE "asteroid.obj"
+#endif
+
+#ifndef SPACESHIP_FILE
+#define SPACESHIP_FILE "spaceship.obj"
+#endif
+
+namespace {
+
+constexpr size_t NO_OF_RAYS = 1024u;
+
+// the faces are triangulated as fans around their first point
+const std::vector<Triangle3df> & teapot() {
+  static std::vector<Triangle3df> triangles = [] {
+    std::vector<Triangle3df> triangles;
+    std::ifstream in(TEAPOT_FILE);
+    WavefrontImporter importer(in);
+    importer.parse();
+    for (const auto & face : importer.get_faces()) {
+      const auto & groups = face.reference_groups;
+      for (size_t i = 2; i < groups.size(); i++) {
+        const ReferenceGroup * points[3] = { &groups[0], &groups[i - 1], &groups[i] };
+        Vector3df p[3], n[3];
+        for (size_t k = 0; k < 3u; k++) {
+          p[k] = {points[k]->vertice[0], points[k]->vertice[1], points[k]->vertice[2]};
+          n[k] = {points[k]->normal[0], points[k]->normal[1], points[k]->normal[2]};
+        }
+        triangles.push_back( Triangle3df(p[0], p[1], p[2], n[0], n[1], n[2]) );
+      }
+    }
+    return triangles;
+  }();
+  return triangles;
+}
+
+// rays from a sphere around the teapot to random points of its bounding box
+std::vector<Ray3df> create_rays(const std::vector<Triangle3df> & triangles) {
+  Vector3df min = {INFINITY, INFINITY, INFINITY};
+  Vector3df max = {-INFINITY, -INFINITY, -INFINITY};
+  for (const auto & triangle : triangles) {
+    AABB3df box = triangle.bounding_box();
+    for (size_t axis = 0; axis < 3u; axis++) {
+      min[axis] = std::min(min[axis], box.get_center()[axis] - box.get_half_edge_length()[axis]);
+      max[axis] = std::max(max[axis], box.get_center()[axis] + box.get_half_edge_length()[axis]);
+    }
+  }
+  Vector3df center = 0.5f * (min + max);
+  float distance = 2.0f * (max - min).length();
+
+  std::mt19937 generator(42u);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::normal_distribution<float> normal;
+  std::vector<Ray3df> rays;
+  for (size_t i = 0; i < NO_OF_RAYS; i++) {
+    Vector3df direction = {normal(generator), normal(generator), normal(generator)};
+    direction.normalize();
+    Vector3df target;
+    for (size_t axis = 0; axis < 3u; axis++) {
+      target[axis] = min[axis] + unit(generator) * (max[axis] - min[axis]);
+    }
+    Vector3df origin = center + distance * direction;
+    rays.push_back( Ray3df{ origin, target - origin } );
+  }
+  return rays;
+}
+
+// the former Triangle::intersects: normal, area, and three edge tests with cross products and square roots
+struct CrossProductTriangle : public Triangle3df {
+  using Triangle3df::Triangle3df;
+
+  bool intersects(const Ray3df &ray, Intersection_Context<float, 3u> & context) const {
+    const float EPSILON = 10e-7;
+    context.normal = (b - a).cross_product(c - a);
+    float normal_ray_product = context.normal * ray.direction;
+    float area = context.normal.length();
+    if (std::fabs(normal_ray_product) < EPSILON) {
+      return false;
+    }
+    context.t = (context.normal * a - context.normal * ray.origin) / normal_ray_product;
+    if (context.t < 0.0f) {
+      return false;
+    }
+    Vector3df p = ray.origin + context.t * ray.direction;
+    context.intersection = p;
+    Vector3df vector = (b - a).cross_product(p - a);
+    if (context.normal * vector < 0.0f) {
+      return false;
+    }
+    vector = (c - b).cross_product(p - b);
+    if (context.normal * vector < 0.0f) {
+      return false;
+    }
+    context.u = vector.length() / area;
+    vector = (a - c).cross_product(p - c);
+    if (context.normal * vector < 0.0f) {
+      return false;
+    }
+    context.v = vector.length() / area;
+    return true;
+  }
+};
+
+// one ray per triangle through a point near the triangle, about a quarter of them hit
+struct TriangleTests {
+  std::vector<Vector3df> points;  // a, b, c of each triangle
+  std::vector<Ray3df> rays;
+
+  TriangleTests() {
+    std::mt19937 generator(7u);
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    for (size_t i = 0; i < NO_OF_RAYS; i++) {
+      Vector3df a = {coordinate(generator), coordinate(generator), coordinate(generator)};
+      Vector3df b = {coordinate(generator), coordinate(generator), coordinate(generator)};
+      Vector3df c = {coordinate(generator), coordinate(generator), coordinate(generator)};
+      points.insert(points.end(), {a, b, c});
+      Vector3df origin = {5.0f * coordinate(generator), 5.0f * coordinate(generator), 5.0f};
+      Vector3df target = 0.333f * (a + b + c) + 0.5f * Vector3df{coordinate(generator), coordinate(generator), coordinate(generator)};
+      rays.push_back( Ray3df{ origin, target - origin } );
+    }
+  }
+
+  template <class TRIANGLE>
+  std::vector<TRIANGLE> triangles() const {
+    std::vector<TRIANGLE> triangles;
+    for (size_t i = 0; i < points.size(); i += 3u) {
+      triangles.push_back( TRIANGLE(points[i], points[i + 1u], points[i + 2u]) );
+    }
+    return triangles;
+  }
+};
+
+template <class TRIANGLE>
+void BM_TriangleIntersection(benchmark::State & state) {
+  TriangleTests tests;
+  auto triangles = tests.triangles<TRIANGLE>();
+  Intersection_Context<float, 3u> context{};
+  size_t hits = 0u;
+  for (auto _ : state) {
+    for (size_t i = 0; i < NO_OF_RAYS; i++) {
+      hits += triangles[i].intersects(tests.rays[i], context);
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.counters["hit_rate"] = static_cast<double>(hits) / (state.iterations() * NO_OF_RAYS);
+  state.SetItemsProcessed(state.iterations() * NO_OF_RAYS);
+}
+
+// the rays of the triangles of a block are tested against all triangles of the block
+template <size_t WIDTH>
+void BM_TriangleBlock(benchmark::State & state) {
+  TriangleTests tests;
+  auto triangles = tests.triangles<PrecomputedTriangle3df>();
+  std::vector< TriangleBlock<float, 3u, WIDTH> > blocks;
+  for (size_t i = 0; i < NO_OF_RAYS; i += WIDTH) {
+    blocks.push_back( TriangleBlock<float, 3u, WIDTH>(std::span(triangles).subspan(i, WIDTH)) );
+  }
+  Intersection_Context<float, 3u> context{};
+  size_t hits = 0u;
+  for (auto _ : state) {
+    for (size_t i = 0; i < NO_OF_RAYS; i++) {
+      hits += blocks[i / WIDTH].intersects(tests.rays[i], context) < WIDTH;
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_RAYS * WIDTH);
+}
+
+// the same triangle tests as BM_TriangleBlock, one triangle after another
+template <size_t WIDTH>
+void BM_TriangleBlockLoop(benchmark::State & state) {
+  TriangleTests tests;
+  auto triangles = tests.triangles<PrecomputedTriangle3df>();
+  Intersection_Context<float, 3u> context{}, candidate{};
+  size_t hits = 0u;
+  for (auto _ : state) {
+    for (size_t i = 0; i < NO_OF_RAYS; i++) {
+      size_t first = i / WIDTH * WIDTH;
+      context.t = INFINITY;
+      for (size_t k = first; k < first + WIDTH; k++) {
+        if (triangles[k].intersects(tests.rays[i], candidate) && candidate.t < context.t) {
+          context = candidate;
+        }
+      }
+      hits += context.t < INFINITY;
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_RAYS * WIDTH);
+}
+
+// the former AxisAlignedBoundingBox::intersects(Ray): two divisions and min/max per axis
+bool division_slab_test(const AABB3df & box, const Ray3df & ray) {
+  float t_near = -INFINITY;
+  float t_far = INFINITY;
+  for (size_t i = 0; i < 3u; i++) {
+    float t0 = (box.get_center()[i] - ray.origin[i] - box.get_half_edge_length()[i]) / ray.direction[i];
+    float t1 = (box.get_center()[i] - ray.origin[i] + box.get_half_edge_length()[i]) / ray.direction[i];
+    t_near = std::max(t_near, std::min(t0, t1));
+    t_far = std::min(t_far, std::max(t0, t1));
+  }
+  return t_far >= t_near;
+}
+
+// the rays against the bounding boxes of the first SLAB_BOXES triangles of the teapot
+constexpr size_t SLAB_BOXES = 256u;
+
+void BM_SlabTestDivision(benchmark::State & state) {
+  std::vector<AABB3df> boxes;
+  for (size_t i = 0; i < SLAB_BOXES; i++) {
+    boxes.push_back( teapot()[i].bounding_box() );
+  }
+  auto rays = create_rays(teapot());
+  size_t hits = 0u;
+  for (auto _ : state) {
+    for (const auto & ray : rays) {
+      for (const auto & box : boxes) {
+        hits += division_slab_test(box, ray);
+      }
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_RAYS * SLAB_BOXES);
+}
+
+void BM_SlabTestPreparedRay(benchmark::State & state) {
+  std::vector<AABB3df> boxes;
+  for (size_t i = 0; i < SLAB_BOXES; i++) {
+    boxes.push_back( teapot()[i].bounding_box() );
+  }
+  auto rays = create_rays(teapot());
+  size_t hits = 0u;
+  for (auto _ : state) {
+    for (const auto & ray : rays) {
+      PreparedRay3df prepared(ray);
+      for (const auto & box : boxes) {
+        auto [t_near, t_far] = box.slab_interval(prepared);
+        hits += t_far >= t_near;
+      }
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_RAYS * SLAB_BOXES);
+}
+
+void BM_BVHBuild(benchmark::State & state) {
+  const auto & triangles = teapot();
+  for (auto _ : state) {
+    TriangleBVH3df bvh(triangles);
+    benchmark::DoNotOptimize(bvh.get_nodes().data());
+  }
+  state.SetItemsProcessed(state.iterations() * triangles.size());
+}
+
+void BM_ClosestHitLinearScan(benchmark::State & state) {
+  const auto & triangles = teapot();
+  auto rays = create_rays(triangles);
+  Intersection_Context<float, 3u> context{}, candidate{};
+  for (auto _ : state) {
+    for (const auto & ray : rays) {
+      context.t = INFINITY;
+      for (const auto & triangle : triangles) {
+        if (triangle.intersects(ray, candidate) && candidate.t < context.t) {
+          context = candidate;
+        }
+      }
+      benchmark::DoNotOptimize(context);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_RAYS);
+}
+
+template <class TRIANGLE>
+void BM_ClosestHitBVH(benchmark::State & state) {
+  std::vector<TRIANGLE> triangles(teapot().begin(), teapot().end());
+  BVH<TRIANGLE> bvh(triangles);
+  auto rays = create_rays(teapot());
+  Intersection_Context<float, 3u> context{};
+  for (auto _ : state) {
+    for (const auto & ray : rays) {
+      benchmark::DoNotOptimize(bvh.closest_hit(ray, context));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_RAYS);
+}
+
+void BM_AnyHitBVH(benchmark::State & state) {
+  TriangleBVH3df bvh(teapot());
+  auto rays = create_rays(teapot());
+  for (auto _ : state) {
+    for (const auto & ray : rays) {
+      benchmark::DoNotOptimize(bvh.any_hit(ray));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_RAYS);
+}
+
+// the primary rays of a 128 x 128 pixel camera at (0, 0, 20) looking at the square [-10, 10]^2 of the x/y plane
+constexpr size_t IMAGE_SIZE = 128u;
+
+Ray3df primary_ray(size_t x, size_t y) {
+  Vector3df eye = {0.0f, 0.0f, 20.0f};
+  Vector3df pixel = {-10.0f + 20.0f * (x + 0.5f) / IMAGE_SIZE, 10.0f - 20.0f * (y + 0.5f) / IMAGE_SIZE, 0.0f};
+  return Ray3df{ eye, pixel - eye };
+}
+
+// a few large spheres (dense == 0) or a dense grid of 16 x 16 x 2 small spheres
+std::vector<Sphere3df> create_scene(int64_t dense) {
+  std::vector<Sphere3df> spheres;
+  if (dense == 0) {
+    spheres.push_back( Sphere3df({0.0f, -1005.0f, 0.0f}, 1000.0f) );
+    spheres.push_back( Sphere3df({-4.0f, -2.0f, 0.0f}, 3.0f) );
+    spheres.push_back( Sphere3df({4.0f, -3.0f, 2.0f}, 2.0f) );
+    spheres.push_back( Sphere3df({0.0f, 4.0f, -3.0f}, 4.0f) );
+    spheres.push_back( Sphere3df({6.0f, 6.0f, -6.0f}, 1.5f) );
+    return spheres;
+  }
+  for (size_t x = 0; x < 16u; x++) {
+    for (size_t y = 0; y < 16u; y++) {
+      for (size_t z = 0; z < 2u; z++) {
+        spheres.push_back( Sphere3df({-9.4f + 1.25f * x, -9.4f + 1.25f * y, -2.0f * z}, 0.5f) );
+      }
+    }
+  }
+  return spheres;
+}
+
+void BM_PrimaryRays(benchmark::State & state) {
+  auto spheres = create_scene(state.range(0));
+  size_t hits = 0u;
+  for (auto _ : state) {
+    for (size_t y = 0; y < IMAGE_SIZE; y++) {
+      for (size_t x = 0; x < IMAGE_SIZE; x++) {
+        Ray3df ray = primary_ray(x, y);
+        float t_nearest = INFINITY;
+        size_t nearest = spheres.size();
+        for (size_t i = 0; i < spheres.size(); i++) {
+          float t = spheres[i].intersects(ray);
+          if (t > 0.0f && t < t_nearest) {
+            t_nearest = t;
+            nearest = i;
+          }
+        }
+        hits += nearest < spheres.size();
+      }
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * IMAGE_SIZE * IMAGE_SIZE);
+}
+
+// W neighbouring pixels of a row per packet
+template <size_t W>
+void BM_PrimaryRayPackets(benchmark::State & state) {
+  auto spheres = create_scene(state.range(0));
+  size_t hits = 0u;
+  for (auto _ : state) {
+    for (size_t y = 0; y < IMAGE_SIZE; y++) {
+      for (size_t x = 0; x < IMAGE_SIZE; x += W) {
+        RayPacket<float, 3u, W> packet;
+        std::array<float, W> t;
+        std::array<size_t, W> nearest;
+        for (size_t lane = 0; lane < W; lane++) {
+          packet.set(lane, primary_ray(x + lane, y));
+          t[lane] = INFINITY;
+          nearest[lane] = spheres.size();
+        }
+        for (size_t i = 0; i < spheres.size(); i++) {
+          for (uint32_t mask = spheres[i].intersects(packet, t); mask != 0u; mask &= mask - 1u) {
+            nearest[__builtin_ctz(mask)] = i;
+          }
+        }
+        for (size_t lane = 0; lane < W; lane++) {
+          hits += nearest[lane] < spheres.size();
+        }
+      }
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * IMAGE_SIZE * IMAGE_SIZE);
+}
+
+// the vertices of a mesh
+std::vector<Vector3df> mesh_vertices(const char * file) {
+  std::ifstream in(file);
+  WavefrontImporter importer(in);
+  importer.parse();
+  std::vector<Vector3df> points;
+  for (const auto & vertice : importer.get_vertices()) {
+    points.push_back({vertice[0], vertice[1], vertice[2]});
+  }
+  return points;
+}
+
+constexpr size_t NO_OF_PAIRS = 256u;
+
+enum ConvexTest { SPHERES, GJK_COLD, GJK_WARM, CONTACT_WARM };
+
+// persistent pairs of an asteroid and the spaceship moving and rotating slightly per frame,
+// about half of the pairs have intersecting bounding spheres
+void BM_ConvexPairs(benchmark::State & state) {
+  ConvexTest test = static_cast<ConvexTest>(state.range(0));
+  static const ConvexVertices3df asteroid(mesh_vertices(ASTEROID_FILE));
+  static const ConvexVertices3df spaceship(mesh_vertices(SPACESHIP_FILE));
+  std::mt19937 generator(5u);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  struct Pair {
+    Vector3df offset, velocity;
+    float angle, spin;
+    GJKCache3df cache;
+  };
+  float reach = asteroid.get_radius() + spaceship.get_radius();
+  std::vector<Pair> pairs;
+  for (size_t i = 0; i < NO_OF_PAIRS; i++) {
+    Vector3df direction = {unit(generator) - 0.5f, unit(generator) - 0.5f, unit(generator) - 0.5f};
+    direction.normalize();
+    pairs.push_back( Pair{ (1.4f * reach * unit(generator)) * direction, (0.002f * reach) * direction,
+                           6.2831853f * unit(generator), 0.01f * (unit(generator) - 0.5f), {} } );
+  }
+  Affine3f identity;
+  size_t frame = 0u;
+  size_t hits = 0u;
+  size_t iterations = 0u;
+  float distances = 0.0f;
+  for (auto _ : state) {
+    // back and forth every 200 frames
+    float sign = (frame++ / 200u) % 2u == 0u ? 1.0f : -1.0f;
+    for (auto & pair : pairs) {
+      pair.offset += sign * pair.velocity;
+      pair.angle += pair.spin;
+      Affine3f transformation(pair.offset, pair.angle, 1.0f);
+      if (test == SPHERES) {
+        float radii = asteroid.get_radius() + spaceship.get_radius();
+        hits += (transformation * spaceship.get_center() - asteroid.get_center()).square_of_length() <= radii * radii;
+      } else if (test == CONTACT_WARM) {
+        ConvexContact3df contact = asteroid.contact(identity, spaceship, transformation, pair.cache);
+        hits += contact.intersecting;
+        distances += contact.distance;
+        iterations += pair.cache.iterations;
+      } else {
+        if (test == GJK_COLD) {
+          pair.cache.count = 0u;
+        }
+        hits += asteroid.intersects(identity, spaceship, transformation, pair.cache);
+        iterations += pair.cache.iterations;
+      }
+    }
+    benchmark::DoNotOptimize(distances);
+  }
+  state.counters["hits"] = static_cast<double>(hits) / state.iterations() / NO_OF_PAIRS;
+  state.counters["support_calls"] = static_cast<double>(iterations) / state.iterations() / NO_OF_PAIRS;
+}
+
+// cells of 1/64 of the largest extent of the teapot, a band of two cells
+const std::vector<Triangle3df> & sdf_triangles(float & cell_size) {
+  const std::vector<Triangle3df> & triangles = teapot();
+  Vector3df min = {INFINITY, INFINITY, INFINITY}, max = {-INFINITY, -INFINITY, -INFINITY};
+  for (const auto & triangle : triangles) {
+    AABB3df box = triangle.bounding_box();
+    for (size_t i = 0; i < 3u; i++) {
+      min[i] = std::min(min[i], box.get_center()[i] - box.get_half_edge_length()[i]);
+      max[i] = std::max(max[i], box.get_center()[i] + box.get_half_edge_length()[i]);
+    }
+  }
+  cell_size = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2]}) / 64.0f;
+  return triangles;
+}
+
+const SignedDistanceField3df & teapot_field() {
+  static const SignedDistanceField3df field = [] {
+    float cell_size;
+    const std::vector<Triangle3df> & triangles = sdf_triangles(cell_size);
+    return SignedDistanceField3df(triangles, cell_size, 2.0f * cell_size);
+  }();
+  return field;
+}
+
+// points near the surface of the teapot: the triangle centers moved randomly by up to two cells
+std::vector<Vector3df> sdf_points() {
+  float cell_size;
+  const std::vector<Triangle3df> & triangles = sdf_triangles(cell_size);
+  std::mt19937 generator(17u);
+  std::uniform_real_distribution<float> offset(-2.0f * cell_size, 2.0f * cell_size);
+  std::uniform_int_distribution<size_t> index(0u, triangles.size() - 1u);
+  std::vector<Vector3df> points;
+  for (size_t i = 0; i < NO_OF_RAYS; i++) {
+    Vector3df point = triangles[index(generator)].bounding_box().get_center();
+    points.push_back(point + Vector3df{offset(generator), offset(generator), offset(generator)});
+  }
+  return points;
+}
+
+// Arg(0): one thread, Arg(1): all hardware threads
+void BM_SDFBake(benchmark::State & state) {
+  float cell_size;
+  const std::vector<Triangle3df> & triangles = sdf_triangles(cell_size);
+  unsigned threads = state.range(0) == 0 ? 1u : 0u;
+  for (auto _ : state) {
+    SignedDistanceField3df field(triangles, cell_size, 2.0f * cell_size, threads);
+    benchmark::DoNotOptimize(field);
+  }
+  state.counters["stored_bricks"] = static_cast<double>(teapot_field().stored_bricks());
+}
+
+void BM_SDFLoad(benchmark::State & state) {
+  std::stringstream stream;
+  teapot_field().save(stream);
+  std::string data = stream.str();
+  for (auto _ : state) {
+    std::istringstream in(data);
+    SignedDistanceField3df field;
+    benchmark::DoNotOptimize(field.load(in));
+  }
+  state.counters["bytes"] = static_cast<double>(data.size());
+}
+
+void BM_PointDistanceLinearScan(benchmark::State & state) {
+  const std::vector<Triangle3df> & triangles = teapot();
+  std::vector<Vector3df> points = sdf_points();
+  for (auto _ : state) {
+    for (const auto & point : points) {
+      float best = INFINITY;
+      for (const auto & triangle : triangles) {
+        best = std::min(best, (triangle.closest_point(point) - point).square_of_length());
+      }
+      benchmark::DoNotOptimize(best);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+void BM_PointDistanceSDF(benchmark::State & state) {
+  const SignedDistanceField3df & field = teapot_field();
+  std::vector<Vector3df> points = sdf_points();
+  for (auto _ : state) {
+    for (const auto & point : points) {
+      benchmark::DoNotOptimize(field.distance(point));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+BENCHMARK(BM_TriangleIntersection<CrossProductTriangle>);
+BENCHMARK(BM_TriangleIntersection<Triangle3df>);
+BENCHMARK(BM_TriangleIntersection<PrecomputedTriangle3df>);
+BENCHMARK(BM_TriangleBlockLoop<4u>);
+BENCHMARK(BM_TriangleBlock<4u>);
+BENCHMARK(BM_TriangleBlockLoop<8u>);
+BENCHMARK(BM_TriangleBlock<8u>);
+BENCHMARK(BM_SlabTestDivision);
+BENCHMARK(BM_SlabTestPreparedRay);
+BENCHMARK(BM_BVHBuild);
+BENCHMARK(BM_ClosestHitLinearScan);
+BENCHMARK(BM_ClosestHitBVH<Triangle3df>);
+BENCHMARK(BM_ClosestHitBVH<PrecomputedTriangle3df>);
+BENCHMARK(BM_AnyHitBVH);
+BENCHMARK(BM_PrimaryRays)->Arg(0)->Arg(1);
+BENCHMARK(BM_PrimaryRayPackets<4u>)->Arg(0)->Arg(1);
+BENCHMARK(BM_PrimaryRayPackets<8u>)->Arg(0)->Arg(1);
+BENCHMARK(BM_ConvexPairs)->Arg(SPHERES)->Arg(GJK_COLD)->Arg(GJK_WARM)->Arg(CONTACT_WARM);
+BENCHMARK(BM_SDFBake)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SDFLoad)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PointDistanceLinearScan);
+// Arg(0): asteroid.obj, Arg(1): spaceship.obj, Arg(2): teapot.obj,
+// the volumes of the sphere and the oriented box are relative to the volume of the aabb
+void BM_MeshBounds(benchmark::State & state) {
+  const char * files[] = { ASTEROID_FILE, SPACESHIP_FILE, TEAPOT_FILE };
+  std::vector<Vector3df> points = mesh_vertices(files[state.range(0)]);
+  for (auto _ : state) {
+    MeshBounds3df bounds(points);
+    benchmark::DoNotOptimize(bounds);
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+  MeshBounds3df bounds(points);
+  Vector3df half = bounds.box.get_half_edge_length();
+  float box_volume = 8.0f * half[0] * half[1] * half[2],
+        radius = bounds.sphere.get_radius();
+  state.counters["sphere"] = 4.0f / 3.0f * M_PI * radius * radius * radius / box_volume;
+  state.counters["oriented"] = bounds.oriented.volume() / box_volume;
+}
+
+BENCHMARK(BM_PointDistanceSDF);
+BENCHMARK(BM_MeshBounds)->Arg(0)->Arg(1)->Arg(2);
+
+}
+
+BENCHMARK_MAIN();
@@ -1,5 +1,12 @@
 #include "geometry.h"
+#include "shapes.h"
 #include "gtest/gtest.h"
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <tuple>
 
 namespace {
 	
@@ -262,6 +269,28 @@ TEST(SPHERE, NotInside_1) {
   EXPECT_FALSE( sphere.inside( Vector3df{-0.5f, 0.0f, 0.0f}) );
 }
 
+TEST(SPHERE, SweepIntersects2df) {
+  Sphere2df asteroid = { {100.0f, 0.0f}, 11.0f };
+  Sphere2df torpedo = { {0.0f, 0.0f}, 1.0f };
+
+  EXPECT_NEAR(88.0f / 768.0f, asteroid.sweep_intersects(torpedo, {768.0f, 0.0f}), 0.000001);
+  // grazing
+  EXPECT_NEAR(100.0f / 768.0f, asteroid.sweep_intersects(Sphere2df{ {0.0f, 12.0f}, 1.0f }, {768.0f, 0.0f}), 0.001);
+  EXPECT_EQ(INFINITY, asteroid.sweep_intersects(Sphere2df{ {0.0f, 12.5f}, 1.0f }, {768.0f, 0.0f}));
+  // moving apart and at rest
+  EXPECT_EQ(INFINITY, asteroid.sweep_intersects(torpedo, {-768.0f, 0.0f}));
+  EXPECT_EQ(INFINITY, asteroid.sweep_intersects(torpedo, {0.0f, 0.0f}));
+  // intersecting already
+  EXPECT_EQ(0.0f, asteroid.sweep_intersects(Sphere2df{ {90.0f, 0.0f}, 1.0f }, {-768.0f, 0.0f}));
+}
+
+TEST(SPHERE, SweepIntersects3df) {
+  Sphere3df sphere = { {0.0f, 0.0f, 0.0f}, 1.0f };
+
+  // the distance 2 sqrt(3) of the centers shrinks to 2
+  EXPECT_NEAR(1.0f - 1.0f / std::sqrt(3.0f), sphere.sweep_intersects(Sphere3df{ {2.0f, 2.0f, 2.0f}, 1.0f }, {-2.0f, -2.0f, -2.0f}), 0.000001);
+}
+
 TEST(TRIANGLE, Intersects3dfWithRay_1) {
   Triangle3df triangle = { {0.0, 0.0, 0.0}, {0.0, 3.0, 0.0},{3.0, 0.0, 0.0}  };
   Ray3df ray{ {0.0, 0.0, 2.0}, {0.0, 0.0, -1.0} };
@@ -410,6 +439,1162 @@ TEST(TRIANGLE, Intersects3dfWithRay_10) {
   EXPECT_TRUE(triangle1.intersects(ray, normal, intersection, u, v, t) );
 }
 
+TEST(AABB, Intersects3dfWithRayContext) {
+  AABB3df box( {0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 1.0f} );
+  Intersection_Context<float, 3> context{};
+
+  EXPECT_TRUE( box.intersects(Ray3df{ {0.0f, 5.0f, 0.0f}, {0.0f, -1.0f, 0.0f} }, context) );
+  EXPECT_NEAR(3.0f, context.t, 0.00001);
+  EXPECT_NEAR(2.0f, context.intersection[1], 0.00001);
+  EXPECT_NEAR(1.0f, context.normal[1], 0.00001);
+
+  // starting inside, the exit face is hit
+  EXPECT_TRUE( box.intersects(Ray3df{ {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f} }, context) );
+  EXPECT_NEAR(1.0f, context.t, 0.00001);
+  EXPECT_NEAR(-1.0f, context.normal[0], 0.00001);
+
+  // the box is behind the ray origin
+  EXPECT_FALSE( box.intersects(Ray3df{ {0.0f, 5.0f, 0.0f}, {0.0f, 1.0f, 0.0f} }, context) );
+}
+
+TEST(PREPARED_RAY, SignBits) {
+  PreparedRay3df ray(Ray3df{ {1.0f, 2.0f, 3.0f}, {-2.0f, 0.0f, -0.0f} });
+
+  EXPECT_EQ(0b101u, ray.sign_bits);
+  EXPECT_EQ(-0.5f, ray.inverse[0]);
+  EXPECT_EQ(INFINITY, ray.inverse[1]);
+  EXPECT_EQ(-INFINITY, ray.inverse[2]);
+}
+
+TEST(AABB, SlabInterval3df) {
+  AABB3df box( {0.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 1.0f} );
+
+  auto [t_near, t_far] = box.slab_interval(PreparedRay3df(Ray3df{ {0.0f, 5.0f, 0.5f}, {0.0f, -1.0f, 0.0f} }));
+  EXPECT_EQ(3.0f, t_near);
+  EXPECT_EQ(7.0f, t_far);
+
+  // restricted to [0, 2] the box is not reached
+  std::tie(t_near, t_far) = box.slab_interval(PreparedRay3df(Ray3df{ {0.0f, 5.0f, 0.5f}, {0.0f, -1.0f, 0.0f} }), 0.0f, 2.0f);
+  EXPECT_GT(t_near, t_far);
+
+  // the line passes beside the box
+  std::tie(t_near, t_far) = box.slab_interval(PreparedRay3df(Ray3df{ {3.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 4.0f} }));
+  EXPECT_GT(t_near, t_far);
+}
+
+TEST(AABB, SlabIntervalOriginOnSlabPlane) {
+  AABB3df box( {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f} );
+
+  // 0 * infinity on the planes x = 1 and y = -1, the ray grazes the edge of the box
+  auto [t_near, t_far] = box.slab_interval(PreparedRay3df(Ray3df{ {1.0f, -1.0f, 5.0f}, {0.0f, 0.0f, -1.0f} }));
+  EXPECT_EQ(4.0f, t_near);
+  EXPECT_EQ(6.0f, t_far);
+  EXPECT_TRUE( box.intersects(Ray3df{ {1.0f, -1.0f, 5.0f}, {0.0f, -0.0f, -1.0f} }) );
+
+  // beside the plane
+  std::tie(t_near, t_far) = box.slab_interval(PreparedRay3df(Ray3df{ {1.5f, -1.0f, 5.0f}, {0.0f, 0.0f, -1.0f} }));
+  EXPECT_GT(t_near, t_far);
+
+  AABB2df square = { {0.0, 0.0}, {1.0, 1.0} };
+  EXPECT_TRUE( square.intersects(Ray2df{ {-1.0, 3.0}, {0.0, -1.0} }) );
+  EXPECT_FALSE( square.intersects(Ray2df{ {-1.5, 3.0}, {0.0, -1.0} }) );
+}
+
+TEST(AABB, SlabIntervalEqualsIntersects) {
+  std::mt19937 generator(5u);
+  std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> half_edge_length(0.5f, 5.0f);
+  size_t hits = 0u;
+  for (size_t i = 0; i < 1000u; i++) {
+    AABB3df box( {coordinate(generator), coordinate(generator), coordinate(generator)},
+                 {half_edge_length(generator), half_edge_length(generator), half_edge_length(generator)} );
+    Ray3df ray{ {coordinate(generator), coordinate(generator), coordinate(generator)},
+                {coordinate(generator), coordinate(generator), coordinate(generator)} };
+    Intersection_Context<float, 3> context{};
+    auto [t_near, t_far] = box.slab_interval(PreparedRay3df(ray), 0.0f);
+    bool hit = box.intersects(ray, context);
+    ASSERT_EQ(hit, t_near <= t_far);
+    if (hit) {
+      hits++;
+      EXPECT_NEAR(t_near > 0.0f ? t_near : t_far, context.t, 0.0001f * context.t);
+    }
+  }
+  EXPECT_GT(hits, 50u);
+}
+
+TEST(CONVEX_POLYGON, Intersects) {
+  std::vector<Vector2df> square = { {0.0f, 0.0f}, {2.0f, 0.0f}, {2.0f, 2.0f}, {0.0f, 2.0f} };
+  ConvexPolygon2df polygon1(square);
+  ConvexPolygon2df polygon2( std::vector<Vector2df>{ {0.0f, 0.0f}, {1.0f, 1.0f}, {2.0f, 0.0f} } );  // clockwise
+
+  EXPECT_TRUE( polygon1.intersects(polygon2) );
+  EXPECT_TRUE( polygon1.intersects(polygon2, {1.5f, 1.5f}) );
+  EXPECT_TRUE( polygon1.intersects(polygon2, {0.0f, 2.0f}) );  // touching
+  EXPECT_FALSE( polygon1.intersects(polygon2, {0.0f, 2.5f}) );
+  // the bounding boxes overlap, the diagonal edge of the triangle separates them
+  EXPECT_FALSE( polygon2.intersects(polygon1, {1.3f, 1.3f}) );
+  EXPECT_TRUE( polygon2.intersects(polygon1, {0.9f, 0.9f}) );
+}
+
+TEST(CONVEX_POLYGON, IntersectsLineSegment) {
+  ConvexPolygon2df triangle( std::vector<Vector2df>{ {0.0f, 0.0f}, {4.0f, 0.0f}, {0.0f, 4.0f} } );
+
+  // the points are outside, the segment crosses the triangle
+  EXPECT_TRUE( triangle.intersects(ConvexPolygon2df( std::vector<Vector2df>{ {-1.0f, 1.0f}, {5.0f, 1.0f} } )) );
+  EXPECT_FALSE( triangle.intersects(ConvexPolygon2df( std::vector<Vector2df>{ {1.0f, 3.5f}, {3.5f, 1.0f} } )) );
+  // a point
+  EXPECT_TRUE( triangle.intersects(ConvexPolygon2df( std::vector<Vector2df>{ {1.0f, 1.0f} } )) );
+  EXPECT_FALSE( triangle.intersects(ConvexPolygon2df( std::vector<Vector2df>{ {3.0f, 3.0f} } )) );
+
+  // the same without building a polygon of the segment
+  EXPECT_TRUE( triangle.intersects_segment({-1.0f, 1.0f}, {5.0f, 1.0f}) );
+  EXPECT_FALSE( triangle.intersects_segment({1.0f, 3.5f}, {3.5f, 1.0f}) );
+  EXPECT_TRUE( triangle.intersects_segment({1.0f, 1.0f}, {1.0f, 1.0f}) );
+  EXPECT_FALSE( triangle.intersects_segment({3.0f, 3.0f}, {3.0f, 3.0f}) );
+  EXPECT_TRUE( triangle.intersects_segment({2.0f, 2.0f}, {3.0f, 3.0f}) );  // touching
+}
+
+TEST(CONVEX_POLYGON, ConvexHull) {
+  std::vector<Vector2df> points = { {1.0f, 1.0f}, {2.0f, 2.0f}, {0.0f, 0.0f}, {2.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 2.0f}, {2.0f, 2.0f} };
+  auto hull = ConvexPolygon2df::convex_hull(points).get_points();
+
+  ASSERT_EQ(4u, hull.size());
+  std::vector<Vector2df> expected = { {0.0f, 0.0f}, {2.0f, 0.0f}, {2.0f, 2.0f}, {0.0f, 2.0f} };
+  for (size_t i = 0; i < 4u; i++) {
+    EXPECT_EQ(expected[i][0], hull[i][0]);
+    EXPECT_EQ(expected[i][1], hull[i][1]);
+  }
+}
+
+TEST(CONVEX_POLYGON, Transformed) {
+  ConvexPolygon2df polygon( std::vector<Vector2df>{ {1.0f, 0.0f}, {2.0f, 0.0f}, {2.0f, 1.0f} } );
+  auto points = polygon.transformed(0.5f * M_PI, 2.0f).get_points();
+
+  EXPECT_NEAR(0.0f, points[1][0], 0.00001);
+  EXPECT_NEAR(4.0f, points[1][1], 0.00001);
+  EXPECT_NEAR(-2.0f, points[2][0], 0.00001);
+  EXPECT_NEAR(4.0f, points[2][1], 0.00001);
+}
+
+// the shoelace formula, positive for counterclockwise points
+float signed_area(const std::vector<Vector2df> & points) {
+  float area = 0.0f;
+  for (size_t i = 0; i < points.size(); i++) {
+    const Vector2df & a = points[i];
+    const Vector2df & b = points[(i + 1) % points.size()];
+    area += 0.5f * (a[0] * b[1] - b[0] * a[1]);
+  }
+  return area;
+}
+
+// even-odd rule
+bool inside_outline(const std::vector<Vector2df> & outline, Vector2df p) {
+  bool inside = false;
+  for (size_t i = 0, j = outline.size() - 1; i < outline.size(); j = i++) {
+    if ( (outline[i][1] > p[1]) != (outline[j][1] > p[1])
+         && p[0] < (outline[j][0] - outline[i][0]) * (p[1] - outline[i][1]) / (outline[j][1] - outline[i][1]) + outline[i][0] ) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+void expect_decomposition_equals_outline(const std::vector<Vector2df> & outline, size_t max_parts) {
+  ConvexDecomposition2df decomposition(outline);
+  EXPECT_LE(decomposition.get_parts().size(), max_parts);
+  float area = 0.0f;
+  for (const auto & part : decomposition.get_parts()) {
+    const auto & points = part.get_points();
+    for (size_t i = 0; i < points.size(); i++) {
+      Vector2df edge1 = points[(i + 1) % points.size()] - points[i];
+      Vector2df edge2 = points[(i + 2) % points.size()] - points[(i + 1) % points.size()];
+      EXPECT_GE(edge1[0] * edge2[1] - edge1[1] * edge2[0], 0.0f);  // convex and counterclockwise
+    }
+    area += signed_area(points);
+  }
+  EXPECT_NEAR(std::fabs(signed_area(outline)), area, 0.01f);
+
+  std::mt19937 generator(17u);
+  std::uniform_real_distribution<float> coordinate(-40.0f, 40.0f);
+  for (size_t i = 0; i < 2000u; i++) {
+    Vector2df p = {coordinate(generator), coordinate(generator)};
+    EXPECT_EQ(inside_outline(outline, p), decomposition.intersects(ConvexPolygon2df( std::vector<Vector2df>{ {0.0f, 0.0f} } ), p))
+      << p[0] << " " << p[1];
+  }
+}
+
+TEST(CONVEX_DECOMPOSITION, LShape) {
+  std::vector<Vector2df> outline = { {0.0f, 0.0f}, {20.0f, 0.0f}, {20.0f, 10.0f}, {10.0f, 10.0f}, {10.0f, 20.0f}, {0.0f, 20.0f} };
+  expect_decomposition_equals_outline(outline, 2u);
+
+  // clockwise with a closing point
+  std::vector<Vector2df> clockwise(outline.rbegin(), outline.rend());
+  clockwise.push_back(clockwise.front());
+  ConvexDecomposition2df decomposition(clockwise);
+  EXPECT_EQ(2u, decomposition.get_parts().size());
+  // the convex hull would be hit in the notch
+  ConvexPolygon2df box( std::vector<Vector2df>{ {0.0f, 0.0f}, {4.0f, 0.0f}, {4.0f, 4.0f}, {0.0f, 4.0f} } );
+  EXPECT_FALSE( decomposition.intersects(box, {13.0f, 13.0f}) );
+  EXPECT_TRUE( decomposition.intersects(box, {8.0f, 13.0f}) );
+  EXPECT_TRUE( decomposition.intersects(ConvexDecomposition2df(clockwise), {15.0f, 5.0f}) );
+  EXPECT_FALSE( decomposition.intersects(ConvexDecomposition2df(clockwise), {10.5f, 10.5f}) );
+}
+
+TEST(CONVEX_DECOMPOSITION, AsteroidOutlines) {
+  constexpr size_t max_parts[] = {4u, 6u, 4u, 6u};
+  for (size_t rock = 0; rock < shapes::asteroids.size(); rock++) {
+    std::span<const Vector2df> outline = shapes::asteroids[rock];
+    expect_decomposition_equals_outline({outline.begin(), outline.end()}, max_parts[rock]);
+  }
+}
+
+TEST(CONVEX_DECOMPOSITION, QueriesEqualTransformedPolygons) {
+  ConvexDecomposition2df spaceship(shapes::spaceship);
+  ConvexDecomposition2df asteroid = ConvexDecomposition2df(shapes::asteroids[1]).transformed(0.0f, 0.5f);
+  std::mt19937 generator(5u);
+  std::uniform_real_distribution<float> coordinate(-30.0f, 30.0f);
+  std::uniform_real_distribution<float> angle(-M_PI, M_PI);
+  size_t hits = 0;
+  for (size_t i = 0; i < 2000u; i++) {
+    Vector2df offset = {coordinate(generator), coordinate(generator)};
+    float phi = angle(generator);
+    bool expected = asteroid.intersects(spaceship.transformed(phi, 1.0f), offset);
+    EXPECT_EQ(expected, asteroid.intersects_rotated(spaceship, phi, offset)) << offset[0] << " " << offset[1] << " " << phi;
+    hits += expected;
+
+    Vector2df end = {coordinate(generator), coordinate(generator)};
+    std::vector<Vector2df> segment = {offset, end};
+    EXPECT_EQ(asteroid.intersects(ConvexPolygon2df(segment)), asteroid.intersects_segment(offset, end))
+      << offset[0] << " " << offset[1] << " " << end[0] << " " << end[1];
+  }
+  EXPECT_GT(hits, 100u);
+}
+
+// random primitives in [-10, 10]^3 and rays from outside through the scene
+std::vector<Ray3df> create_rays(std::mt19937 & generator, size_t count) {
+  std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+  std::vector<Ray3df> rays;
+  for (size_t i = 0; i < count; i++) {
+    Vector3df origin = {coordinate(generator), coordinate(generator), 20.0f};
+    Vector3df target = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    rays.push_back( Ray3df{ origin, target - origin } );
+  }
+  return rays;
+}
+
+std::vector<Triangle3df> create_triangles(std::mt19937 & generator, size_t count) {
+  std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+  std::vector<Triangle3df> triangles;
+  for (size_t i = 0; i < count; i++) {
+    Vector3df a = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Vector3df b = a + Vector3df{offset(generator), offset(generator), offset(generator)};
+    Vector3df c = a + Vector3df{offset(generator), offset(generator), offset(generator)};
+    triangles.push_back( Triangle3df(a, b, c) );
+  }
+  return triangles;
+}
+
+// the nearest intersection of a linear scan
+template <class PRIMITIVE>
+bool closest_hit_by_scan(const std::vector<PRIMITIVE> & primitives, const Ray3df & ray, Intersection_Context<float, 3> & context) {
+  bool hit = false;
+  Intersection_Context<float, 3> candidate{};
+  for (const auto & primitive : primitives) {
+    if (primitive.intersects(ray, candidate) && (!hit || candidate.t < context.t)) {
+      context = candidate;
+      hit = true;
+    }
+  }
+  return hit;
+}
+
+template <class PRIMITIVE>
+void expect_bvh_equals_scan(const std::vector<PRIMITIVE> & primitives, const std::vector<Ray3df> & rays) {
+  BVH<PRIMITIVE> bvh(primitives);
+  ASSERT_EQ(primitives.size(), bvh.get_primitives().size());
+  size_t hits = 0u;
+  for (const auto & ray : rays) {
+    Intersection_Context<float, 3> expected{}, context{};
+    bool hit = closest_hit_by_scan(primitives, ray, expected);
+    const PRIMITIVE * primitive = bvh.closest_hit(ray, context);
+    ASSERT_EQ(hit, primitive != nullptr);
+    EXPECT_EQ(hit, bvh.any_hit(ray));
+    if (hit) {
+      hits++;
+      EXPECT_EQ(expected.t, context.t);
+      EXPECT_EQ(expected.normal[0], context.normal[0]);
+      EXPECT_EQ(expected.normal[1], context.normal[1]);
+      EXPECT_EQ(expected.normal[2], context.normal[2]);
+      EXPECT_FALSE(bvh.any_hit(ray, expected.t * 0.999f));
+    }
+  }
+  EXPECT_GT(hits, rays.size() / 10u);
+}
+
+TEST(BVH, ClosestHitEqualsLinearScanTriangles) {
+  std::mt19937 generator(42u);
+  auto triangles = create_triangles(generator, 2000u);
+  expect_bvh_equals_scan(triangles, create_rays(generator, 500u));
+}
+
+TEST(BVH, ClosestHitEqualsLinearScanSpheres) {
+  std::mt19937 generator(7u);
+  std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> radius(0.05f, 0.5f);
+  std::vector<Sphere3df> spheres;
+  for (size_t i = 0; i < 1000u; i++) {
+    spheres.push_back( Sphere3df({coordinate(generator), coordinate(generator), coordinate(generator)}, radius(generator)) );
+  }
+  expect_bvh_equals_scan(spheres, create_rays(generator, 500u));
+}
+
+TEST(BVH, ClosestHitEqualsLinearScanBoxes) {
+  std::mt19937 generator(13u);
+  std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+  std::uniform_real_distribution<float> half_edge_length(0.05f, 0.5f);
+  std::vector<AABB3df> boxes;
+  for (size_t i = 0; i < 1000u; i++) {
+    boxes.push_back( AABB3df({coordinate(generator), coordinate(generator), coordinate(generator)},
+                             {half_edge_length(generator), half_edge_length(generator), half_edge_length(generator)}) );
+  }
+  expect_bvh_equals_scan(boxes, create_rays(generator, 500u));
+}
+
+TEST(BVH, NodesContainTheirPrimitives) {
+  std::mt19937 generator(3u);
+  TriangleBVH3df bvh(create_triangles(generator, 1000u));
+  const auto & nodes = bvh.get_nodes();
+  size_t leaf_primitives = 0u;
+  for (const auto & node : nodes) {
+    if (node.count == 0u) {
+      continue;
+    }
+    EXPECT_LE(node.count, TriangleBVH3df::MAX_LEAF_SIZE);
+    leaf_primitives += node.count;
+    for (size_t i = node.index; i < node.index + node.count; i++) {
+      AABB3df box = bvh.get_primitives()[i].bounding_box();
+      for (size_t axis = 0; axis < 3u; axis++) {
+        EXPECT_LE(node.min[axis], box.get_center()[axis] - box.get_half_edge_length()[axis]);
+        EXPECT_GE(node.max[axis], box.get_center()[axis] + box.get_half_edge_length()[axis]);
+      }
+    }
+  }
+  EXPECT_EQ(1000u, leaf_primitives);
+  EXPECT_LT(nodes.size(), 2u * 1000u);
+}
+
+TEST(BVH, EqualCentroids) {
+  // SAH can not separate the primitives, the hierarchy is split at the median
+  std::vector<Sphere3df> spheres;
+  for (size_t i = 0; i < 100u; i++) {
+    spheres.push_back( Sphere3df({0.0f, 0.0f, 0.0f}, 1.0f + 0.01f * i) );
+  }
+  SphereBVH3df bvh(spheres);
+  Intersection_Context<float, 3> context{};
+  EXPECT_NE(nullptr, bvh.closest_hit(Ray3df{ {0.0f, 0.0f, 10.0f}, {0.0f, 0.0f, -1.0f} }, context));
+  EXPECT_NEAR(8.01f, context.t, 0.0001);
+}
+
+TEST(BVH, RaysOnSlabPlanes) {
+  // rays parallel to the z axis along the faces of a grid of boxes
+  std::vector<AABB3df> boxes;
+  for (int x = -4; x <= 4; x++) {
+    for (int y = -4; y <= 4; y++) {
+      boxes.push_back( AABB3df({float(x), float(y), float((x + y) % 3)}, {0.5f, 0.5f, 0.5f}) );
+    }
+  }
+  std::vector<Ray3df> rays;
+  for (int x = -10; x <= 10; x++) {
+    for (int y = -10; y <= 10; y++) {
+      rays.push_back( Ray3df{ {0.5f * x, 0.5f * y, 10.0f}, {0.0f, -0.0f, -1.0f} } );
+    }
+  }
+  expect_bvh_equals_scan(boxes, rays);
+}
+
+TEST(BVH, Empty) {
+  TriangleBVH3df bvh(std::vector<Triangle3df>{});
+  Intersection_Context<float, 3> context{};
+  Ray3df ray{ {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f} };
+  EXPECT_EQ(nullptr, bvh.closest_hit(ray, context));
+  EXPECT_FALSE(bvh.any_hit(ray));
+}
+
+TEST(TRIANGLE, Intersects3dfWithRayMisses) {
+  Triangle3df triangle = { {0.0, 0.0, 0.0}, {0.0, 3.0, 0.0},{3.0, 0.0, 0.0}  };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_FALSE( triangle.intersects(Ray3df{ {2.0, 2.0, 2.0}, {0.0, 0.0, -1.0} }, context) );  // beside the hypotenuse
+  EXPECT_FALSE( triangle.intersects(Ray3df{ {1.0, 1.0, 2.0}, {0.0, 0.0, 1.0} }, context) );   // behind the origin
+  EXPECT_FALSE( triangle.intersects(Ray3df{ {1.0, 1.0, 2.0}, {1.0, 0.0, 0.0} }, context) );   // parallel
+}
+
+TEST(TRIANGLE, Intersects3dfWithRayBarycentricCoordinates) {
+  std::mt19937 generator(5u);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  size_t hits = 0u;
+  for (size_t i = 0; i < 1000u; i++) {
+    Vector3df a = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Vector3df b = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Vector3df c = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Vector3df origin = {coordinate(generator), coordinate(generator), 5.0f};
+    Vector3df target = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Intersection_Context<float,3u> context;
+    if ( !Triangle3df(a, b, c).intersects(Ray3df{ origin, target - origin }, context) ) {
+      continue;
+    }
+    hits++;
+    EXPECT_GE(context.u, 0.0f);
+    EXPECT_GE(context.v, 0.0f);
+    EXPECT_LE(context.u + context.v, 1.00001f);
+    Vector3df p = context.u * a + context.v * b + (1.0f - context.u - context.v) * c;
+    for (size_t axis = 0; axis < 3u; axis++) {
+      EXPECT_NEAR(p[axis], context.intersection[axis], 0.0001);
+    }
+  }
+  EXPECT_GT(hits, 20u);
+}
+
+TEST(TRIANGLE, Intersects3dfWithRayWatertight) {
+  // a quad of two triangles (clockwise seen from above), the rays run through their common edge (the diagonal)
+  Vector3df a = {-1.3f, -0.7f, 0.2f}, b = {1.1f, -0.9f, -0.3f}, c = {0.9f, 1.2f, 0.1f}, d = {-1.0f, 0.8f, 0.4f};
+  Triangle3df triangle1(a, c, b), triangle2(a, d, c);
+  Vector3df origin = {0.1f, 0.3f, 5.0f};
+  Intersection_Context<float,3u> context;
+  for (size_t i = 1; i < 1000u; i++) {
+    float s = i / 1000.0f;
+    Ray3df ray{ origin, a + s * (c - a) - origin };
+    EXPECT_TRUE( triangle1.intersects(ray, context) || triangle2.intersects(ray, context) ) << "s = " << s;
+  }
+}
+
+TEST(TRIANGLE, Intersects3dfWithRayBackface) {
+  // clockwise seen from above
+  Triangle3df triangle = { {0.0, 0.0, 0.0}, {0.0, 3.0, 0.0},{3.0, 0.0, 0.0}  };
+  Intersection_Context<float,3u> context;
+
+  EXPECT_TRUE( triangle.intersects(Ray3df{ {1.0, 1.0, 2.0}, {0.0, 0.0, -1.0} }, context) );
+#ifdef GEOMETRY_BACKFACE_CULLING
+  EXPECT_FALSE( triangle.intersects(Ray3df{ {1.0, 1.0, -2.0}, {0.0, 0.0, 1.0} }, context) );
+#else
+  EXPECT_TRUE( triangle.intersects(Ray3df{ {1.0, 1.0, -2.0}, {0.0, 0.0, 1.0} }, context) );
+  EXPECT_NEAR(2.0, context.t, 0.000001 );
+#endif
+}
+
+TEST(PRECOMPUTED_TRIANGLE, Size) {
+  EXPECT_EQ(48u, sizeof(PrecomputedTriangle3df));
+}
+
+TEST(PRECOMPUTED_TRIANGLE, IntersectsEqualsTriangle) {
+  std::mt19937 generator(11u);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  size_t hits = 0u;
+  for (size_t i = 0; i < 2000u; i++) {
+    Vector3df a = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Vector3df b = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Vector3df c = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Vector3df origin = {coordinate(generator), coordinate(generator), 5.0f};
+    Vector3df target = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    Ray3df ray{ origin, target - origin };
+    Triangle3df triangle(a, b, c);
+    PrecomputedTriangle3df precomputed(triangle);
+    Intersection_Context<float,3u> expected{}, context{};
+    bool hit = triangle.intersects(ray, expected);
+    ASSERT_EQ(hit, precomputed.intersects(ray, context));
+    if (hit) {
+      hits++;
+      EXPECT_NEAR(expected.t, context.t, 0.0001);
+      EXPECT_NEAR(expected.u, context.u, 0.0001);
+      EXPECT_NEAR(expected.v, context.v, 0.0001);
+      for (size_t axis = 0; axis < 3u; axis++) {
+        EXPECT_NEAR(expected.normal[axis], context.normal[axis], 0.0001);
+        EXPECT_NEAR(expected.intersection[axis], context.intersection[axis], 0.0001);
+      }
+    }
+  }
+  EXPECT_GT(hits, 50u);
+}
+
+TEST(PRECOMPUTED_TRIANGLE, BoundingBoxEqualsTriangle) {
+  Triangle3df triangle = { {-5.0f, 5.0f, 5.0f}, {-5.0f, 2.0f, -5.0f}, {5.0, 7.0, -3.0} };
+  AABB3df expected = triangle.bounding_box();
+  AABB3df box = PrecomputedTriangle3df(triangle).bounding_box();
+  for (size_t axis = 0; axis < 3u; axis++) {
+    EXPECT_NEAR(expected.get_center()[axis], box.get_center()[axis], 0.0001);
+    EXPECT_NEAR(expected.get_half_edge_length()[axis], box.get_half_edge_length()[axis], 0.0001);
+    EXPECT_GE(box.get_half_edge_length()[axis], expected.get_half_edge_length()[axis]);
+  }
+}
+
+TEST(PRECOMPUTED_TRIANGLE, DegeneratedIsNeverHit) {
+  PrecomputedTriangle3df triangle( {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {2.0f, 2.0f, 0.0f} );
+  Intersection_Context<float,3u> context{};
+  EXPECT_FALSE( triangle.intersects(Ray3df{ {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, -1.0f} }, context) );
+}
+
+template <class BLOCK>
+void expect_block_equals_scan(size_t size, size_t width) {
+  std::mt19937 generator(17u + size);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  size_t hits = 0u;
+  for (size_t i = 0; i < 500u; i++) {
+    std::vector<PrecomputedTriangle3df> triangles;
+    for (size_t k = 0; k < size; k++) {
+      Vector3df a = {coordinate(generator), coordinate(generator), coordinate(generator)};
+      triangles.push_back( PrecomputedTriangle3df(a, a + 0.8f * Vector3df{coordinate(generator), coordinate(generator), coordinate(generator)},
+                                                  a + 0.8f * Vector3df{coordinate(generator), coordinate(generator), coordinate(generator)}) );
+    }
+    Vector3df origin = {coordinate(generator), coordinate(generator), 5.0f};
+    Vector3df target = {0.5f * coordinate(generator), 0.5f * coordinate(generator), coordinate(generator)};
+    Ray3df ray{ origin, target - origin };
+    BLOCK block(triangles);
+    EXPECT_EQ(size, block.size());
+
+    size_t expected = size;
+    float t_max = i % 2u == 0u ? INFINITY : 5.0f;
+    Intersection_Context<float,3u> nearest{}, candidate{}, context{};
+    for (size_t k = 0; k < size; k++) {
+      if (triangles[k].intersects(ray, candidate) && candidate.t < t_max && (expected == size || candidate.t < nearest.t)) {
+        expected = k;
+        nearest = candidate;
+      }
+    }
+    size_t index = block.intersects(ray, context, t_max);
+    if (expected == size) {
+      EXPECT_EQ(width, index);
+      continue;
+    }
+    hits++;
+    ASSERT_EQ(expected, index);
+    EXPECT_EQ(nearest.t, context.t);
+    EXPECT_EQ(nearest.u, context.u);
+    EXPECT_EQ(nearest.v, context.v);
+  }
+  EXPECT_GT(hits, 50u);
+}
+
+TEST(TRIANGLE_BLOCK, IntersectsEqualsScan4df) {
+  expect_block_equals_scan<TriangleBlock4df>(4u, 4u);
+}
+
+TEST(TRIANGLE_BLOCK, IntersectsEqualsScan8df) {
+  expect_block_equals_scan<TriangleBlock8df>(8u, 8u);
+}
+
+TEST(TRIANGLE_BLOCK, PartiallyFilled) {
+  expect_block_equals_scan<TriangleBlock8df>(5u, 8u);
+}
+
+TEST(BVH, ClosestHitEqualsLinearScanPrecomputedTriangles) {
+  std::mt19937 generator(42u);
+  std::vector<PrecomputedTriangle3df> triangles;
+  for (const auto & triangle : create_triangles(generator, 2000u)) {
+    triangles.push_back( PrecomputedTriangle3df(triangle) );
+  }
+  expect_bvh_equals_scan(triangles, create_rays(generator, 500u));
+}
+
+TEST(RAY_PACKET, GetSet) {
+  RayPacket4df packet{};
+  Ray3df ray{ {1.0f, 2.0f, 3.0f}, {4.0f, 5.0f, 6.0f} };
+  packet.set(2u, ray);
+  Ray3df result = packet.get(2u);
+  for (size_t axis = 0; axis < 3u; axis++) {
+    EXPECT_EQ(ray.origin[axis], result.origin[axis]);
+    EXPECT_EQ(ray.direction[axis], result.direction[axis]);
+    EXPECT_EQ(ray.origin[axis], packet.origin[axis][2]);
+  }
+  EXPECT_EQ(0xfu, RayPacket4df::ALL);
+  EXPECT_EQ(0xffu, RayPacket8df::ALL);
+}
+
+// random rays from above through [-1, 1]^3, every third ray inactive, the limits t alternate between infinity and 6
+template <size_t W>
+struct Packets {
+  std::vector< RayPacket<float, 3u, W> > packets;
+  std::vector< std::array<float, W> > limits;
+  std::vector<uint32_t> active;
+
+  explicit Packets(std::mt19937 & generator) {
+    std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+    for (size_t i = 0; i < 200u; i++) {
+      RayPacket<float, 3u, W> packet;
+      std::array<float, W> t;
+      uint32_t mask = 0u;
+      for (size_t lane = 0; lane < W; lane++) {
+        Vector3df origin = {coordinate(generator), coordinate(generator), 5.0f};
+        Vector3df target = {coordinate(generator), coordinate(generator), coordinate(generator)};
+        packet.set(lane, Ray3df{ origin, target - origin });
+        t[lane] = (i + lane) % 2u == 0u ? INFINITY : 6.0f;
+        mask |= static_cast<uint32_t>((i * W + lane) % 3u != 0u) << lane;
+      }
+      packets.push_back(packet);
+      limits.push_back(t);
+      active.push_back(mask);
+    }
+  }
+};
+
+template <size_t W>
+void expect_sphere_packets_equal_rays() {
+  std::mt19937 generator(19u);
+  Packets<W> packets(generator);
+  Sphere3df sphere( {0.1f, -0.2f, 0.3f}, 0.7f );
+  size_t hits = 0u;
+  for (size_t i = 0; i < packets.packets.size(); i++) {
+    std::array<float, W> t = packets.limits[i];
+    uint32_t mask = sphere.intersects(packets.packets[i], t, packets.active[i]);
+    for (size_t lane = 0; lane < W; lane++) {
+      float expected = sphere.intersects(packets.packets[i].get(lane));
+      bool hit = (packets.active[i] & (1u << lane)) && expected > 0.0f && expected < packets.limits[i][lane];
+      ASSERT_EQ(hit, (mask >> lane) & 1u);
+      if (hit) {
+        hits++;
+        EXPECT_NEAR(expected, t[lane], 0.00001);
+      } else {
+        EXPECT_EQ(packets.limits[i][lane], t[lane]);
+      }
+    }
+  }
+  EXPECT_GT(hits, 100u);
+}
+
+TEST(RAY_PACKET, SphereEqualsRays4df) {
+  expect_sphere_packets_equal_rays<4u>();
+}
+
+TEST(RAY_PACKET, SphereEqualsRays8df) {
+  expect_sphere_packets_equal_rays<8u>();
+}
+
+TEST(RAY_PACKET, SphereFromInside) {
+  RayPacket4df packet{};
+  for (size_t lane = 0; lane < 4u; lane++) {
+    packet.set(lane, Ray3df{ {0.0f, 0.0f, 0.0f}, {lane == 0u ? 1.0f : 0.0f, lane == 1u ? 1.0f : 0.0f, lane >= 2u ? 1.0f : 0.0f} });
+  }
+  std::array<float, 4u> t = {INFINITY, INFINITY, INFINITY, INFINITY};
+  EXPECT_EQ(0xfu, Sphere3df({0.0f, 0.0f, 0.0f}, 2.0f).intersects(packet, t));
+  for (float value : t) {
+    EXPECT_NEAR(2.0f, value, 0.00001);
+  }
+}
+
+template <size_t W>
+void expect_aabb_packets_equal_rays() {
+  std::mt19937 generator(23u);
+  Packets<W> packets(generator);
+  AABB3df box( {0.1f, -0.2f, 0.3f}, {0.5f, 0.3f, 0.6f} );
+  size_t hits = 0u;
+  for (size_t i = 0; i < packets.packets.size(); i++) {
+    uint32_t mask = box.intersects(packets.packets[i], packets.limits[i], packets.active[i]);
+    for (size_t lane = 0; lane < W; lane++) {
+      Intersection_Context<float,3u> context{};
+      bool hit = (packets.active[i] & (1u << lane)) && box.intersects(packets.packets[i].get(lane), context)
+                 && context.t <= packets.limits[i][lane];
+      EXPECT_EQ(hit, (mask >> lane) & 1u);
+      hits += hit;
+    }
+  }
+  EXPECT_GT(hits, 100u);
+}
+
+TEST(RAY_PACKET, AABBEqualsRays4df) {
+  expect_aabb_packets_equal_rays<4u>();
+}
+
+TEST(RAY_PACKET, AABBEqualsRays8df) {
+  expect_aabb_packets_equal_rays<8u>();
+}
+
+template <size_t W>
+void expect_triangle_packets_equal_rays() {
+  std::mt19937 generator(29u);
+  Packets<W> packets(generator);
+  Triangle3df triangle( {-0.9f, -0.8f, 0.2f}, {0.7f, -0.6f, -0.4f}, {0.1f, 0.9f, 0.3f} );
+  PrecomputedTriangle3df precomputed(triangle);
+  size_t hits = 0u;
+  for (size_t i = 0; i < packets.packets.size(); i++) {
+    std::array<float, W> t = packets.limits[i];
+    uint32_t mask = triangle.intersects(packets.packets[i], t, packets.active[i]);
+    for (size_t lane = 0; lane < W; lane++) {
+      Intersection_Context<float,3u> context{};
+      bool hit = (packets.active[i] & (1u << lane)) && precomputed.intersects(packets.packets[i].get(lane), context)
+                 && context.t < packets.limits[i][lane];
+      ASSERT_EQ(hit, (mask >> lane) & 1u);
+      EXPECT_EQ(hit ? context.t : packets.limits[i][lane], t[lane]);
+      hits += hit;
+    }
+  }
+  EXPECT_GT(hits, 100u);
+}
+
+TEST(RAY_PACKET, TriangleEqualsRays4df) {
+  expect_triangle_packets_equal_rays<4u>();
+}
+
+TEST(RAY_PACKET, TriangleEqualsRays8df) {
+  expect_triangle_packets_equal_rays<8u>();
+}
+
+// the eight corners of the cube [-1, 1]^3
+std::vector<Vector3df> cube_corners() {
+  std::vector<Vector3df> corners;
+  for (float x : {-1.0f, 1.0f}) {
+    for (float y : {-1.0f, 1.0f}) {
+      for (float z : {-1.0f, 1.0f}) {
+        corners.push_back({x, y, z});
+      }
+    }
+  }
+  return corners;
+}
+
+// rotation by angle_x around the x axis and then by angle_z around the z axis
+SquareMatrix3df rotation(float angle_x, float angle_z) {
+  float cx = std::cos(angle_x), sx = std::sin(angle_x), cz = std::cos(angle_z), sz = std::sin(angle_z);
+  SquareMatrix3df rx = { {1.0f, 0.0f, 0.0f}, {0.0f, cx, sx}, {0.0f, -sx, cx} };
+  SquareMatrix3df rz = { {cz, sz, 0.0f}, {-sz, cz, 0.0f}, {0.0f, 0.0f, 1.0f} };
+  return rz * rx;
+}
+
+TEST(CONVEX_VERTICES, SupportEqualsScan) {
+  std::mt19937 generator(23);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  for (size_t count : {1u, 4u, 7u, 37u}) {
+    std::vector<Vector3df> points;
+    for (size_t i = 0; i < count; i++) {
+      points.push_back({coordinate(generator), coordinate(generator), coordinate(generator)});
+    }
+    points.push_back(points[count / 2u]);  // equal points, the first one is returned
+    ConvexVertices3df vertices(points);
+    ASSERT_EQ(points.size(), vertices.size());
+    for (size_t i = 0; i < 100u; i++) {
+      Vector3df direction = {coordinate(generator), coordinate(generator), coordinate(generator)};
+      size_t expected = 0u;
+      float best = -INFINITY;
+      for (size_t j = 0; j < points.size(); j++) {
+        float value = points[j][0] * direction[0] + points[j][1] * direction[1] + points[j][2] * direction[2];
+        if (value > best) {
+          best = value;
+          expected = j;
+        }
+      }
+      EXPECT_EQ(expected, vertices.support(direction));
+    }
+  }
+}
+
+TEST(CONVEX_VERTICES, DistanceOfSeparatedCubes) {
+  std::vector<Vector3df> corners = cube_corners();
+  ConvexVertices3df cube(corners);
+  Affine3f identity;
+  GJKCache3df cache;
+
+  ConvexContact3df contact = cube.contact(identity, cube, Affine3f({3.0f, 0.5f, 0.2f}, rotation(0.0f, 0.0f), 1.0f), cache);
+  EXPECT_FALSE(contact.intersecting);
+  EXPECT_NEAR(1.0f, contact.distance, 0.0001f);
+  EXPECT_NEAR(1.0f, contact.normal[0], 0.0001f);
+  EXPECT_NEAR(1.0f, contact.point1[0], 0.0001f);
+  EXPECT_NEAR(2.0f, contact.point2[0], 0.0001f);
+
+  // an edge of the rotated cube points to a face
+  float position = 1.0f + std::sqrt(2.0f) + 0.5f;
+  contact = cube.contact(identity, cube, Affine3f({position, 0.0f, 0.0f}, rotation(0.0f, M_PI / 4.0f), 1.0f), cache);
+  EXPECT_FALSE(contact.intersecting);
+  EXPECT_NEAR(0.5f, contact.distance, 0.0001f);
+  EXPECT_NEAR(1.0f, contact.normal[0], 0.0001f);
+
+  // a corner of the scaled cube points to a corner
+  Vector3df diagonal = {1.0f, 1.0f, 1.0f};
+  Affine3f second((3.0f + 0.25f / std::sqrt(3.0f)) * diagonal, rotation(0.0f, 0.0f), 2.0f);
+  contact = cube.contact(identity, cube, second, cache);
+  EXPECT_FALSE(contact.intersecting);
+  EXPECT_NEAR(0.25f, contact.distance, 0.0001f);
+  for (size_t i = 0; i < 3u; i++) {
+    EXPECT_NEAR(1.0f / std::sqrt(3.0f), contact.normal[i], 0.0001f);
+    EXPECT_NEAR(1.0f, contact.point1[i], 0.0001f);
+  }
+  EXPECT_FALSE(cube.intersects(identity, cube, second, cache));
+}
+
+TEST(CONVEX_VERTICES, PenetrationOfCubes) {
+  std::vector<Vector3df> corners = cube_corners();
+  ConvexVertices3df cube(corners);
+  Affine3f identity;
+  GJKCache3df cache;
+  Affine3f moved({1.5f, 0.2f, -0.1f}, rotation(0.0f, 0.0f), 1.0f);
+
+  EXPECT_TRUE(cube.intersects(identity, cube, moved, cache));
+  ConvexContact3df contact = cube.contact(identity, cube, moved, cache);
+  EXPECT_TRUE(contact.intersecting);
+  EXPECT_NEAR(0.5f, contact.distance, 0.0001f);
+  EXPECT_NEAR(1.0f, contact.normal[0], 0.0001f);
+  EXPECT_NEAR(0.0f, contact.normal[1], 0.0001f);
+  EXPECT_NEAR(0.0f, contact.normal[2], 0.0001f);
+  EXPECT_NEAR(1.0f, contact.point1[0], 0.0001f);
+  EXPECT_NEAR(0.5f, contact.point2[0], 0.0001f);
+
+  // equal cubes
+  contact = cube.contact(identity, cube, identity, cache);
+  EXPECT_TRUE(contact.intersecting);
+  EXPECT_NEAR(2.0f, contact.distance, 0.0001f);
+}
+
+// the closest points define a separating slab, the penetration depth is the shortest separating translation
+TEST(CONVEX_VERTICES, RandomPointClouds) {
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> angle(0.0f, 2.0f * M_PI);
+  size_t separated = 0u, intersecting = 0u;
+  for (size_t round = 0; round < 200u; round++) {
+    std::array<std::vector<Vector3df>, 2u> points;
+    for (auto & cloud : points) {
+      for (size_t i = 0; i < 30u; i++) {
+        cloud.push_back({coordinate(generator), coordinate(generator), coordinate(generator)});
+      }
+    }
+    ConvexVertices3df shape1(points[0]), shape2(points[1]);
+    Affine3f transformation1({coordinate(generator), coordinate(generator), coordinate(generator)},
+                             rotation(angle(generator), angle(generator)), 1.0f);
+    Affine3f transformation2({2.0f * coordinate(generator), 2.0f * coordinate(generator), 2.0f * coordinate(generator)},
+                             rotation(angle(generator), angle(generator)), 0.5f);
+    GJKCache3df cache;
+    ConvexContact3df contact = shape1.contact(transformation1, shape2, transformation2, cache);
+    GJKCache3df cold;
+    EXPECT_EQ(contact.intersecting, shape1.intersects(transformation1, shape2, transformation2, cold));
+    EXPECT_NEAR(1.0f, contact.normal.length(), 0.0001f);
+    if (!contact.intersecting) {
+      separated++;
+      EXPECT_NEAR(contact.distance, (contact.point2 - contact.point1).length(), 0.0001f);
+      float plane1 = contact.normal * contact.point1;
+      float plane2 = contact.normal * contact.point2;
+      for (const auto & point : points[0]) {
+        EXPECT_LE(contact.normal * (transformation1 * point), plane1 + 0.0001f);
+      }
+      for (const auto & point : points[1]) {
+        EXPECT_GE(contact.normal * (transformation2 * point), plane2 - 0.0001f);
+      }
+    } else {
+      intersecting++;
+      Affine3f apart(transformation2.get_linear(),
+                       transformation2.get_translation() + (contact.distance + 0.001f) * contact.normal);
+      Affine3f deeper(transformation2.get_linear(),
+                      transformation2.get_translation() + (0.95f * contact.distance) * contact.normal);
+      EXPECT_FALSE(shape1.intersects(transformation1, shape2, apart, cold));
+      EXPECT_TRUE(shape1.intersects(transformation1, shape2, deeper, cold));
+    }
+  }
+  EXPECT_GT(separated, 20u);
+  EXPECT_GT(intersecting, 20u);
+}
+
+// persistent pairs moving slightly per frame, the cached simplex needs fewer support evaluations
+TEST(CONVEX_VERTICES, WarmStartEqualsColdStart) {
+  std::vector<Vector3df> corners = cube_corners();
+  ConvexVertices3df cube(corners);
+  Affine3f identity;
+  GJKCache3df warm, warm_contact;
+  size_t warm_iterations = 0u, cold_iterations = 0u;
+  for (size_t frame = 0; frame < 200u; frame++) {
+    float t = 0.01f * frame;
+    Affine3f moving({2.5f * std::cos(t), 1.5f * std::sin(t), 0.3f}, rotation(t, 0.5f * t), 1.0f);
+    GJKCache3df cold;
+    bool intersects = cube.intersects(identity, cube, moving, cold);
+    cold_iterations += cold.iterations;
+    EXPECT_EQ(intersects, cube.intersects(identity, cube, moving, warm));
+    warm_iterations += warm.iterations;
+
+    ConvexContact3df expected = cube.contact(identity, cube, moving, cold);
+    ConvexContact3df contact = cube.contact(identity, cube, moving, warm_contact);
+    EXPECT_EQ(expected.intersecting, contact.intersecting);
+    EXPECT_NEAR(expected.distance, contact.distance, 0.0001f);
+  }
+  EXPECT_LT(warm_iterations, cold_iterations);
+}
+
+TEST(TRIANGLE, ClosestPoint) {
+  Triangle3df triangle({0.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f});
+  std::array<std::array<Vector3df, 2u>, 6u> expected = {{
+    { Vector3df{0.5f, 0.5f, 3.0f}, Vector3df{0.5f, 0.5f, 0.0f} },     // face
+    { Vector3df{-1.0f, -1.0f, 1.0f}, Vector3df{0.0f, 0.0f, 0.0f} },   // point a
+    { Vector3df{3.0f, -0.5f, 0.0f}, Vector3df{2.0f, 0.0f, 0.0f} },    // point b
+    { Vector3df{1.0f, -1.0f, -2.0f}, Vector3df{1.0f, 0.0f, 0.0f} },   // edge ab
+    { Vector3df{-1.0f, 1.5f, 0.0f}, Vector3df{0.0f, 1.5f, 0.0f} },    // edge ac
+    { Vector3df{2.0f, 2.0f, 1.0f}, Vector3df{1.0f, 1.0f, 0.0f} }      // edge bc
+  }};
+  for (const auto & [point, closest] : expected) {
+    Vector3df result = triangle.closest_point(point);
+    for (size_t i = 0; i < 3u; i++) {
+      EXPECT_NEAR(closest[i], result[i], 0.00001f);
+    }
+  }
+  Triangle3df degenerated({1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+  EXPECT_NEAR(0.0f, (degenerated.closest_point({3.0f, 0.0f, 0.0f}) - Vector3df{1.0f, 1.0f, 1.0f}).length(), 0.00001f);
+}
+
+// the twelve triangles of the cube [-1, 1]^3
+std::vector<Triangle3df> cube_triangles() {
+  std::vector<Vector3df> c = cube_corners();  // index = 4 * (x > 0) + 2 * (y > 0) + (z > 0)
+  const std::array<std::array<size_t, 4u>, 6u> faces = {{ {0, 1, 3, 2}, {4, 6, 7, 5}, {0, 4, 5, 1},
+                                                           {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 5, 7, 3} }};
+  std::vector<Triangle3df> triangles;
+  for (const auto & f : faces) {
+    triangles.push_back(Triangle3df(c[f[0]], c[f[1]], c[f[2]]));
+    triangles.push_back(Triangle3df(c[f[0]], c[f[2]], c[f[3]]));
+  }
+  return triangles;
+}
+
+// a torus around the z axis with the radius 1 of the center circle and the radius of the tube 0.4
+constexpr float TORUS_RADIUS = 1.0f;
+constexpr float TUBE_RADIUS = 0.4f;
+
+std::vector<Triangle3df> torus_triangles(size_t segments, size_t tube_segments) {
+  auto point = [segments, tube_segments](size_t i, size_t j) {
+    float phi = 2.0f * M_PI * i / segments, theta = 2.0f * M_PI * j / tube_segments;
+    float distance = TORUS_RADIUS + TUBE_RADIUS * std::cos(theta);
+    return Vector3df{distance * std::cos(phi), distance * std::sin(phi), TUBE_RADIUS * std::sin(theta)};
+  };
+  std::vector<Triangle3df> triangles;
+  for (size_t i = 0; i < segments; i++) {
+    for (size_t j = 0; j < tube_segments; j++) {
+      triangles.push_back(Triangle3df(point(i, j), point(i + 1, j), point(i + 1, j + 1)));
+      triangles.push_back(Triangle3df(point(i, j), point(i + 1, j + 1), point(i, j + 1)));
+    }
+  }
+  return triangles;
+}
+
+// compares the field with the exact signed distance clamped to the band at random points of [-size, size]^3
+void expect_field_equals(const SignedDistanceField3df & field, float size, float tolerance,
+                         const std::function<float(const Vector3df &)> & exact) {
+  std::mt19937 generator(13);
+  std::uniform_real_distribution<float> coordinate(-size, size);
+  size_t inside = 0u, near = 0u;
+  for (size_t i = 0; i < 5000u; i++) {
+    Vector3df point = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    float expected = std::clamp(exact(point), -field.get_band(), field.get_band());
+    EXPECT_NEAR(expected, field.distance(point), tolerance);
+    inside += expected < 0.0f;
+    near += std::abs(expected) < field.get_band();
+  }
+  EXPECT_GT(inside, 100u);
+  EXPECT_GT(near, 100u);
+}
+
+TEST(SIGNED_DISTANCE_FIELD, Cube) {
+  SignedDistanceField3df field(cube_triangles(), 0.05f, 0.2f);
+  expect_field_equals(field, 2.0f, 0.05f, [](const Vector3df & p) {
+    Vector3df outside;
+    float largest = -INFINITY;
+    for (size_t i = 0; i < 3u; i++) {
+      outside[i] = std::max(std::abs(p[i]) - 1.0f, 0.0f);
+      largest = std::max(largest, std::abs(p[i]) - 1.0f);
+    }
+    return largest > 0.0f ? outside.length() : largest;
+  });
+  EXPECT_FLOAT_EQ(-0.2f, field.distance({0.0f, 0.0f, 0.0f}));
+  EXPECT_FLOAT_EQ(0.2f, field.distance({10.0f, 0.0f, 0.0f}));
+  EXPECT_NEAR(0.1f, field.distance({0.3f, 1.1f, -0.1f}), 0.00001f);
+  EXPECT_NEAR(-0.1f, field.distance({0.3f, 0.4f, 0.9f}), 0.00001f);
+  // 7 x 7 x 7 bricks from -1.25 to 1.55, the 3 x 3 x 3 at the center are inside,
+  // the 19 at the three edges through the corner (1.55, 1.55, 1.55) are outside
+  EXPECT_EQ(7u * 7u * 7u - 3u * 3u * 3u - 19u, field.stored_bricks());
+
+  EXPECT_TRUE(field.intersects(Sphere3df({0.0f, 1.05f, 0.0f}, 0.1f)));
+  EXPECT_FALSE(field.intersects(Sphere3df({0.0f, 1.15f, 0.0f}, 0.1f)));
+  EXPECT_TRUE(field.intersects(Sphere3df({0.0f, 0.0f, 0.0f}, 0.1f)));
+}
+
+TEST(SIGNED_DISTANCE_FIELD, Torus) {
+  SignedDistanceField3df field(torus_triangles(48u, 24u), 0.1f, 0.2f);
+  expect_field_equals(field, 1.6f, 0.03f, [](const Vector3df & p) {
+    Vector2df tube = {std::sqrt(p[0] * p[0] + p[1] * p[1]) - TORUS_RADIUS, p[2]};
+    return tube.length() - TUBE_RADIUS;
+  });
+  // the hole is outside
+  EXPECT_FLOAT_EQ(0.2f, field.distance({0.0f, 0.0f, 0.0f}));
+}
+
+TEST(SIGNED_DISTANCE_FIELD, ThreadsEqualOneThread) {
+  std::vector<Triangle3df> triangles = torus_triangles(24u, 12u);
+  std::stringstream one, four;
+  EXPECT_TRUE(SignedDistanceField3df(triangles, 0.1f, 0.2f, 1u).save(one));
+  EXPECT_TRUE(SignedDistanceField3df(triangles, 0.1f, 0.2f, 4u).save(four));
+  EXPECT_EQ(one.str(), four.str());
+}
+
+TEST(SIGNED_DISTANCE_FIELD, SaveLoad) {
+  SignedDistanceField3df field(torus_triangles(24u, 12u), 0.1f, 0.2f);
+  std::stringstream stream;
+  EXPECT_TRUE(field.save(stream));
+  SignedDistanceField3df loaded;
+  EXPECT_FLOAT_EQ(0.0f, loaded.distance({1.0f, 0.0f, 0.0f}));
+  EXPECT_TRUE(loaded.load(stream));
+  EXPECT_EQ(field.stored_bricks(), loaded.stored_bricks());
+  EXPECT_FLOAT_EQ(field.get_band(), loaded.get_band());
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<float> coordinate(-1.6f, 1.6f);
+  for (size_t i = 0; i < 1000u; i++) {
+    Vector3df point = {coordinate(generator), coordinate(generator), coordinate(generator)};
+    EXPECT_EQ(field.distance(point), loaded.distance(point));
+  }
+
+  // a truncated file is rejected, the field is kept
+  std::string data = stream.str();
+  std::stringstream truncated(data.substr(0, data.size() / 2u));
+  EXPECT_FALSE(loaded.load(truncated));
+  std::stringstream other("not a signed distance field");
+  EXPECT_FALSE(loaded.load(other));
+
+  // a header with huge counts (52 bytes, the brick counts at offset 32, the number of values at 44)
+  // fails at the end of the stream instead of allocating the counts
+  const std::array<uint32_t, 3u> huge_bricks = {4000000000u, 4000000000u, 4000000000u};
+  std::string header = data.substr(0, 52u);
+  std::memcpy(header.data() + 32u, huge_bricks.data(), sizeof(huge_bricks));
+  std::stringstream huge_brick_header(header);
+  EXPECT_FALSE(loaded.load(huge_brick_header));
+  constexpr uint64_t brick_points = (SignedDistanceField3df::BRICK + 1u) * (SignedDistanceField3df::BRICK + 1u)
+                                    * (SignedDistanceField3df::BRICK + 1u);
+  const uint64_t huge_values = brick_points * (uint64_t{1u} << 50u);
+  header = data.substr(0, 52u);
+  std::memcpy(header.data() + 44u, &huge_values, sizeof(huge_values));
+  std::stringstream huge_value_header(header + data.substr(52u));
+  EXPECT_FALSE(loaded.load(huge_value_header));
+  EXPECT_EQ(field.distance({1.3f, 0.1f, 0.05f}), loaded.distance({1.3f, 0.1f, 0.05f}));
+}
+
+TEST(SPHERE, MinimalOfPoints) {
+  // the center of the cube is the center of the smallest sphere, inner points do not change it
+  std::vector<Vector3df> points = cube_corners();
+  points.push_back({0.5f, -0.25f, 0.75f});
+  points.push_back({0.0f, 0.0f, 0.0f});
+  Sphere3df sphere(points);
+  EXPECT_NEAR(0.0f, sphere.get_center().length(), 0.0001f);
+  EXPECT_NEAR(std::sqrt(3.0f), sphere.get_radius(), 0.0001f);
+
+  // an obtuse triangle is enclosed by the circle over its longest side
+  std::vector<Vector2df> triangle = { {-2.0f, 0.0f}, {2.0f, 0.0f}, {0.5f, 0.5f} };
+  Sphere2df circle(triangle);
+  EXPECT_NEAR(0.0f, circle.get_center().length(), 0.0001f);
+  EXPECT_NEAR(2.0f, circle.get_radius(), 0.0001f);
+
+  // a single and repeated points
+  std::vector<Vector3df> single = { {1.0f, 2.0f, 3.0f}, {1.0f, 2.0f, 3.0f} };
+  Sphere3df point(single);
+  EXPECT_NEAR(0.0f, (point.get_center() - single[0]).length(), 0.0001f);
+  EXPECT_NEAR(0.0f, point.get_radius(), 0.0001f);
+}
+
+// the smallest circle has two or three of the points on its boundary
+TEST(SPHERE, MinimalEqualsBruteForce) {
+  std::mt19937 generator(13);
+  std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+  for (size_t round = 0; round < 50u; round++) {
+    std::vector<Vector2df> points;
+    for (size_t i = 0; i < 12u; i++) {
+      points.push_back({coordinate(generator), 0.5f * coordinate(generator)});
+    }
+    auto encloses = [&points](Vector2df center, float radius) {
+      return std::all_of(points.begin(), points.end(),
+                         [&](const Vector2df & p) { return (p - center).length() <= radius * 1.0001f; });
+    };
+    float minimum = INFINITY;
+    for (size_t i = 0; i < points.size(); i++) {
+      for (size_t j = i + 1u; j < points.size(); j++) {
+        Vector2df center = 0.5f * (points[i] + points[j]);
+        float radius = (points[i] - center).length();
+        if (encloses(center, radius)) {
+          minimum = std::min(minimum, radius);
+        }
+        for (size_t k = j + 1u; k < points.size(); k++) {
+          // the circumcenter solves 2 (b - a) * center = b^2 - a^2 and 2 (c - a) * center = c^2 - a^2
+          Vector2df ab = points[j] - points[i], ac = points[k] - points[i];
+          float determinant = 2.0f * (ab[0] * ac[1] - ab[1] * ac[0]);
+          if (std::abs(determinant) < 1e-6f) {
+            continue;
+          }
+          float b = ab * ab, c = ac * ac;
+          Vector2df offset = {(ac[1] * b - ab[1] * c) / determinant, (ab[0] * c - ac[0] * b) / determinant};
+          if (encloses(points[i] + offset, offset.length())) {
+            minimum = std::min(minimum, offset.length());
+          }
+        }
+      }
+    }
+    Sphere2df circle(points);
+    EXPECT_NEAR(minimum, circle.get_radius(), 0.0001f);
+    for (const Vector2df & point : points) {
+      EXPECT_TRUE(circle.inside(point));
+    }
+  }
+
+  // in 3D at least two points are on the surface of the enclosing sphere
+  for (size_t round = 0; round < 20u; round++) {
+    std::vector<Vector3df> points;
+    for (size_t i = 0; i < 1000u; i++) {
+      points.push_back({coordinate(generator), 2.0f * coordinate(generator), 0.5f * coordinate(generator)});
+    }
+    Sphere3df sphere(points);
+    size_t on_surface = 0u;
+    for (const Vector3df & point : points) {
+      EXPECT_TRUE(sphere.inside(point));
+      on_surface += (point - sphere.get_center()).length() >= sphere.get_radius() * 0.9999f;
+    }
+    EXPECT_GE(on_surface, 2u);
+    EXPECT_LE(sphere.get_radius(), AABB3df(points).get_half_edge_length().length());
+  }
+}
+
+TEST(AABB, FromPoints) {
+  std::vector<Vector3df> points = { {1.0f, -2.0f, 0.5f}, {3.0f, 0.0f, -0.5f}, {2.0f, 4.0f, 0.0f} };
+  AABB3df box(points);
+  EXPECT_NEAR(0.0f, (box.get_center() - Vector3df{2.0f, 1.0f, 0.0f}).length(), 0.0001f);
+  EXPECT_NEAR(0.0f, (box.get_half_edge_length() - Vector3df{1.0f, 3.0f, 0.5f}).length(), 0.0001f);
+}
+
+// the principal axes of the corners of a rotated box are its edges
+TEST(ORIENTED_BOUNDING_BOX, RotatedBox) {
+  SquareMatrix3df rotated = rotation(0.4f, 1.1f);
+  Vector3df position = {1.0f, -2.0f, 0.5f}, half = {3.0f, 1.0f, 0.5f};
+  std::vector<Vector3df> points;
+  for (const Vector3df & corner : cube_corners()) {
+    points.push_back(position + rotated * Vector3df{half[0] * corner[0], half[1] * corner[1], half[2] * corner[2]});
+  }
+  MeshBounds3df bounds(points);
+  const OBB3df & box = bounds.oriented;
+  EXPECT_NEAR(0.0f, (box.get_center() - position).length(), 0.0001f);
+  EXPECT_NEAR(12.0f, box.volume(), 0.001f);
+  EXPECT_NEAR(1.0f, box.get_axes().determinant(), 0.0001f);
+  for (size_t i = 0; i < 3u; i++) {
+    // the axes are in the order of the eigenvalues, find the matching edge
+    Vector3df axis = box.get_axes()[i];
+    size_t edge = 0u;
+    for (size_t j = 1u; j < 3u; j++) {
+      if (std::abs(axis * rotated[j]) > std::abs(axis * rotated[edge])) {
+        edge = j;
+      }
+    }
+    EXPECT_NEAR(1.0f, std::abs(axis * rotated[edge]), 0.0001f);
+    EXPECT_NEAR(half[edge], box.get_half_edge_length()[i], 0.0001f);
+  }
+  OBB3df grown(box.get_center(), box.get_axes(), 1.0001f * box.get_half_edge_length());
+  for (const Vector3df & point : points) {
+    EXPECT_TRUE(grown.inside(point));
+    EXPECT_TRUE(bounds.sphere.inside(point));
+  }
+  EXPECT_FALSE(box.inside(position + 3.1f * rotated[0]));
+
+  // the aabb of the box encloses the aabb of the points
+  AABB3df outer = box.bounding_box();
+  for (size_t i = 0; i < 3u; i++) {
+    EXPECT_LE(bounds.box.get_half_edge_length()[i], outer.get_half_edge_length()[i] + 0.0001f);
+  }
+  EXPECT_NEAR(half.length(), bounds.sphere.get_radius(), 0.0001f);
+}
+
 TEST(FRESNEL, Refract_1) {
   Vector3df eye = {0.0f, 0.0f, 0.0f};
   Vector3df direction = {0.0f, -1.0f, 0.0f};
@@ -5,46 +5,83 @@
 #include <array>
 #include <cstddef>
 #include <cmath>
+#include <span>
+#include <utility>
+#include <vector>
+
+// the 3- and 4-dimensional float vectors are accelerated with SSE instructions,
+// compile with -DMATH_NO_SIMD to use the generic template implementation instead
+#if defined(__SSE2__) && ! defined(MATH_NO_SIMD)
+#define MATH_SIMD 1
+#endif
+
+#ifdef MATH_SIMD
+#include <emmintrin.h>
+#endif
+
+// storage layout of a Vector: number of stored scalar values and their alignment
+// SSE accelerated vectors are padded to a full 16 byte register,
+// the padding value is always kept at zero
+template<class FLOAT_TYPE, size_t N>
+struct VectorStorage {
+  static constexpr size_t size = N;
+  static constexpr size_t alignment = alignof(FLOAT_TYPE);
+};
+
+#ifdef MATH_SIMD
+template<>
+struct VectorStorage<float, 3u> {
+  static constexpr size_t size = 4u;
+  static constexpr size_t alignment = 16u;
+};
+
+template<>
+struct VectorStorage<float, 4u> {
+  static constexpr size_t size = 4u;
+  static constexpr size_t alignment = 16u;
+};
+#endif
 
 // A Vector consisting of N scalar values of type FLOAT_TYPE
 template<class FLOAT_TYPE, size_t N>
 struct Vector {
   static_assert(N > 0u); // no zero length vectors allowed
   
-  // stores the N scalar values of this Vector
+  // stores the N scalar values of this Vector (plus padding, see VectorStorage)
   // index 0, 1, 2, ... corresponds to x,y,z,... axis
-  std::array<FLOAT_TYPE, N> vector;
+  alignas(VectorStorage<FLOAT_TYPE, N>::alignment)
+  std::array<FLOAT_TYPE, VectorStorage<FLOAT_TYPE, N>::size> vector{};
 
   // Aufgabe_3 - Default-Konstruktor
-  Vector();
+  constexpr Vector();
 
   // creates a new Vector with the given scalar values
   // if values is empty, then this->vector is initilized with zeros
   // if less than N values are given, then all remaining values of this->vector
   //   are initialized with the last given value 
-  Vector( std::initializer_list<FLOAT_TYPE> values );
+  constexpr Vector( std::initializer_list<FLOAT_TYPE> values );
   
   // creates a unit vector pointing to the given angle (in radians) in the x/y plane
   // angle = 0 points in the direction of the x-axis
   explicit Vector(FLOAT_TYPE angle);
 
   // adds addend to this Vector and returns the resulting sum
-  Vector & operator+=(const Vector addend);
+  constexpr Vector & operator+=(const Vector addend);
 
   // subtracts minuend from this Vector and returns the resulting difference
-  Vector & operator-=(const Vector minuend);
+  constexpr Vector & operator-=(const Vector minuend);
 
   // multiplies the scalar factor to this vector and returns the result
-  Vector & operator*=(const FLOAT_TYPE factor);
+  constexpr Vector & operator*=(const FLOAT_TYPE factor);
 
   // divides this vector by the given factor and returns the result
-  Vector & operator/=(const FLOAT_TYPE factor);
+  constexpr Vector & operator/=(const FLOAT_TYPE factor);
 
   // returns the reference of the i-th scalar component of this vector      
-  FLOAT_TYPE & operator[](std::size_t i);
+  constexpr FLOAT_TYPE & operator[](std::size_t i);
 
   // returns the i-th scalar component of this Vector
-  FLOAT_TYPE operator[](std::size_t i) const;
+  constexpr FLOAT_TYPE operator[](std::size_t i) const;
 
   // returns the i-th scalar component of this Vector
   // throws an exception if i >= N
@@ -55,43 +92,128 @@ struct Vector {
   
   // returns the specular reflective "ray" Vector wrt the give normal vector
   // normal must be a normalized vector
-  Vector get_reflective(Vector normal) const;
+  constexpr Vector get_reflective(Vector normal) const;
   
   // returns the angle of this Vector between the two given axis in radians
   FLOAT_TYPE angle(size_t axis_1, size_t axis_2) const;
 
   // returns the cross product of this Vector with the Vector v
   // only three-dimensional case
-  Vector<FLOAT_TYPE, 3u> cross_product(const Vector<FLOAT_TYPE, 3u> v) const;
+  constexpr Vector<FLOAT_TYPE, 3u> cross_product(const Vector<FLOAT_TYPE, 3u> v) const;
   
   // returns the scalar product of the given scalar and value
   template <class F, size_t K>    
-  friend Vector<F, K> operator*(F scalar, Vector<F, K> value);
+  friend constexpr Vector<F, K> operator*(F scalar, Vector<F, K> value);
 
   // returns the vector sum of the to given vectors
   template <class F, size_t K>    
-  friend Vector<F, K> operator+(const Vector<F, K> value, const Vector<F, K> addend);
+  friend constexpr Vector<F, K> operator+(const Vector<F, K> value, const Vector<F, K> addend);
 
   // returns the vector difference value - minuend
   template <class F, size_t K>    
-  friend Vector<F, K> operator-(const Vector<F, K> value, const Vector<F, K> minuend);
+  friend constexpr Vector<F, K> operator-(const Vector<F, K> value, const Vector<F, K> minuend);
 
   // returns the (euclidian) length of this Vector
   FLOAT_TYPE length() const;
   
   // returns the square of the this Vector's length
-  FLOAT_TYPE square_of_length() const;
+  constexpr FLOAT_TYPE square_of_length() const;
 
   // returns the scalar (inner) product of two Vectors
   template <class F, size_t K>    
-  friend F operator*(Vector<F, K> vector1, const Vector<F, K> vector2);
+  friend constexpr F operator*(Vector<F, K> vector1, const Vector<F, K> vector2);
 };
 
-static const long double PI = std::acos(-1.0L);
+inline constexpr long double PI = 3.141592653589793238462643383279502884L;
 
 // shorter comfortable type names
 typedef Vector<float, 2u> Vector2df;
 typedef Vector<float, 3u> Vector3df;
 typedef Vector<float, 4u> Vector4df;
 
+// fast float approximations, for callers that opt in where the accuracy is sufficient
+// the maximum errors are measured against the double precision libm functions
+// (see math_test.cc), the arguments of sin, cos and sincos must be within [-8192, 8192]
+namespace fast {
+
+// 1 / sqrt(x) from the SSE estimate refined by one Newton-Raphson step
+// max. relative error 3.0e-7 (1 / std::sqrt(x) without SSE)
+float rsqrt(float x);
+
+// range reduction to [-PI/4, PI/4] and minimax polynomials (from the Cephes library)
+// max. absolute error 1.2e-7
+float sin(float x);
+float cos(float x);
+void sincos(float x, float & sin, float & cos);
+
+// octant reduction to [0, tan(PI/8)] and a minimax polynomial (from the Cephes library)
+// max. absolute error 3.0e-7 radians, atan2(0, 0) returns 0
+float atan2(float y, float x);
+
+// normalizes v to the length 1 using rsqrt
+// vectors shorter than about 1e-19 are normalized by Vector::normalize, a zero vector becomes NaN like there
+template <size_t N>
+void normalize(Vector<float, N> & v);
+
+// returns the unit vector pointing to the given angle in the x/y plane
+// like Vector(FLOAT_TYPE angle), but using sincos
+template <size_t N>
+Vector<float, N> unit_vector(float angle);
+
+}
+
+// N-dimensional vectors stored as a structure of arrays:
+// the i-th component of all vectors is stored in one contiguous stream,
+// so the bulk kernels below process several vectors per (SSE) instruction
+template<class FLOAT_TYPE, size_t N>
+class VectorArray {
+  static_assert(N > 0u);
+  std::array<std::vector<FLOAT_TYPE>, N> streams;
+public:
+  // creates size zero vectors
+  explicit VectorArray(size_t size = 0u);
+
+  // returns the number of stored vectors
+  size_t size() const;
+
+  void resize(size_t size);
+
+  void push_back(Vector<FLOAT_TYPE, N> vector);
+
+  // returns the i-th vector
+  Vector<FLOAT_TYPE, N> get(size_t i) const;
+
+  void set(size_t i, Vector<FLOAT_TYPE, N> vector);
+
+  // returns the stream of all values of the given axis
+  std::span<FLOAT_TYPE> stream(size_t axis);
+  std::span<const FLOAT_TYPE> stream(size_t axis) const;
+
+  // adds factor * x to this VectorArray (x must have the same size)
+  void axpy(FLOAT_TYPE factor, const VectorArray & x);
+
+  // multiplies all vectors with the given factor
+  void scale(FLOAT_TYPE factor);
+
+  // stores the scalar product of each vector with v in result[i]
+  void dot(Vector<FLOAT_TYPE, N> v, std::span<FLOAT_TYPE> result) const;
+
+  // stores the (euclidian) length of each vector in result[i]
+  void lengths(std::span<FLOAT_TYPE> result) const;
+
+  // normalizes all vectors to the length 1
+  void normalize_all();
+
+  // wraps vectors that left the box [0, box[axis]] to the opposite side,
+  // a value < 0 is set to box[axis], a value > box[axis] is set to 0
+  void wrap_into_box(Vector<FLOAT_TYPE, N> box);
+};
+
+typedef VectorArray<float, 2u> VectorArray2df;
+typedef VectorArray<float, 3u> VectorArray3df;
+typedef VectorArray<float, 4u> VectorArray4df;
+
+// definitions are needed in every translation unit to allow constant evaluation
+#include "math.tcc"
+
 #endif
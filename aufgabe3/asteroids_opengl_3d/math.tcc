@@ -1,15 +1,74 @@
+#include <algorithm>
 #include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#ifdef MATH_SIMD
+// SSE implementations of the per-component loops for Vector<float, 3u> and Vector<float, 4u>
+// they are only used at runtime, constant evaluation uses the generic loops
+namespace simd {
+
+template <class FLOAT_TYPE, size_t N>
+inline constexpr bool accelerated = std::is_same_v<FLOAT_TYPE, float> && (N == 3u || N == 4u);
+
+template <size_t N>
+inline __m128 load(const Vector<float, N> & v) {
+  return _mm_load_ps(v.vector.data());
+}
+
+template <size_t N>
+inline void store(Vector<float, N> & v, __m128 value) {
+  _mm_store_ps(v.vector.data(), value);
+}
+
+// sum of all four values of the register
+inline float horizontal_sum(__m128 value) {
+  __m128 shuffled = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+  __m128 sums = _mm_add_ps(value, shuffled);
+  shuffled = _mm_movehl_ps(shuffled, sums);
+  sums = _mm_add_ss(sums, shuffled);
+  return _mm_cvtss_f32(sums);
+}
+
+template <size_t N>
+inline float dot(const Vector<float, N> & vector1, const Vector<float, N> & vector2) {
+  return horizontal_sum(_mm_mul_ps(load(vector1), load(vector2)));
+}
+
+// the padding of a Vector<float, 3u> stays zero
+template <size_t N>
+inline __m128 clear_padding(__m128 value) {
+  if constexpr (N == 3u) {
+    value = _mm_and_ps(value, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+  }
+  return value;
+}
+
+template <size_t N>
+inline void scale(Vector<float, N> & v, float factor) {
+  store(v, clear_padding<N>(_mm_mul_ps(load(v), _mm_set1_ps(factor)))); // 0.0 * inf would be NaN
+}
+
+template <size_t N>
+inline void divide(Vector<float, N> & v, float factor) {
+  store(v, clear_padding<N>(_mm_div_ps(load(v), _mm_set1_ps(factor)))); // 0.0 / 0.0 would be NaN
+}
+
+}
+#endif
 
 // Aufgabe_3 - Default-Konstruktor
 template <class FLOAT_TYPE, size_t N>
-Vector<FLOAT_TYPE, N>::Vector() {
+constexpr Vector<FLOAT_TYPE, N>::Vector() {
     for (size_t i = 0u; i < N; ++i) {
         vector[i] = 0;
     }
 }
 
 template <class FLOAT_TYPE, size_t N>
-Vector<FLOAT_TYPE, N>::Vector( std::initializer_list<FLOAT_TYPE> values ) {
+constexpr Vector<FLOAT_TYPE, N>::Vector( std::initializer_list<FLOAT_TYPE> values ) {
   auto iterator = values.begin();
   for (size_t i = 0u; i < N; i++) {
     if ( iterator != values.end()) {
@@ -25,32 +84,64 @@ Vector<FLOAT_TYPE, N>::Vector(FLOAT_TYPE angle ) {
   *this = { static_cast<FLOAT_TYPE>( cos(angle) ), static_cast<FLOAT_TYPE>(sin(angle)) };
 }
 
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator+=(const Vector<FLOAT_TYPE, N> addend) {
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator+=(const Vector<FLOAT_TYPE, N> addend) {
+#ifdef MATH_SIMD
+  if constexpr (simd::accelerated<FLOAT_TYPE, N>) {
+    if (! std::is_constant_evaluated()) {
+      simd::store(*this, _mm_add_ps(simd::load(*this), simd::load(addend)));
+      return *this;
+    }
+  }
+#endif
   for (size_t i = 0u; i < N; i++) {
     vector[i] += addend.vector[i];
   }
   return *this;
 }
 
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator-=(const Vector<FLOAT_TYPE, N> minuend) {
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator-=(const Vector<FLOAT_TYPE, N> minuend) {
+#ifdef MATH_SIMD
+  if constexpr (simd::accelerated<FLOAT_TYPE, N>) {
+    if (! std::is_constant_evaluated()) {
+      simd::store(*this, _mm_sub_ps(simd::load(*this), simd::load(minuend)));
+      return *this;
+    }
+  }
+#endif
   for (size_t i = 0u; i < N; i++) {
     vector[i] -= minuend.vector[i];
   }
   return *this;
 }
 
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator*=(const FLOAT_TYPE factor) {
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator*=(const FLOAT_TYPE factor) {
+#ifdef MATH_SIMD
+  if constexpr (simd::accelerated<FLOAT_TYPE, N>) {
+    if (! std::is_constant_evaluated()) {
+      simd::scale(*this, factor);
+      return *this;
+    }
+  }
+#endif
   for (size_t i = 0u; i < N; i++) {
     vector[i] *= factor;
   }
   return *this;
 }
 
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator/=(const FLOAT_TYPE factor) {
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator/=(const FLOAT_TYPE factor) {
+#ifdef MATH_SIMD
+  if constexpr (simd::accelerated<FLOAT_TYPE, N>) {
+    if (! std::is_constant_evaluated()) {
+      simd::divide(*this, factor);
+      return *this;
+    }
+  }
+#endif
   for (size_t i = 0u; i < N; i++) {
     vector[i] /= factor;
   }
@@ -58,8 +149,8 @@ Vector<FLOAT_TYPE, N> & Vector<FLOAT_TYPE, N>::operator/=(const FLOAT_TYPE facto
 }
 
 
-template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value) {
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value) {
   Vector<FLOAT_TYPE, N> scalar_product = value;
 
   scalar_product *= scalar;
@@ -67,46 +158,54 @@ Vector<FLOAT_TYPE, N> operator*(FLOAT_TYPE scalar, Vector<FLOAT_TYPE, N> value)
   return scalar_product;
 }
 
-template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator+(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> addend) {
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N> operator+(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> addend) {
   Vector<FLOAT_TYPE, N> sum = value;
   sum += addend;
   return sum;
 }
 
-template <class FLOAT_TYPE, size_t N>    
-Vector<FLOAT_TYPE, N> operator-(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> minuend) {
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N> operator-(const Vector<FLOAT_TYPE, N> value, const Vector<FLOAT_TYPE, N> minuend) {
   Vector<FLOAT_TYPE, N> difference = value;
   difference -= minuend;
   return difference;
 }
 
-template <class FLOAT_TYPE, size_t N>  
-FLOAT_TYPE & Vector<FLOAT_TYPE, N>::operator[](std::size_t i) {
+template <class FLOAT_TYPE, size_t N>
+constexpr FLOAT_TYPE & Vector<FLOAT_TYPE, N>::operator[](std::size_t i) {
+  return vector[i];
+}
+
+template <class FLOAT_TYPE, size_t N>
+constexpr FLOAT_TYPE Vector<FLOAT_TYPE, N>::operator[](std::size_t i) const {
   return vector[i];
 }
 
-template <class FLOAT_TYPE, size_t N>  
-FLOAT_TYPE Vector<FLOAT_TYPE, N>::operator[](std::size_t i) const {
+template <class FLOAT_TYPE, size_t N>
+FLOAT_TYPE Vector<FLOAT_TYPE, N>::at(std::size_t i) const {
+  if (i >= N) {
+    throw std::out_of_range("Vector::at: index " + std::to_string(i) + " >= " + std::to_string(N));
+  }
   return vector[i];
 }
 
 
 template <class FLOAT_TYPE, size_t N>
-Vector<FLOAT_TYPE, 3u> Vector<FLOAT_TYPE, N>::cross_product(const Vector<FLOAT_TYPE, 3u> v) const {
+constexpr Vector<FLOAT_TYPE, 3u> Vector<FLOAT_TYPE, N>::cross_product(const Vector<FLOAT_TYPE, 3u> v) const {
   assert(N >= 3u);
   return {this->vector[1] * v.vector[2] - this->vector[2] * v.vector[1],
-          this->vector[0] * v.vector[2] - this->vector[2] * v.vector[0],
+          this->vector[2] * v.vector[0] - this->vector[0] * v.vector[2],
           this->vector[0] * v.vector[1] - this->vector[1] * v.vector[0] };
 }
 
-template <class FLOAT_TYPE, size_t N>  
+template <class FLOAT_TYPE, size_t N>
 void Vector<FLOAT_TYPE, N>::normalize() {
   *this /= length(); //  +/- INFINITY if length is (near to) zero
 }
 
-template <class FLOAT_TYPE, size_t N>  
-Vector<FLOAT_TYPE, N> Vector<FLOAT_TYPE, N>::get_reflective(Vector<FLOAT_TYPE, N> normal) const {
+template <class FLOAT_TYPE, size_t N>
+constexpr Vector<FLOAT_TYPE, N> Vector<FLOAT_TYPE, N>::get_reflective(Vector<FLOAT_TYPE, N> normal) const {
   assert(0.99999 < normal.square_of_length() && normal.square_of_length()  < 1.000001);
   return *this - static_cast<FLOAT_TYPE>(2.0) * (*this * normal ) * normal;
 }
@@ -127,24 +226,351 @@ FLOAT_TYPE Vector<FLOAT_TYPE, N>::length() const {
 
 // square of length - Quadrat der Länge eines Vektors
 template<class FLOAT_TYPE, size_t N>
-FLOAT_TYPE Vector<FLOAT_TYPE, N>::square_of_length() const {
-    FLOAT_TYPE sum_of_squares = 0.0;
+constexpr FLOAT_TYPE Vector<FLOAT_TYPE, N>::square_of_length() const {
+    return *this * *this;
+}
 
-    for (size_t i = 0; i < N; i++) {
-        sum_of_squares += vector[i] * vector[i];
+// Templatefunktion, die das Skalarprodukt zweier Vektoren berechnet
+// die Summe wird über eine index_sequence vollständig ausgerollt
+template<class F, size_t K>
+constexpr F operator*(Vector<F, K> vector1, const Vector<F, K> vector2) {
+#ifdef MATH_SIMD
+    if constexpr (simd::accelerated<F, K>) {
+        if (! std::is_constant_evaluated()) {
+            return simd::dot(vector1, vector2);
+        }
     }
+#endif
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+        return (F{0} + ... + (vector1[I] * vector2[I]));
+    }(std::make_index_sequence<K>{});
+}
 
-    return sum_of_squares;
+
+template <class FLOAT_TYPE, size_t N>
+VectorArray<FLOAT_TYPE, N>::VectorArray(size_t size) {
+  resize(size);
 }
 
-// Templatefunktion, die das Skalarprodukt zweier Vektoren berechnet
-template<class F, size_t K>
-F operator*(Vector<F, K> vector1, const Vector<F, K> vector2) {
-    F result = 0.0;
-    for (size_t i = 0u; i < K; i++) {
-        result += vector1[i] * vector2[i];
+template <class FLOAT_TYPE, size_t N>
+size_t VectorArray<FLOAT_TYPE, N>::size() const {
+  return streams[0].size();
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::resize(size_t size) {
+  for (auto & stream : streams) {
+    stream.resize(size);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::push_back(Vector<FLOAT_TYPE, N> vector) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    streams[axis].push_back(vector[axis]);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+Vector<FLOAT_TYPE, N> VectorArray<FLOAT_TYPE, N>::get(size_t i) const {
+  Vector<FLOAT_TYPE, N> vector;
+  for (size_t axis = 0u; axis < N; axis++) {
+    vector[axis] = streams[axis][i];
+  }
+  return vector;
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::set(size_t i, Vector<FLOAT_TYPE, N> vector) {
+  for (size_t axis = 0u; axis < N; axis++) {
+    streams[axis][i] = vector[axis];
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+std::span<FLOAT_TYPE> VectorArray<FLOAT_TYPE, N>::stream(size_t axis) {
+  return streams[axis];
+}
+
+template <class FLOAT_TYPE, size_t N>
+std::span<const FLOAT_TYPE> VectorArray<FLOAT_TYPE, N>::stream(size_t axis) const {
+  return streams[axis];
+}
+
+// all kernels process four vectors per SSE instruction and the remaining ones one by one,
+// the results are the same as those of the scalar loops (no approximations are used),
+// count is kept in a local because stores to the streams could alias the std::vector size
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::axpy(FLOAT_TYPE factor, const VectorArray<FLOAT_TYPE, N> & x) {
+  assert(x.size() == size());
+  const size_t count = size();
+  for (size_t axis = 0u; axis < N; axis++) {
+    FLOAT_TYPE * y_values = streams[axis].data();
+    const FLOAT_TYPE * x_values = x.streams[axis].data();
+    size_t i = 0u;
+#ifdef MATH_SIMD
+    if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+      const __m128 factors = _mm_set1_ps(factor);
+      for (; i + 4u <= count; i += 4u) {
+        __m128 product = _mm_mul_ps(factors, _mm_loadu_ps(x_values + i));
+        _mm_storeu_ps(y_values + i, _mm_add_ps(_mm_loadu_ps(y_values + i), product));
+      }
+    }
+#endif
+    for (; i < count; i++) {
+      y_values[i] += factor * x_values[i];
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::scale(FLOAT_TYPE factor) {
+  const size_t count = size();
+  for (auto & stream : streams) {
+    FLOAT_TYPE * values = stream.data();
+    size_t i = 0u;
+#ifdef MATH_SIMD
+    if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+      const __m128 factors = _mm_set1_ps(factor);
+      for (; i + 4u <= count; i += 4u) {
+        _mm_storeu_ps(values + i, _mm_mul_ps(_mm_loadu_ps(values + i), factors));
+      }
+    }
+#endif
+    for (; i < count; i++) {
+      values[i] *= factor;
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::dot(Vector<FLOAT_TYPE, N> v, std::span<FLOAT_TYPE> result) const {
+  assert(result.size() >= size());
+  const size_t count = size();
+  size_t i = 0u;
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+    __m128 factors[N];
+    const float * values[N];
+    for (size_t axis = 0u; axis < N; axis++) {
+      factors[axis] = _mm_set1_ps(v[axis]);
+      values[axis] = streams[axis].data();
+    }
+    for (; i + 4u <= count; i += 4u) {
+      __m128 sum = _mm_setzero_ps();
+      for (size_t axis = 0u; axis < N; axis++) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(values[axis] + i), factors[axis]));
+      }
+      _mm_storeu_ps(result.data() + i, sum);
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    FLOAT_TYPE sum = 0.0;
+    for (size_t axis = 0u; axis < N; axis++) {
+      sum += streams[axis][i] * v[axis];
+    }
+    result[i] = sum;
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::lengths(std::span<FLOAT_TYPE> result) const {
+  assert(result.size() >= size());
+  const size_t count = size();
+  size_t i = 0u;
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+    for (; i + 4u <= count; i += 4u) {
+      __m128 sum = _mm_setzero_ps();
+      for (size_t axis = 0u; axis < N; axis++) {
+        __m128 values = _mm_loadu_ps(streams[axis].data() + i);
+        sum = _mm_add_ps(sum, _mm_mul_ps(values, values));
+      }
+      _mm_storeu_ps(result.data() + i, _mm_sqrt_ps(sum));
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    FLOAT_TYPE sum = 0.0;
+    for (size_t axis = 0u; axis < N; axis++) {
+      sum += streams[axis][i] * streams[axis][i];
+    }
+    result[i] = std::sqrt(sum);
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::normalize_all() {
+  const size_t count = size();
+  size_t i = 0u;
+#ifdef MATH_SIMD
+  if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+    for (; i + 4u <= count; i += 4u) {
+      __m128 sum = _mm_setzero_ps();
+      for (size_t axis = 0u; axis < N; axis++) {
+        __m128 values = _mm_loadu_ps(streams[axis].data() + i);
+        sum = _mm_add_ps(sum, _mm_mul_ps(values, values));
+      }
+      const __m128 length = _mm_sqrt_ps(sum);
+      for (size_t axis = 0u; axis < N; axis++) {
+        float * values = streams[axis].data() + i;
+        _mm_storeu_ps(values, _mm_div_ps(_mm_loadu_ps(values), length));
+      }
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    FLOAT_TYPE sum = 0.0;
+    for (size_t axis = 0u; axis < N; axis++) {
+      sum += streams[axis][i] * streams[axis][i];
     }
+    const FLOAT_TYPE length = std::sqrt(sum); //  +/- INFINITY if length is (near to) zero
+    for (size_t axis = 0u; axis < N; axis++) {
+      streams[axis][i] /= length;
+    }
+  }
+}
+
+template <class FLOAT_TYPE, size_t N>
+void VectorArray<FLOAT_TYPE, N>::wrap_into_box(Vector<FLOAT_TYPE, N> box) {
+  const size_t count = size();
+  for (size_t axis = 0u; axis < N; axis++) {
+    FLOAT_TYPE * values = streams[axis].data();
+    size_t i = 0u;
+#ifdef MATH_SIMD
+    if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+      const __m128 upper = _mm_set1_ps(box[axis]);
+      const __m128 zero = _mm_setzero_ps();
+      for (; i + 4u <= count; i += 4u) {
+        __m128 value = _mm_loadu_ps(values + i);
+        __m128 below = _mm_cmplt_ps(value, zero);
+        __m128 above = _mm_cmpgt_ps(value, upper);
+        // below -> upper, above -> 0, else unchanged
+        value = _mm_or_ps(_mm_andnot_ps(_mm_or_ps(below, above), value), _mm_and_ps(below, upper));
+        _mm_storeu_ps(values + i, value);
+      }
+    }
+#endif
+    for (; i < count; i++) {
+      if (values[i] < 0) {
+        values[i] = box[axis];
+      } else if (values[i] > box[axis]) {
+        values[i] = 0;
+      }
+    }
+  }
+}
+
+
+namespace fast {
+
+inline float rsqrt(float x) {
+#ifdef MATH_SIMD
+  float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+  return estimate * (1.5f - 0.5f * x * estimate * estimate);
+#else
+  return 1.0f / std::sqrt(x);
+#endif
+}
+
+// reduces x to r in [-PI/4, PI/4] with x = quadrant * PI/2 + r
+// PI/2 is split into three parts (Cody-Waite), the first two have few enough bits
+// to be multiplied exactly with the quadrant
+inline float reduce_quarter(float x, int & quadrant) {
+  constexpr float TWO_BY_PI = 0.636619772367581343f;
+  constexpr float PI_BY_2_1 = 1.5703125f;
+  constexpr float PI_BY_2_2 = 4.837512969970703125e-4f;
+  constexpr float PI_BY_2_3 = 7.54978995489188216e-8f;
+  float q = std::nearbyint(x * TWO_BY_PI);
+  quadrant = static_cast<int>(q);
+  return ((x - q * PI_BY_2_1) - q * PI_BY_2_2) - q * PI_BY_2_3;
+}
+
+inline float sin_polynomial(float r) {
+  float z = r * r;
+  return r + r * z * ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f);
+}
+
+inline float cos_polynomial(float r) {
+  float z = r * r;
+  return 1.0f - 0.5f * z + z * z * ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f);
+}
+
+inline void sincos(float x, float & sin, float & cos) {
+  int quadrant;
+  float r = reduce_quarter(x, quadrant);
+  float s = sin_polynomial(r);
+  float c = cos_polynomial(r);
+  switch (quadrant & 3) {
+    case 0: sin = s;  cos = c;  break;
+    case 1: sin = c;  cos = -s; break;
+    case 2: sin = -s; cos = -c; break;
+    default: sin = -c; cos = s; break;
+  }
+}
+
+inline float sin(float x) {
+  int quadrant;
+  float r = reduce_quarter(x, quadrant);
+  float value = (quadrant & 1) ? cos_polynomial(r) : sin_polynomial(r);
+  return (quadrant & 2) ? -value : value;
+}
+
+inline float cos(float x) {
+  int quadrant;
+  float r = reduce_quarter(x, quadrant);
+  float value = (quadrant & 1) ? sin_polynomial(r) : cos_polynomial(r);
+  return ((quadrant + 1) & 2) ? -value : value;
+}
+
+inline float atan2(float y, float x) {
+  constexpr float PI_BY_4 = 0.785398163397448310f;
+  constexpr float PI_BY_2 = 1.57079632679489662f;
+  constexpr float PI_F = 3.14159265358979324f;
+  constexpr float TAN_PI_BY_8 = 0.414213562373095049f;
+  float abs_x = std::fabs(x);
+  float abs_y = std::fabs(y);
+  float maximum = std::max(abs_x, abs_y);
+  if (maximum == 0.0f) {
+    return 0.0f;
+  }
+  // z in [0, 1], atan(z) = PI/4 + atan((z - 1) / (z + 1))
+  float z = std::min(abs_x, abs_y) / maximum;
+  float offset = 0.0f;
+  if (z > TAN_PI_BY_8) {
+    offset = PI_BY_4;
+    z = (z - 1.0f) / (z + 1.0f);
+  }
+  float z2 = z * z;
+  float angle = offset + ((((8.05374449538e-2f * z2 - 1.38776856032e-1f) * z2 + 1.99777106478e-1f) * z2
+                           - 3.33329491539e-1f) * z2 * z + z);
+  if (abs_y > abs_x) {
+    angle = PI_BY_2 - angle;
+  }
+  if (x < 0.0f) {
+    angle = PI_F - angle;
+  }
+  return std::signbit(y) ? -angle : angle;
+}
 
-    return result;
+template <size_t N>
+void normalize(Vector<float, N> & v) {
+  float square_of_length = v * v;
+  if (square_of_length < std::numeric_limits<float>::min()) { // the rsqrt estimate flushes subnormals to zero
+    v.normalize();
+    return;
+  }
+  v *= rsqrt(square_of_length);
+}
+
+template <size_t N>
+Vector<float, N> unit_vector(float angle) {
+  float sin;
+  float cos;
+  sincos(angle, sin, cos);
+  return { cos, sin };
 }
 
+}
@@ -0,0 +1,748 @@
+#include "math.h"
+#include "matrix.h"
+#include "quaternion.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+// microbenchmarks of math.h and matrix.h,
+// the target math_bench_json writes the results of math_bench as JSON (math_bench.json)
+//
+// compares the SSE specializations of Vector3df/Vector4df (math_bench)
+// with the generic template implementation (math_bench_generic, -DMATH_NO_SIMD)
+// and the bulk kernels of VectorArray with loops over an array of Vector objects
+// and the 3D orientation of many bodies with 4x4 matrices and with quaternions
+// and the affine object transformations with 4x4 matrices and with Affine3
+
+namespace {
+
+constexpr size_t NO_OF_VECTORS = 1024u;
+
+template <size_t N, class F = float>
+std::vector< Vector<F, N> > create_vectors() {
+  std::vector< Vector<F, N> > vectors(NO_OF_VECTORS);
+  for (size_t i = 0u; i < NO_OF_VECTORS; i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      vectors[i][axis] = F(0.25) + static_cast<F>((i * 7u + axis * 13u) % 31u);
+    }
+  }
+  return vectors;
+}
+
+template <class F, size_t N>
+SquareMatrix<F, N> create_matrix() {
+  SquareMatrix<F, N> matrix;
+  for (size_t column = 0u; column < N; column++) {
+    for (size_t row = 0u; row < N; row++) {
+      matrix.at(row, column) = F(0.5) + static_cast<F>((row * 3u + column * 5u) % 7u);
+    }
+  }
+  return matrix;
+}
+
+// all Vector operators, member functions and SquareMatrix products,
+// registered for float and double and N = 2, 3, 4 (cross_product only for N = 3)
+
+template <class F, size_t N>
+void BM_Add(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  Vector<F, N> sum{};
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      sum += vector;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_Subtract(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  Vector<F, N> difference{};
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      difference -= vector;
+    }
+    benchmark::DoNotOptimize(difference);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_Multiply(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      vector *= F(1.0001);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_Divide(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      vector /= F(1.0001);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_Sum(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    for (size_t i = 1u; i < vectors.size(); i++) {
+      benchmark::DoNotOptimize(vectors[i - 1] + vectors[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (NO_OF_VECTORS - 1));
+}
+
+template <class F, size_t N>
+void BM_Difference(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    for (size_t i = 1u; i < vectors.size(); i++) {
+      benchmark::DoNotOptimize(vectors[i - 1] - vectors[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (NO_OF_VECTORS - 1));
+}
+
+template <class F, size_t N>
+void BM_ScalarMultiplication(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      benchmark::DoNotOptimize(F(2.5) * vector);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_ScalarProduct(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    F sum = 0;
+    for (size_t i = 1u; i < vectors.size(); i++) {
+      sum += vectors[i - 1] * vectors[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * (NO_OF_VECTORS - 1));
+}
+
+template <class F, size_t N>
+void BM_Index(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    F sum = 0;
+    for (auto & vector : vectors) {
+      sum += vector[N - 1];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_At(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    F sum = 0;
+    for (auto & vector : vectors) {
+      sum += vector.at(N - 1);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_Length(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    F sum = 0;
+    for (auto & vector : vectors) {
+      sum += vector.length();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_SquareOfLength(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    F sum = 0;
+    for (auto & vector : vectors) {
+      sum += vector.square_of_length();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_Normalize(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      vector.normalize();
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_GetReflective(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  Vector<F, N> normal{};
+  normal[1] = 1;
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      benchmark::DoNotOptimize(vector.get_reflective(normal));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_Angle(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      benchmark::DoNotOptimize(vector.angle(0u, 1u));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F>
+void BM_CrossProduct(benchmark::State & state) {
+  auto vectors = create_vectors<3u, F>();
+  for (auto _ : state) {
+    for (size_t i = 1u; i < vectors.size(); i++) {
+      benchmark::DoNotOptimize(vectors[i - 1].cross_product(vectors[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * (NO_OF_VECTORS - 1));
+}
+
+template <class F, size_t N>
+void BM_MatrixVectorProduct(benchmark::State & state) {
+  auto vectors = create_vectors<N, F>();
+  auto matrix = create_matrix<F, N>();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      benchmark::DoNotOptimize(matrix * vector);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <class F, size_t N>
+void BM_MatrixProduct(benchmark::State & state) {
+  auto matrix = create_matrix<F, N>();
+  auto product = create_matrix<F, N>();
+  for (auto _ : state) {
+    product = matrix * product;
+    benchmark::DoNotOptimize(product);
+  }
+}
+
+template <class F, size_t N>
+void BM_Inverse(benchmark::State & state) {
+  auto matrix = create_matrix<F, N>();
+  for (size_t i = 0u; i < N; i++) {
+    matrix.at(i, i) += F{N}; // diagonally dominant, i.e. invertible
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matrix);
+    benchmark::DoNotOptimize(matrix.inverse());
+  }
+}
+
+void BM_NormalMatrix(benchmark::State & state) {
+  SquareMatrix4df model = Affine3f(Vector3df{5.0f, -6.0f, 2.0f}, 0.7f, 3.0f).to_matrix();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model);
+    benchmark::DoNotOptimize(model.normal_matrix());
+  }
+}
+
+constexpr size_t NO_OF_BODIES = 4096u;
+
+template <size_t N>
+VectorArray<float, N> create_vector_array() {
+  VectorArray<float, N> array;
+  for (auto & vector : create_vectors<N>()) {
+    for (size_t i = 0u; i < NO_OF_BODIES / NO_OF_VECTORS; i++) {
+      array.push_back(vector);
+    }
+  }
+  return array;
+}
+
+template <size_t N>
+std::vector< Vector<float, N> > create_vector_objects() {
+  std::vector< Vector<float, N> > vectors;
+  auto array = create_vector_array<N>();
+  for (size_t i = 0u; i < array.size(); i++) {
+    vectors.push_back(array.get(i));
+  }
+  return vectors;
+}
+
+template <size_t N>
+void BM_VectorsAxpy(benchmark::State & state) {
+  auto positions = create_vector_objects<N>();
+  auto velocities = create_vector_objects<N>();
+  for (auto _ : state) {
+    for (size_t i = 0u; i < positions.size(); i++) {
+      positions[i] += 0.001f * velocities[i];
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+template <size_t N>
+void BM_VectorArrayAxpy(benchmark::State & state) {
+  auto positions = create_vector_array<N>();
+  auto velocities = create_vector_array<N>();
+  for (auto _ : state) {
+    positions.axpy(0.001f, velocities);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+template <size_t N>
+void BM_VectorsDot(benchmark::State & state) {
+  auto vectors = create_vector_objects<N>();
+  Vector<float, N> v = vectors[1];
+  std::vector<float> result(vectors.size());
+  for (auto _ : state) {
+    for (size_t i = 0u; i < vectors.size(); i++) {
+      result[i] = vectors[i] * v;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+template <size_t N>
+void BM_VectorArrayDot(benchmark::State & state) {
+  auto vectors = create_vector_array<N>();
+  Vector<float, N> v = vectors.get(1);
+  std::vector<float> result(vectors.size());
+  for (auto _ : state) {
+    vectors.dot(v, result);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+template <size_t N>
+void BM_VectorsLengths(benchmark::State & state) {
+  auto vectors = create_vector_objects<N>();
+  std::vector<float> result(vectors.size());
+  for (auto _ : state) {
+    for (size_t i = 0u; i < vectors.size(); i++) {
+      result[i] = vectors[i].length();
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+template <size_t N>
+void BM_VectorArrayLengths(benchmark::State & state) {
+  auto vectors = create_vector_array<N>();
+  std::vector<float> result(vectors.size());
+  for (auto _ : state) {
+    vectors.lengths(result);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+template <size_t N>
+void BM_VectorsNormalize(benchmark::State & state) {
+  auto vectors = create_vector_objects<N>();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      vector.normalize();
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+template <size_t N>
+void BM_VectorArrayNormalize(benchmark::State & state) {
+  auto vectors = create_vector_array<N>();
+  for (auto _ : state) {
+    vectors.normalize_all();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+// Body::move followed by displacement_fix for all bodies
+void BM_VectorsMoveAndWrap(benchmark::State & state) {
+  auto positions = create_vector_objects<2u>();
+  auto velocities = create_vector_objects<2u>();
+  for (auto _ : state) {
+    for (size_t i = 0u; i < positions.size(); i++) {
+      Vector2df position = positions[i] + 0.016f * velocities[i];
+      if (position[0] < 0) { position[0] = 1024.0f; }
+      if (position[0] > 1024.0f) { position[0] = 0; }
+      if (position[1] < 0) { position[1] = 768.0f; }
+      if (position[1] > 768.0f) { position[1] = 0; }
+      positions[i] = position;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+void BM_VectorArrayMoveAndWrap(benchmark::State & state) {
+  auto positions = create_vector_array<2u>();
+  auto velocities = create_vector_array<2u>();
+  for (auto _ : state) {
+    positions.axpy(0.016f, velocities);
+    positions.wrap_into_box(Vector2df{1024.0f, 768.0f});
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_BODIES);
+}
+
+std::vector<float> create_angles() {
+  std::vector<float> angles(NO_OF_VECTORS);
+  for (size_t i = 0u; i < NO_OF_VECTORS; i++) {
+    angles[i] = -20.0f + 0.039f * static_cast<float>(i);
+  }
+  return angles;
+}
+
+// libm and fast (math.h) versions of the trigonometric functions
+template <float (*FUNCTION)(float)>
+void BM_Trigonometric(benchmark::State & state) {
+  auto angles = create_angles();
+  for (auto _ : state) {
+    for (float angle : angles) {
+      benchmark::DoNotOptimize(FUNCTION(angle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+float std_sin(float x) { return std::sin(x); }
+float std_cos(float x) { return std::cos(x); }
+float std_atan2(float x) { return std::atan2(x, 0.5f); }
+float fast_atan2(float x) { return fast::atan2(x, 0.5f); }
+
+void BM_UnitVector(benchmark::State & state) {
+  auto angles = create_angles();
+  for (auto _ : state) {
+    for (float angle : angles) {
+      benchmark::DoNotOptimize(Vector2df(angle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+void BM_FastUnitVector(benchmark::State & state) {
+  auto angles = create_angles();
+  for (auto _ : state) {
+    for (float angle : angles) {
+      benchmark::DoNotOptimize(fast::unit_vector<2u>(angle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <size_t N>
+void BM_FastNormalize(benchmark::State & state) {
+  auto vectors = create_vectors<N>();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      fast::normalize(vector);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+// one tumbling step per body: chained 4x4 rotation matrix ...
+// (faster per step, but the chained product drifts away from a rotation,
+// the integrated quaternion is renormalized and has to be converted to the model matrix)
+void BM_TumbleMatrices(benchmark::State & state) {
+  std::vector<SquareMatrix4df> orientations(NO_OF_VECTORS, Quaternionf().to_matrix());
+  SquareMatrix4df step = Quaternionf({0.0f, 0.6f, 0.8f}, 0.01f).to_matrix();
+  for (auto _ : state) {
+    for (auto & orientation : orientations) {
+      orientation = step * orientation;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+// ... and quaternion integrated with the angular velocity, converted to the model matrix
+void BM_TumbleQuaternions(benchmark::State & state) {
+  std::vector<Quaternionf> orientations(NO_OF_VECTORS);
+  std::vector<Vector3df> angular_velocities(NO_OF_VECTORS, Vector3df{0.0f, 0.6f, 0.8f});
+  for (auto _ : state) {
+    integrate<float>(orientations, angular_velocities, 0.01f);
+    for (auto & orientation : orientations) {
+      benchmark::DoNotOptimize(orientation.to_matrix());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+void BM_RotateVectorsMatrix(benchmark::State & state) {
+  auto vectors = create_vectors<4u>();
+  SquareMatrix4df rotation = Quaternionf({0.0f, 0.6f, 0.8f}, 0.5f).to_matrix();
+  for (auto _ : state) {
+    for (auto & vector : vectors) {
+      benchmark::DoNotOptimize(rotation * vector);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+void BM_RotateVectorsQuaternion(benchmark::State & state) {
+  auto vectors = create_vectors<3u>();
+  std::vector<Vector3df> result(NO_OF_VECTORS);
+  Quaternionf rotation({0.0f, 0.6f, 0.8f}, 0.5f);
+  for (auto _ : state) {
+    rotation.rotate(vectors, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+// the object transformation translation * rotation * scaling of the renderer, before and with Affine3
+void BM_ObjectTransformationMatrices(benchmark::State & state) {
+  float angle = 0.0f;
+  for (auto _ : state) {
+    SquareMatrix4df translation = { {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f},
+                                    {0.0f, 0.0f, 1.0f, 0.0f}, {5.0f, -6.0f, 0.0f, 1.0f} };
+    SquareMatrix4df rotation = { {std::cos(angle), std::sin(angle), 0.0f, 0.0f}, {-std::sin(angle), std::cos(angle), 0.0f, 0.0f},
+                                 {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f} };
+    SquareMatrix4df scaling = { {3.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 3.0f, 0.0f, 0.0f},
+                                {0.0f, 0.0f, 3.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f} };
+    benchmark::DoNotOptimize(translation * rotation * scaling);
+    angle += 0.01f;
+  }
+}
+
+void BM_ObjectTransformationAffine(benchmark::State & state) {
+  float angle = 0.0f;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Affine3f(Vector3df{5.0f, -6.0f, 0.0f}, angle, 3.0f).to_matrix());
+    angle += 0.01f;
+  }
+}
+
+void BM_AffineProduct(benchmark::State & state) {
+  Affine3f transformation(create_matrix<float, 4u>());
+  Affine3f product(create_matrix<float, 4u>());
+  for (auto _ : state) {
+    product = transformation * product;
+    benchmark::DoNotOptimize(product);
+  }
+}
+
+void BM_AffineInverse(benchmark::State & state) {
+  Affine3f transformation(Vector3df{5.0f, -6.0f, 2.0f}, 0.7f, 3.0f);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(transformation);
+    benchmark::DoNotOptimize(transformation.inverse());
+  }
+}
+
+constexpr size_t NO_OF_POINTS = 1u << 20; // 16 MB of Vector4df, more than the caches
+
+// one million points transformed point by point with operator* and with transform_points
+template <size_t N>
+void BM_TransformPointsLoop(benchmark::State & state) {
+  const SquareMatrix<float, N> matrix = create_matrix<float, N>();
+  std::vector<Vector<float, N>> points(NO_OF_POINTS, create_vectors<N>()[1]);
+  std::vector<Vector<float, N>> result(NO_OF_POINTS);
+  for (auto _ : state) {
+    for (size_t i = 0u; i < NO_OF_POINTS; i++) {
+      result[i] = matrix * points[i];
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_POINTS);
+}
+
+template <size_t N>
+void BM_TransformPoints(benchmark::State & state) {
+  const SquareMatrix<float, N> matrix = create_matrix<float, N>();
+  std::vector<Vector<float, N>> points(NO_OF_POINTS, create_vectors<N>()[1]);
+  std::vector<Vector<float, N>> result(NO_OF_POINTS);
+  for (auto _ : state) {
+    transform_points(matrix, points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_POINTS);
+}
+
+// the hand written rotation of the SDL2 renderer and the affine 2D variant of transform_points
+void BM_TransformPoints2dLoop(benchmark::State & state) {
+  std::vector<Vector2df> points(NO_OF_POINTS, create_vectors<2u>()[1]);
+  std::vector<Vector2df> result(NO_OF_POINTS);
+  const Vector2df position = {100.0f, 50.0f};
+  const float angle = 0.7f;
+  for (auto _ : state) {
+    const float cos_angle = std::cos(angle);
+    const float sin_angle = std::sin(angle);
+    for (size_t i = 0u; i < NO_OF_POINTS; i++) {
+      result[i] = { (cos_angle * points[i][0] - sin_angle * points[i][1]) + position[0],
+                    (sin_angle * points[i][0] + cos_angle * points[i][1]) + position[1] };
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_POINTS);
+}
+
+void BM_TransformPoints2d(benchmark::State & state) {
+  std::vector<Vector2df> points(NO_OF_POINTS, create_vectors<2u>()[1]);
+  std::vector<Vector2df> result(NO_OF_POINTS);
+  for (auto _ : state) {
+    transform_points(affine_2d(Vector2df{100.0f, 50.0f}, 0.7f, 1.0f), points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_POINTS);
+}
+
+// products of N x N matrices, blocked from blocked::PRODUCT_SIZE on, compared with the plain i-j-k loop
+template <size_t N>
+void BM_SquareMatrixProduct(benchmark::State & state) {
+  auto factor1 = std::make_unique<SquareMatrix<float, N>>(create_matrix<float, N>());
+  auto factor2 = std::make_unique<SquareMatrix<float, N>>(create_matrix<float, N>());
+  auto product = std::make_unique<SquareMatrix<float, N>>();
+  for (auto _ : state) {
+    *product = *factor1 * *factor2;
+    benchmark::DoNotOptimize(product->at(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * N * N * N); // multiply-adds
+}
+
+template <size_t N>
+void BM_SquareMatrixProductNaive(benchmark::State & state) {
+  auto factor1 = std::make_unique<SquareMatrix<float, N>>(create_matrix<float, N>());
+  auto factor2 = std::make_unique<SquareMatrix<float, N>>(create_matrix<float, N>());
+  auto product = std::make_unique<SquareMatrix<float, N>>();
+  for (auto _ : state) {
+    for (size_t row = 0u; row < N; row++) {
+      for (size_t col = 0u; col < N; col++) {
+        float sum = 0.0f;
+        for (size_t k = 0u; k < N; k++) {
+          sum += factor1->at(row, k) * factor2->at(k, col);
+        }
+        product->at(row, col) = sum;
+      }
+    }
+    benchmark::DoNotOptimize(product->at(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * N * N * N);
+}
+
+#define BENCHMARK_ALL_TYPES(function) \
+  BENCHMARK_TEMPLATE(function, float, 2u); \
+  BENCHMARK_TEMPLATE(function, float, 3u); \
+  BENCHMARK_TEMPLATE(function, float, 4u); \
+  BENCHMARK_TEMPLATE(function, double, 2u); \
+  BENCHMARK_TEMPLATE(function, double, 3u); \
+  BENCHMARK_TEMPLATE(function, double, 4u)
+
+BENCHMARK_ALL_TYPES(BM_Add);
+BENCHMARK_ALL_TYPES(BM_Subtract);
+BENCHMARK_ALL_TYPES(BM_Multiply);
+BENCHMARK_ALL_TYPES(BM_Divide);
+BENCHMARK_ALL_TYPES(BM_Sum);
+BENCHMARK_ALL_TYPES(BM_Difference);
+BENCHMARK_ALL_TYPES(BM_ScalarMultiplication);
+BENCHMARK_ALL_TYPES(BM_ScalarProduct);
+BENCHMARK_ALL_TYPES(BM_Index);
+BENCHMARK_ALL_TYPES(BM_At);
+BENCHMARK_ALL_TYPES(BM_Length);
+BENCHMARK_ALL_TYPES(BM_SquareOfLength);
+BENCHMARK_ALL_TYPES(BM_Normalize);
+BENCHMARK_ALL_TYPES(BM_GetReflective);
+BENCHMARK_ALL_TYPES(BM_Angle);
+BENCHMARK_TEMPLATE(BM_CrossProduct, float);
+BENCHMARK_TEMPLATE(BM_CrossProduct, double);
+BENCHMARK_ALL_TYPES(BM_MatrixVectorProduct);
+BENCHMARK_ALL_TYPES(BM_MatrixProduct);
+BENCHMARK(BM_FastNormalize<2u>);
+BENCHMARK(BM_FastNormalize<3u>);
+BENCHMARK(BM_FastNormalize<4u>);
+BENCHMARK(BM_Trigonometric<std_sin>);
+BENCHMARK(BM_Trigonometric<fast::sin>);
+BENCHMARK(BM_Trigonometric<std_cos>);
+BENCHMARK(BM_Trigonometric<fast::cos>);
+BENCHMARK(BM_Trigonometric<std_atan2>);
+BENCHMARK(BM_Trigonometric<fast_atan2>);
+BENCHMARK(BM_UnitVector);
+BENCHMARK(BM_FastUnitVector);
+BENCHMARK(BM_VectorsAxpy<2u>);
+BENCHMARK(BM_VectorArrayAxpy<2u>);
+BENCHMARK(BM_VectorsAxpy<3u>);
+BENCHMARK(BM_VectorArrayAxpy<3u>);
+BENCHMARK(BM_VectorsDot<3u>);
+BENCHMARK(BM_VectorArrayDot<3u>);
+BENCHMARK(BM_VectorsLengths<3u>);
+BENCHMARK(BM_VectorArrayLengths<3u>);
+BENCHMARK(BM_VectorsNormalize<3u>);
+BENCHMARK(BM_VectorArrayNormalize<3u>);
+BENCHMARK(BM_VectorsMoveAndWrap);
+BENCHMARK(BM_VectorArrayMoveAndWrap);
+BENCHMARK(BM_TumbleMatrices);
+BENCHMARK(BM_TumbleQuaternions);
+BENCHMARK(BM_RotateVectorsMatrix);
+BENCHMARK(BM_RotateVectorsQuaternion);
+BENCHMARK(BM_ObjectTransformationMatrices);
+BENCHMARK(BM_ObjectTransformationAffine);
+BENCHMARK(BM_AffineProduct);
+BENCHMARK(BM_AffineInverse);
+BENCHMARK_TEMPLATE(BM_Inverse, float, 2u);
+BENCHMARK_TEMPLATE(BM_Inverse, float, 3u);
+BENCHMARK_TEMPLATE(BM_Inverse, float, 4u);
+BENCHMARK_TEMPLATE(BM_Inverse, double, 8u);
+BENCHMARK(BM_NormalMatrix);
+BENCHMARK(BM_TransformPointsLoop<3u>);
+BENCHMARK(BM_TransformPoints<3u>);
+BENCHMARK(BM_TransformPointsLoop<4u>);
+BENCHMARK(BM_TransformPoints<4u>);
+BENCHMARK(BM_TransformPoints2dLoop);
+BENCHMARK(BM_TransformPoints2d);
+BENCHMARK(BM_SquareMatrixProductNaive<4u>);
+BENCHMARK(BM_SquareMatrixProduct<4u>);
+BENCHMARK(BM_SquareMatrixProductNaive<16u>);
+BENCHMARK(BM_SquareMatrixProduct<16u>);
+BENCHMARK(BM_SquareMatrixProductNaive<64u>);
+BENCHMARK(BM_SquareMatrixProduct<64u>);
+BENCHMARK(BM_SquareMatrixProductNaive<256u>);
+BENCHMARK(BM_SquareMatrixProduct<256u>);
+
+}
+
+BENCHMARK_MAIN();
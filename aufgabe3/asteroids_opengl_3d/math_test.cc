@@ -1,5 +1,7 @@
 #include "math.h"
+#include "batch.h"
 #include "gtest/gtest.h"
+#include <random>
 
 namespace {
 	
@@ -70,6 +72,13 @@ TEST(VECTOR, UnitVectorWithAngle90) {
 }
 
 
+TEST(VECTOR, AtChecksIndex3df) {
+  Vector3df vector = {1.0, 2.0, 3.0};
+
+  EXPECT_FLOAT_EQ(3.0, vector.at(2));
+  EXPECT_THROW(vector.at(3), std::out_of_range);
+}
+
 TEST(VECTOR, CopyConstructor) {
   Vector2df vector = {1.0, 0.0};
   Vector2df copy(vector);
@@ -320,7 +329,7 @@ TEST(VECTOR, CrossVectorProduct2) {
   EXPECT_NEAR(3.0,  vector2[1], 0.00001);
   EXPECT_NEAR(0.0, vector2[2], 0.00001);
   EXPECT_NEAR(6.0, cross[0], 0.00001);
-  EXPECT_NEAR(-6.0,  cross[1], 0.00001);
+  EXPECT_NEAR(6.0,  cross[1], 0.00001);
   EXPECT_NEAR(-3.0, cross[2], 0.00001);
 }
 
@@ -336,7 +345,7 @@ TEST(VECTOR, CrossVectorProduct3) {
   EXPECT_NEAR(0.0,  vector2[1], 0.00001);
   EXPECT_NEAR(-2.0, vector2[2], 0.00001);
   EXPECT_NEAR(0.0, cross[0], 0.00001);
-  EXPECT_NEAR(10.0,  cross[1], 0.00001);
+  EXPECT_NEAR(-10.0,  cross[1], 0.00001);
   EXPECT_NEAR(0.0, cross[2], 0.00001);
 }
 
@@ -353,7 +362,7 @@ TEST(VECTOR, CrossVectorProduct4) {
   EXPECT_NEAR(0.0,  vector2[1], 0.00001);
   EXPECT_NEAR(-2.0, vector2[2], 0.00001);
   EXPECT_NEAR(0.0, cross[0], 0.00001);
-  EXPECT_NEAR(-10.0,  cross[1], 0.00001);
+  EXPECT_NEAR(10.0,  cross[1], 0.00001);
   EXPECT_NEAR(0.0, cross[2], 0.00001);
 }
 
@@ -376,7 +385,7 @@ TEST(VECTOR, CrossVectorProduct5) {
 
   
   EXPECT_NEAR(0.0,  cross[0], 0.00001);
-  EXPECT_NEAR(10.0, cross[1], 0.00001);
+  EXPECT_NEAR(-10.0, cross[1], 0.00001);
   EXPECT_NEAR(0.0,  cross[2], 0.00001);
 }
 
@@ -386,7 +395,7 @@ TEST(VECTOR, CrossVectorProduct6) {
   Vector3df cross = vector1.cross_product(vector2);
   
   EXPECT_NEAR(0.0, cross[0], 0.00001);
-  EXPECT_NEAR(1.0, cross[1], 0.00001);
+  EXPECT_NEAR(-1.0, cross[1], 0.00001);
   EXPECT_NEAR(0.0, cross[2], 0.00001);
 }
 
@@ -482,4 +491,268 @@ TEST(MyVectorTests, ScalarProduct3D) {
     EXPECT_NEAR(actualScalarProduct, expectedScalarProduct, 0.00001);
 }
 
+
+TEST(VECTOR, DivisionByZeroKeepsDotProduct3df) {
+  Vector3df vector = {1.0, 2.0, 3.0};
+  vector /= 0.0f;
+
+  EXPECT_TRUE(std::isinf(vector[1]));
+  EXPECT_TRUE(std::isinf(vector * Vector3df{1.0, 1.0, 1.0}));
+}
+
+TEST(VECTOR, ScalingByInfinityKeepsDotProduct3df) {
+  Vector3df vector = {1.0, 2.0, 3.0};
+  vector *= INFINITY;
+
+  EXPECT_TRUE(std::isinf(vector[2]));
+  EXPECT_TRUE(std::isinf(vector * Vector3df{1.0, 1.0, 1.0}));
+  EXPECT_TRUE(std::isinf((-INFINITY * Vector3df{1.0, 2.0, 3.0}) * Vector3df{1.0, 1.0, 1.0}));
+}
+
+TEST(VECTOR, SubtractAndScale4df) {
+  Vector4df vector = {1.0, 2.0, 3.0, 4.0};
+  vector -= Vector4df{0.5, 0.5, 0.5, 0.5};
+  vector *= 2.0f;
+
+  EXPECT_NEAR(1.0, vector[0], 0.00001);
+  EXPECT_NEAR(3.0, vector[1], 0.00001);
+  EXPECT_NEAR(5.0, vector[2], 0.00001);
+  EXPECT_NEAR(7.0, vector[3], 0.00001);
+  EXPECT_NEAR(84.0, vector.square_of_length(), 0.00001);
+}
+
+TEST(VECTOR, ConstantEvaluation3df) {
+  constexpr Vector3df vector = Vector3df{1.0, 2.0, 3.0} + 2.0f * Vector3df{1.0, 0.0, -1.0};
+  static_assert(vector[0] == 3.0f && vector[1] == 2.0f && vector[2] == 1.0f);
+  static_assert(vector * Vector3df{1.0, 1.0, 1.0} == 6.0f);
+  static_assert(vector.square_of_length() == 14.0f);
+
+  // the constant evaluated result is the same as the one computed at runtime
+  Vector3df runtime = {1.0, 2.0, 3.0};
+  runtime += 2.0f * Vector3df{1.0, 0.0, -1.0};
+  EXPECT_EQ(vector.square_of_length(), runtime.square_of_length());
+}
+
+// 7 vectors: one SSE block of four and three remaining vectors
+VectorArray3df create_vector_array() {
+  VectorArray3df array;
+  for (size_t i = 0u; i < 7u; i++) {
+    array.push_back(Vector3df{1.0f + i, -2.0f * i, 0.5f + 0.25f * i});
+  }
+  return array;
+}
+
+TEST(VECTOR_ARRAY, PushBackAndGet3df) {
+  VectorArray3df array = create_vector_array();
+
+  EXPECT_EQ(7u, array.size());
+  EXPECT_EQ(7u, array.stream(2).size());
+  EXPECT_NEAR(4.0, array.get(3)[0], 0.00001);
+  EXPECT_NEAR(-6.0, array.get(3)[1], 0.00001);
+  EXPECT_NEAR(1.25, array.get(3)[2], 0.00001);
+  EXPECT_NEAR(1.25, array.stream(2)[3], 0.00001);
+}
+
+TEST(VECTOR_ARRAY, AxpyAndScaleEqualVectorOperators3df) {
+  VectorArray3df array = create_vector_array();
+  VectorArray3df x = create_vector_array();
+  x.scale(-0.5f);
+  array.axpy(3.0f, x);
+
+  for (size_t i = 0u; i < array.size(); i++) {
+    Vector3df vector = create_vector_array().get(i);
+    Vector3df expected = vector + 3.0f * (-0.5f * vector);
+    for (size_t axis = 0u; axis < 3u; axis++) {
+      EXPECT_FLOAT_EQ(expected[axis], array.get(i)[axis]);
+    }
+  }
+}
+
+TEST(VECTOR_ARRAY, DotAndLengthsEqualVectorOperators3df) {
+  VectorArray3df array = create_vector_array();
+  Vector3df v = {0.5, 2.0, -1.0};
+  std::vector<float> dots(array.size());
+  std::vector<float> lengths(array.size());
+  array.dot(v, dots);
+  array.lengths(lengths);
+
+  for (size_t i = 0u; i < array.size(); i++) {
+    EXPECT_FLOAT_EQ(array.get(i) * v, dots[i]);
+    EXPECT_FLOAT_EQ(array.get(i).length(), lengths[i]);
+  }
+}
+
+TEST(VECTOR_ARRAY, NormalizeAll2df) {
+  VectorArray2df array;
+  for (size_t i = 0u; i < 9u; i++) {
+    array.push_back(Vector2df{3.0f * (i + 1), 4.0f * (i + 1)});
+  }
+  array.normalize_all();
+
+  for (size_t i = 0u; i < array.size(); i++) {
+    EXPECT_NEAR(0.6, array.get(i)[0], 0.00001);
+    EXPECT_NEAR(0.8, array.get(i)[1], 0.00001);
+  }
+}
+
+TEST(VECTOR_ARRAY, WrapIntoBox2df) {
+  VectorArray2df array;
+  std::vector<Vector2df> positions = { {-1.0, 10.0}, {1025.0, 10.0}, {10.0, -0.5}, {10.0, 800.0},
+                                       {0.0, 768.0}, {1024.0, 0.0}, {512.0, 384.0} };
+  for (auto & position : positions) {
+    array.push_back(position);
+  }
+  array.wrap_into_box(Vector2df{1024.0, 768.0});
+
+  std::vector<Vector2df> expected = { {1024.0, 10.0}, {0.0, 10.0}, {10.0, 768.0}, {10.0, 0.0},
+                                      {0.0, 768.0}, {1024.0, 0.0}, {512.0, 384.0} };
+  for (size_t i = 0u; i < array.size(); i++) {
+    EXPECT_FLOAT_EQ(expected[i][0], array.get(i)[0]);
+    EXPECT_FLOAT_EQ(expected[i][1], array.get(i)[1]);
+  }
+}
+
+// the maximum errors documented in math.h, measured against double precision
+TEST(FAST_MATH, SinCosAccuracy) {
+  double sin_error = 0.0;
+  double cos_error = 0.0;
+  for (double x = -8192.0; x <= 8192.0; x += 0.00731) {
+    float angle = static_cast<float>(x);
+    float sin;
+    float cos;
+    fast::sincos(angle, sin, cos);
+    sin_error = std::max(sin_error, std::fabs(fast::sin(angle) - std::sin(static_cast<double>(angle))));
+    cos_error = std::max(cos_error, std::fabs(fast::cos(angle) - std::cos(static_cast<double>(angle))));
+    EXPECT_EQ(fast::sin(angle), sin);
+    EXPECT_EQ(fast::cos(angle), cos);
+  }
+  EXPECT_LT(sin_error, 1.2e-7);
+  EXPECT_LT(cos_error, 1.2e-7);
+}
+
+TEST(FAST_MATH, Atan2Accuracy) {
+  double error = 0.0;
+  for (double a = -4.0; a <= 4.0; a += 0.001) {
+    for (double b : {-100.0, -3.0, -1.0, -0.01, 0.0, 0.01, 0.5, 2.0, 100.0}) {
+      float y = static_cast<float>(a);
+      float x = static_cast<float>(b);
+      error = std::max(error, std::fabs(fast::atan2(y, x) - std::atan2(static_cast<double>(y), static_cast<double>(x))));
+      error = std::max(error, std::fabs(fast::atan2(x, y) - std::atan2(static_cast<double>(x), static_cast<double>(y))));
+    }
+  }
+  EXPECT_LT(error, 3.0e-7);
+  EXPECT_EQ(0.0f, fast::atan2(0.0f, 0.0f));
+  EXPECT_NEAR(PI, fast::atan2(0.0f, -1.0f), 0.00001);
+  EXPECT_NEAR(-PI / 2.0, fast::atan2(-1.0f, 0.0f), 0.00001);
+}
+
+TEST(FAST_MATH, RsqrtAccuracy) {
+  double error = 0.0;
+  for (double x = 1e-30; x < 1e30; x *= 1.0001) {
+    float value = static_cast<float>(x);
+    double expected = 1.0 / std::sqrt(static_cast<double>(value));
+    error = std::max(error, std::fabs(fast::rsqrt(value) - expected) / expected);
+  }
+  EXPECT_LT(error, 3.0e-7);
+}
+
+TEST(FAST_MATH, NormalizeAndUnitVector) {
+  Vector3df vector = {3.0, -4.0, 12.0};
+  fast::normalize(vector);
+  EXPECT_NEAR(3.0 / 13.0, vector[0], 0.000001);
+  EXPECT_NEAR(-4.0 / 13.0, vector[1], 0.000001);
+  EXPECT_NEAR(12.0 / 13.0, vector[2], 0.000001);
+
+  Vector2df direction = fast::unit_vector<2u>(2.5f);
+  Vector2df expected = Vector2df(2.5f);
+  EXPECT_NEAR(expected[0], direction[0], 0.000001);
+  EXPECT_NEAR(expected[1], direction[1], 0.000001);
+}
+
+TEST(FAST_MATH, NormalizeTinyAndZeroVectors) {
+  Vector3df tiny = {1e-20f, -1e-20f, 0.0f};
+  fast::normalize(tiny);
+  EXPECT_NEAR(std::sqrt(0.5), tiny[0], 0.00001); // the square of the length is subnormal
+  EXPECT_NEAR(-std::sqrt(0.5), tiny[1], 0.00001);
+
+  Vector2df zero = {0.0f, 0.0f};
+  fast::normalize(zero);
+  EXPECT_TRUE(std::isnan(zero[0])); // like Vector::normalize
+}
+
+// 11 vectors: full AVX-512, AVX2 and SSE blocks and remaining vectors,
+// random fractions make the results depend on the order of the sums
+template <size_t N>
+std::vector< Vector<float, N> > create_batch(float offset) {
+  std::mt19937 generator(static_cast<uint32_t>(N));
+  std::uniform_real_distribution<float> fraction(0.0f, 1.0f);
+  std::vector< Vector<float, N> > vectors;
+  for (size_t i = 0u; i < 11u; i++) {
+    Vector<float, N> vector;
+    for (size_t axis = 0u; axis < N; axis++) {
+      vector[axis] = offset + 0.5f * i - 1.25f * axis + fraction(generator);
+    }
+    vectors.push_back(vector);
+  }
+  return vectors;
+}
+
+constexpr batch::Isa ISAS[] = { batch::Isa::scalar, batch::Isa::sse2, batch::Isa::avx2, batch::Isa::avx512 };
+
+TEST(BATCH, DotOfEachIsaEqualsScalar) {
+  auto a3 = create_batch<3u>(1.0f);
+  auto b3 = create_batch<3u>(-2.0f);
+  auto a4 = create_batch<4u>(1.0f);
+  auto b4 = create_batch<4u>(-2.0f);
+  std::vector<float> expected3(11u), expected4(11u), result3(11u), result4(11u);
+  batch::get_kernels(batch::Isa::scalar).dot3(a3, b3, expected3);
+  batch::get_kernels(batch::Isa::scalar).dot4(a4, b4, expected4);
+
+  for (batch::Isa isa : ISAS) {
+    if (! batch::is_supported(isa)) {
+      continue;
+    }
+    SCOPED_TRACE(batch::get_name(isa));
+    batch::get_kernels(isa).dot3(a3, b3, result3);
+    batch::get_kernels(isa).dot4(a4, b4, result4);
+    for (size_t i = 0u; i < 11u; i++) {
+      EXPECT_EQ(expected3[i], result3[i]);
+      EXPECT_EQ(expected4[i], result4[i]);
+      EXPECT_EQ(a3[i] * b3[i], result3[i]);
+    }
+  }
+}
+
+TEST(BATCH, NormalizeOfEachIsaEqualsScalar) {
+  auto expected3 = create_batch<3u>(1.0f);
+  auto expected4 = create_batch<4u>(1.0f);
+  batch::get_kernels(batch::Isa::scalar).normalize3(expected3);
+  batch::get_kernels(batch::Isa::scalar).normalize4(expected4);
+
+  for (batch::Isa isa : ISAS) {
+    if (! batch::is_supported(isa)) {
+      continue;
+    }
+    SCOPED_TRACE(batch::get_name(isa));
+    auto vectors3 = create_batch<3u>(1.0f);
+    auto vectors4 = create_batch<4u>(1.0f);
+    batch::get_kernels(isa).normalize3(vectors3);
+    batch::get_kernels(isa).normalize4(vectors4);
+    for (size_t i = 0u; i < 11u; i++) {
+      for (size_t axis = 0u; axis < 3u; axis++) {
+        EXPECT_EQ(expected3[i][axis], vectors3[i][axis]);
+      }
+      for (size_t axis = 0u; axis < 4u; axis++) {
+        EXPECT_EQ(expected4[i][axis], vectors4[i][axis]);
+      }
+      EXPECT_NEAR(1.0, vectors3[i].length(), 0.00001);
+    }
+  }
+}
+
+TEST(BATCH, ActiveIsaIsSupported) {
+  EXPECT_TRUE(batch::is_supported(batch::get_active_isa()));
+  EXPECT_TRUE(batch::is_supported(batch::Isa::scalar));
+}
+
 }
@@ -1,11 +1,49 @@
 #include "matrix.h"
-#include "matrix.tcc"
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 template class SquareMatrix<float, 2u>;
 template class SquareMatrix<float, 3u>; 
 template class SquareMatrix<float, 4u>;
 
-template SquareMatrix<float, 2> operator*(const SquareMatrix<float, 2> factor1, const SquareMatrix<float,2> factor2);
-template SquareMatrix<float, 3> operator*(const SquareMatrix<float, 3> factor1, const SquareMatrix<float,3> factor2);
-template SquareMatrix<float, 4> operator*(const SquareMatrix<float, 4> factor1, const SquareMatrix<float,4> factor2);
+template SquareMatrix<float, 2> operator*(const SquareMatrix<float, 2> & factor1, const SquareMatrix<float,2> & factor2);
+template SquareMatrix<float, 3> operator*(const SquareMatrix<float, 3> & factor1, const SquareMatrix<float,3> & factor2);
+template SquareMatrix<float, 4> operator*(const SquareMatrix<float, 4> & factor1, const SquareMatrix<float,4> & factor2);
 
+
+template class Affine3<float>;
+
+template Affine3<float> operator*(const Affine3<float> & factor1, const Affine3<float> & factor2);
+
+template void transform_points(const SquareMatrix<float, 2u> & matrix, std::span<const Vector<float, 2u>> points,
+                               std::span<Vector<float, 2u>> result);
+template void transform_points(const SquareMatrix<float, 3u> & matrix, std::span<const Vector<float, 3u>> points,
+                               std::span<Vector<float, 3u>> result);
+template void transform_points(const SquareMatrix<float, 4u> & matrix, std::span<const Vector<float, 4u>> points,
+                               std::span<Vector<float, 4u>> result);
+template void transform_points(const SquareMatrix<float, 3u> & transformation, std::span<const Vector<float, 2u>> points,
+                               std::span<Vector<float, 2u>> result);
+template SquareMatrix<float, 3u> affine_2d(const Vector<float, 2u> & position, float angle, float scale);
+
+namespace blocked {
+
+void parallel_for(size_t count, size_t granularity, const std::function<void(size_t, size_t)> & work, unsigned threads) {
+  if (threads == 0u) {
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  const size_t chunks = (count + granularity - 1u) / granularity;
+  const size_t chunks_per_thread = (chunks + threads - 1u) / threads;
+  const size_t range = chunks_per_thread * granularity;
+  if (range >= count) {
+    work(0u, count);
+    return;
+  }
+  std::vector<std::jthread> workers;
+  for (size_t first = range; first < count; first += range) {
+    workers.emplace_back(work, first, std::min(first + range, count));
+  }
+  work(0u, range); // the calling thread computes the first range
+}
+
+}
@@ -3,6 +3,27 @@
 
 #include "math.h"
 #include <cmath>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// the product of large matrices is computed in blocks which stay in the caches
+namespace blocked {
+
+// minimal N for the blocked product, smaller products use the unrolled loops
+inline constexpr size_t PRODUCT_SIZE = 32u;
+
+// minimal N for computing the columns of the blocked product in several threads
+inline constexpr size_t PARALLEL_SIZE = 128u;
+
+// calls work(first, last) for consecutive ranges covering [0, count), in parallel threads,
+// the range sizes are multiples of granularity (except the last one)
+// threads == 0 uses the number of hardware threads
+void parallel_for(size_t count, size_t granularity, const std::function<void(size_t, size_t)> & work,
+                  unsigned threads = 0u);
+
+}
 
 // a square matrice implementation
 template <class FLOAT, size_t N>
@@ -10,28 +31,56 @@ class SquareMatrix {
   static_assert(N > 0u);
   std::array< Vector<FLOAT,N>, N> matrix;  // values are stored in column (a vector) order
 public:
-  SquareMatrix(); // Standardkonstruktor
-  SquareMatrix(std::initializer_list< Vector<FLOAT, N > > values);
+  constexpr SquareMatrix(); // Standardkonstruktor
+  constexpr SquareMatrix(std::initializer_list< Vector<FLOAT, N > > values);
     
   // returns reference to the i-th column vector
-  Vector<FLOAT, N> & operator[](std::size_t i);
+  constexpr Vector<FLOAT, N> & operator[](std::size_t i);
 
   // returns i-th column vector
-  Vector<FLOAT, N> operator[](std::size_t i) const;
+  constexpr Vector<FLOAT, N> operator[](std::size_t i) const;
   
   // returns the value at the given row and column
-  FLOAT at(size_t row, size_t column) const;
+  constexpr FLOAT at(size_t row, size_t column) const;
 
   // returns the reference value at the given row and column  
-  FLOAT & at(size_t row, size_t column);
+  constexpr FLOAT & at(size_t row, size_t column);
   
   // returns the producut of this SquareMatrix and the given vector
-  Vector<FLOAT,N> operator*(const Vector<FLOAT,N> vector);
+  constexpr Vector<FLOAT,N> operator*(const Vector<FLOAT,N> & vector) const;
+
+  // returns the transposed matrix
+  constexpr SquareMatrix transpose() const;
+
+  // returns the determinant, in closed form for N <= 4 and by LU decomposition for larger N
+  constexpr FLOAT determinant() const;
+
+  // returns the inverse matrix, in closed form (adjugate / determinant) for N <= 4
+  // and by LU decomposition with partial pivoting for larger N
+  // the matrix must be invertible
+  constexpr SquareMatrix inverse() const;
+
+  // returns the matrix transforming the normal vectors of this homogeneous transformation,
+  // the transposed inverse of the upper left 3x3 part
+  // compute it once per object instead of transforming the normals with this matrix per vertex
+  constexpr SquareMatrix<FLOAT, 3u> normal_matrix() const requires (N == 4u);
 
   //  returns the product of two square matrices
   template <class F, size_t K>
-  friend SquareMatrix<F, K> operator*(const SquareMatrix<F, K> factor1, const SquareMatrix<F, K> factor2);
+  friend constexpr SquareMatrix<F, K> operator*(const SquareMatrix<F, K> & factor1, const SquareMatrix<F, K> & factor2);
+
+  // result[i] = matrix * points[i], the columns are loaded once for all points
+  template <class F, size_t K>
+  friend void transform_points(const SquareMatrix<F, K> & matrix, std::type_identity_t<std::span<const Vector<F, K>>> points,
+                               std::type_identity_t<std::span<Vector<F, K>>> result);
+
+private:
+  // the 2x2 minors of the upper two rows (s0 ... s5) and of the lower two rows (c0 ... c5)
+  constexpr std::array<FLOAT, 12u> minors() const requires (N == 4u);
 
+  // LU decomposition with partial pivoting (Doolittle) in place, permutation[row] is the original row
+  // returns the sign of the permutation or 0 if the matrix is singular
+  constexpr FLOAT lu_decompose(std::array<size_t, N> & permutation);
 };
 
 
@@ -39,4 +88,67 @@ typedef SquareMatrix<float, 2u> SquareMatrix2df;
 typedef SquareMatrix<float, 3u> SquareMatrix3df;
 typedef SquareMatrix<float, 4u> SquareMatrix4df;
 
+// result[i] = matrix * points[i] for many points, vectorized for float
+// both spans must have the same size
+template <class FLOAT, size_t N>
+void transform_points(const SquareMatrix<FLOAT, N> & matrix, std::type_identity_t<std::span<const Vector<FLOAT, N>>> points,
+                      std::type_identity_t<std::span<Vector<FLOAT, N>>> result);
+
+// the affine 2D variant: result[i] = transformation * (points[i], 1) with a homogeneous 3x3 matrix,
+// whose last row is (0, 0, 1), two points per SSE register
+template <class FLOAT>
+void transform_points(const SquareMatrix<FLOAT, 3u> & transformation, std::type_identity_t<std::span<const Vector<FLOAT, 2u>>> points,
+                      std::type_identity_t<std::span<Vector<FLOAT, 2u>>> result);
+
+// returns the homogeneous 3x3 matrix translation to position * rotation by angle (in radians) * uniform scaling
+// in the x/y plane, e.g. for transform_points
+template <class FLOAT>
+SquareMatrix<FLOAT, 3u> affine_2d(const Vector<FLOAT, 2u> & position, FLOAT angle, FLOAT scale);
+
+// an affine transformation of the three-dimensional space: linear part (column order) and translation,
+// i.e. the upper three rows of a homogeneous 4x4 matrix whose last row is (0, 0, 0, 1)
+// two transformations are composed with 36 multiplications instead of the 64 of a 4x4 matrix product
+template <class FLOAT>
+class Affine3 {
+  SquareMatrix<FLOAT, 3u> linear;
+  Vector<FLOAT, 3u> translation;
+public:
+  // creates the identity
+  constexpr Affine3();
+
+  constexpr Affine3(const SquareMatrix<FLOAT, 3u> & linear, const Vector<FLOAT, 3u> & translation);
+
+  // translation to position * rotation * uniform scaling
+  constexpr Affine3(const Vector<FLOAT, 3u> & position, const SquareMatrix<FLOAT, 3u> & rotation, FLOAT scale);
+
+  // translation to position * rotation by angle (in radians) around the z axis * uniform scaling
+  Affine3(const Vector<FLOAT, 3u> & position, FLOAT angle, FLOAT scale);
+
+  // takes the upper three rows of a homogeneous matrix, the last row is ignored
+  constexpr explicit Affine3(const SquareMatrix<FLOAT, 4u> & matrix);
+
+  constexpr const SquareMatrix<FLOAT, 3u> & get_linear() const;
+
+  constexpr const Vector<FLOAT, 3u> & get_translation() const;
+
+  // returns the inverse transformation, the linear part is inverted in closed form (adjugate / determinant)
+  // the linear part must be invertible
+  constexpr Affine3 inverse() const;
+
+  // returns the homogeneous 4x4 matrix, e.g. for uploading it to the graphics card
+  constexpr SquareMatrix<FLOAT, 4u> to_matrix() const;
+
+  // returns the transformed point
+  constexpr Vector<FLOAT, 3u> operator*(const Vector<FLOAT, 3u> & point) const;
+
+  // returns the composition of both transformations, first factor2 and then factor1
+  template <class F>
+  friend constexpr Affine3<F> operator*(const Affine3<F> & factor1, const Affine3<F> & factor2);
+};
+
+typedef Affine3<float> Affine3f;
+
+// definitions are needed in every translation unit to allow constant evaluation
+#include "matrix.tcc"
+
 #endif
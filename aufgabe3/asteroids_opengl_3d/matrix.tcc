@@ -1,34 +1,68 @@
+#include <algorithm>
 #include <cassert>
 #include <initializer_list>
-#include "matrix.h"
+
+#ifdef MATH_SIMD
+namespace simd {
+
+// the columns of a matrix, loaded into registers
+template <size_t N>
+struct Columns {
+    __m128 column[N];
+};
+
+// columns[0] * factors[0] + ... + columns[N - 1] * factors[N - 1], summed up from zero
+// in the order of the generic fold expression, so both give the same bits
+template <size_t N, size_t... I>
+inline __m128 linear_combination(const Columns<N> & columns, __m128 factors, std::index_sequence<I...>) {
+    __m128 sum = _mm_setzero_ps();
+    ((sum = _mm_add_ps(sum, _mm_mul_ps(columns.column[I], _mm_shuffle_ps(factors, factors, _MM_SHUFFLE(I, I, I, I))))), ...);
+    if constexpr (N == 3u) { // 0.0 * inf would turn the padding into NaN
+        sum = _mm_and_ps(sum, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+    }
+    return sum;
+}
+
+template <size_t N, size_t... I>
+inline Columns<N> load(const std::array<Vector<float, N>, N> & columns, std::index_sequence<I...>) {
+    return { { load(columns[I])... } };
+}
+
+template <size_t N, size_t... I>
+inline __m128 linear_combination(const std::array<Vector<float, N>, N> & columns, __m128 factors, std::index_sequence<I...> indices) {
+    return linear_combination(load(columns, indices), factors, indices);
+}
+
+}
+#endif
 
 template <class FLOAT, size_t N>
-SquareMatrix<FLOAT, N>::SquareMatrix(): SquareMatrix({}) {}
+constexpr SquareMatrix<FLOAT, N>::SquareMatrix(): SquareMatrix({}) {}
 
 // Konstruktor: Initialisierung über eine Liste von Vector<FLOAT, N>-Objekten,
 // die als Spalten (column order) in der internen 'matrix'-Struktur gespeichert werden.
 template <class FLOAT, size_t N>
-SquareMatrix<FLOAT, N>::SquareMatrix(std::initializer_list< Vector<FLOAT, N > > values) {
+constexpr SquareMatrix<FLOAT, N>::SquareMatrix(std::initializer_list< Vector<FLOAT, N > > values) {
     std::copy(values.begin(), values.end(), matrix.begin());
 }
 
 // returns reference to the i-th column vector
 template <class FLOAT, size_t N>
-Vector<FLOAT, N>& SquareMatrix<FLOAT, N>::operator[](std::size_t i)
+constexpr Vector<FLOAT, N>& SquareMatrix<FLOAT, N>::operator[](std::size_t i)
 {
     return matrix[i];
 }
 
 // returns i-th column vector
 template <class FLOAT, size_t N>
-Vector<FLOAT, N> SquareMatrix<FLOAT, N>::operator[](std::size_t i) const
+constexpr Vector<FLOAT, N> SquareMatrix<FLOAT, N>::operator[](std::size_t i) const
 {
     return matrix[i];
 }
 
 // returns the value at the given row and column (nur Lesen)
 template <class FLOAT, size_t N>
-FLOAT SquareMatrix<FLOAT, N>::at(size_t row, size_t column) const
+constexpr FLOAT SquareMatrix<FLOAT, N>::at(size_t row, size_t column) const
 {
     // Da "matrix[column]" den Spaltenvektor liefert, ist die row-te Komponente dieses Vektors das gesuchte Element.
     return matrix[column][row];
@@ -36,46 +70,546 @@ FLOAT SquareMatrix<FLOAT, N>::at(size_t row, size_t column) const
 
 // returns the reference value at the given row and column (Lesen & Schreiben)
 template <class FLOAT, size_t N>
-FLOAT & SquareMatrix<FLOAT, N>::at(size_t row, size_t column)
+constexpr FLOAT & SquareMatrix<FLOAT, N>::at(size_t row, size_t column)
 {
     return matrix[column][row];
 }
 
 // returns the producut of this SquareMatrix and the given vector
+// Ergebnis[row] = Summe über alle Spalten von (matrix[col][row] * vector[col]),
+// die Summe wird über eine index_sequence vollständig ausgerollt
 template <class FLOAT, size_t N>
-Vector<FLOAT, N> SquareMatrix<FLOAT, N>::operator*(const Vector<FLOAT, N> vector)
+constexpr Vector<FLOAT, N> SquareMatrix<FLOAT, N>::operator*(const Vector<FLOAT, N> & vector) const
 {
     Vector<FLOAT, N> product = {{}};
-    // Ergebnis[i] = Summe über alle Spalten von (matrix[col][row] * vector[col])
-    for (size_t row = 0u; row < N; ++row) {
-        for (size_t col = 0u; col < N; ++col) {
-            product[row] += matrix[col][row] * vector[col];
+#ifdef MATH_SIMD
+    // SSE: Spalten mal gebroadcastete Komponenten, gleiche Additionsreihenfolge (bitgleich)
+    if constexpr (simd::accelerated<FLOAT, N>) {
+        if (! std::is_constant_evaluated()) {
+            simd::store(product, simd::linear_combination(matrix, simd::load(vector), std::make_index_sequence<N>{}));
+            return product;
         }
     }
+#endif
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        for (size_t row = 0u; row < N; ++row) {
+            product[row] = (FLOAT{0} + ... + (matrix[I][row] * vector[I]));
+        }
+    }(std::make_index_sequence<N>{});
     return product;
 }
 
+namespace blocked {
+
+// columns of factor1 per block, a block of 64 columns with N = 256 floats (64 KB) stays in the L2 cache
+inline constexpr size_t DEPTH = 64u;
+
+// columns of the product per register tile, each loaded value of factor1 is used four times
+inline constexpr size_t TILE = 4u;
+
+// the matrices are given as tables of column pointers, each column is only indexed within its own array
+
+// product[col][row] += factor1[k][row] * factor2[col][k] for TILE x TILE values, k of [depth, depth_end)
+// the sums stay in registers over all k, they are accumulated in ascending k like the unrolled loops
+// (the loops over the tile are unrolled, otherwise the sums would be kept on the stack)
+template <class F>
+inline void multiply_tile(const F * const * factor1, const F * const * factor2, F * const * product,
+                          size_t row, size_t col, size_t depth, size_t depth_end)
+{
+    F sums[TILE][TILE];
+#pragma GCC unroll 4
+    for (size_t c = 0u; c < TILE; ++c) {
+#pragma GCC unroll 4
+        for (size_t r = 0u; r < TILE; ++r) {
+            sums[c][r] = product[col + c][row + r];
+        }
+    }
+    for (size_t k = depth; k < depth_end; ++k) {
+        const F * a = factor1[k] + row;
+#pragma GCC unroll 4
+        for (size_t c = 0u; c < TILE; ++c) {
+            const F b = factor2[col + c][k];
+#pragma GCC unroll 4
+            for (size_t r = 0u; r < TILE; ++r) {
+                sums[c][r] += a[r] * b;
+            }
+        }
+    }
+#pragma GCC unroll 4
+    for (size_t c = 0u; c < TILE; ++c) {
+#pragma GCC unroll 4
+        for (size_t r = 0u; r < TILE; ++r) {
+            product[col + c][row + r] = sums[c][r];
+        }
+    }
+}
+
+#ifdef MATH_SIMD
+// the float tile of 8 rows (two registers) and TILE columns, 8 sums in registers
+inline void multiply_tile_8(const float * const * factor1, const float * const * factor2, float * const * product,
+                            size_t row, size_t col, size_t depth, size_t depth_end)
+{
+    __m128 sums[TILE][2];
+#pragma GCC unroll 4
+    for (size_t c = 0u; c < TILE; ++c) {
+        sums[c][0] = _mm_loadu_ps(product[col + c] + row);
+        sums[c][1] = _mm_loadu_ps(product[col + c] + row + 4u);
+    }
+    for (size_t k = depth; k < depth_end; ++k) {
+        const __m128 a0 = _mm_loadu_ps(factor1[k] + row);
+        const __m128 a1 = _mm_loadu_ps(factor1[k] + row + 4u);
+#pragma GCC unroll 4
+        for (size_t c = 0u; c < TILE; ++c) {
+            const __m128 b = _mm_load1_ps(factor2[col + c] + k);
+            sums[c][0] = _mm_add_ps(sums[c][0], _mm_mul_ps(a0, b));
+            sums[c][1] = _mm_add_ps(sums[c][1], _mm_mul_ps(a1, b));
+        }
+    }
+#pragma GCC unroll 4
+    for (size_t c = 0u; c < TILE; ++c) {
+        _mm_storeu_ps(product[col + c] + row, sums[c][0]);
+        _mm_storeu_ps(product[col + c] + row + 4u, sums[c][1]);
+    }
+}
+#endif
+
+// product[col] += sum of factor1[k] * factor2[col][k] for the columns col of [first, last) and all k,
+// every value is accumulated in ascending k, i.e. in the order of the unrolled loops
+template <class F>
+void multiply_columns(const F * const * factor1, const F * const * factor2, F * const * product,
+                      size_t n, size_t first, size_t last)
+{
+    // remaining rows or columns, which do not fill a tile
+    auto multiply_rest = [&](size_t first_row, size_t col, size_t columns, size_t depth, size_t depth_end) {
+        for (size_t c = col; c < col + columns; ++c) {
+            for (size_t k = depth; k < depth_end; ++k) {
+                const F b = factor2[c][k];
+                for (size_t row = first_row; row < n; ++row) {
+                    product[c][row] += factor1[k][row] * b;
+                }
+            }
+        }
+    };
+    for (size_t depth = 0u; depth < n; depth += DEPTH) {
+        const size_t depth_end = std::min(depth + DEPTH, n);
+        size_t col = first;
+        for (; col + TILE <= last; col += TILE) {
+            size_t row = 0u;
+#ifdef MATH_SIMD
+            if constexpr (std::is_same_v<F, float>) {
+                for (; row + 8u <= n; row += 8u) {
+                    multiply_tile_8(factor1, factor2, product, row, col, depth, depth_end);
+                }
+            }
+#endif
+            for (; row + TILE <= n; row += TILE) {
+                multiply_tile(factor1, factor2, product, row, col, depth, depth_end);
+            }
+            multiply_rest(row, col, TILE, depth, depth_end);
+        }
+        multiply_rest(0u, col, last - col, depth, depth_end);
+    }
+}
+
+}
+
 //  returns the product of two square matrices
 template <class F, size_t K>
-SquareMatrix<F, K> operator*(const SquareMatrix<F, K> factor1, const SquareMatrix<F, K> factor2)
+constexpr SquareMatrix<F, K> operator*(const SquareMatrix<F, K> & factor1, const SquareMatrix<F, K> & factor2)
 {
-    SquareMatrix<F, K> product = factor1;   // 'product' als Kopie von factor1
-    // alle Einträge vorab auf 0 initialisieren
-    for (size_t col = 0; col < K; ++col) {
-        for (size_t row = 0; row < K; ++row) {
-            product[col][row] = 0;
+    SquareMatrix<F, K> product;
+    if constexpr (K >= blocked::PRODUCT_SIZE) {
+        if (std::is_constant_evaluated()) { // the fold expression below would be too long
+            for (size_t col = 0; col < K; ++col) {
+                for (size_t row = 0; row < K; ++row) {
+                    F sum = 0;
+                    for (size_t k = 0; k < K; ++k) {
+                        sum += factor1.matrix[k][row] * factor2.matrix[col][k];
+                    }
+                    product.matrix[col][row] = sum;
+                }
+            }
+        } else {
+            std::array<const F *, K> columns1, columns2;
+            std::array<F *, K> product_columns;
+            for (size_t col = 0; col < K; ++col) {
+                columns1[col] = factor1.matrix[col].vector.data();
+                columns2[col] = factor2.matrix[col].vector.data();
+                product_columns[col] = product.matrix[col].vector.data();
+            }
+            auto columns = [&](size_t first, size_t last) {
+                blocked::multiply_columns(columns1.data(), columns2.data(), product_columns.data(), K, first, last);
+            };
+            if constexpr (K >= blocked::PARALLEL_SIZE) {
+                blocked::parallel_for(K, blocked::TILE, columns);
+            } else {
+                columns(0u, K);
+            }
         }
+        return product;
     }
-
-    // eigentliche Multiplikation
-    for (size_t col = 0; col < K; ++col) {
-        for (size_t row = 0; row < K; ++row) {
-            F sum = 0;
-            for (size_t i = 0; i < K; ++i) {
-                sum += factor1[i][row] * factor2[col][i];
+#ifdef MATH_SIMD
+    // SSE: jede Spalte des Produkts ist factor1 * Spalte von factor2
+    if constexpr (simd::accelerated<F, K>) {
+        if (! std::is_constant_evaluated()) {
+            for (size_t col = 0; col < K; ++col) {
+                simd::store(product.matrix[col], simd::linear_combination(factor1.matrix, simd::load(factor2.matrix[col]),
+                                                                          std::make_index_sequence<K>{}));
             }
-            product[col][row] = sum;
+            return product;
         }
     }
+#endif
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        for (size_t col = 0; col < K; ++col) {
+            for (size_t row = 0; row < K; ++row) {
+                product[col][row] = (F{0} + ... + (factor1.matrix[I][row] * factor2.matrix[col][I]));
+            }
+        }
+    }(std::make_index_sequence<K>{});
     return product;
 }
+
+template <class FLOAT, size_t N>
+constexpr SquareMatrix<FLOAT, N> SquareMatrix<FLOAT, N>::transpose() const
+{
+    SquareMatrix transposed;
+    for (size_t column = 0u; column < N; ++column) {
+        for (size_t row = 0u; row < N; ++row) {
+            transposed.at(column, row) = at(row, column);
+        }
+    }
+    return transposed;
+}
+
+// Unterdeterminanten für die Laplace-Entwicklung einer 4x4-Matrix nach den oberen beiden Zeilen
+template <class FLOAT, size_t N>
+constexpr std::array<FLOAT, 12u> SquareMatrix<FLOAT, N>::minors() const requires (N == 4u)
+{
+    return {
+        at(0, 0) * at(1, 1) - at(1, 0) * at(0, 1),
+        at(0, 0) * at(1, 2) - at(1, 0) * at(0, 2),
+        at(0, 0) * at(1, 3) - at(1, 0) * at(0, 3),
+        at(0, 1) * at(1, 2) - at(1, 1) * at(0, 2),
+        at(0, 1) * at(1, 3) - at(1, 1) * at(0, 3),
+        at(0, 2) * at(1, 3) - at(1, 2) * at(0, 3),
+        at(2, 0) * at(3, 1) - at(3, 0) * at(2, 1),
+        at(2, 0) * at(3, 2) - at(3, 0) * at(2, 2),
+        at(2, 0) * at(3, 3) - at(3, 0) * at(2, 3),
+        at(2, 1) * at(3, 2) - at(3, 1) * at(2, 2),
+        at(2, 1) * at(3, 3) - at(3, 1) * at(2, 3),
+        at(2, 2) * at(3, 3) - at(3, 2) * at(2, 3)
+    };
+}
+
+template <class FLOAT, size_t N>
+constexpr FLOAT SquareMatrix<FLOAT, N>::lu_decompose(std::array<size_t, N> & permutation)
+{
+    auto absolute = [](FLOAT value) { return value < 0 ? -value : value; };
+    FLOAT sign = 1;
+    for (size_t row = 0u; row < N; ++row) {
+        permutation[row] = row;
+    }
+    for (size_t k = 0u; k < N; ++k) {
+        size_t pivot = k;
+        for (size_t row = k + 1u; row < N; ++row) {
+            if (absolute(at(row, k)) > absolute(at(pivot, k))) {
+                pivot = row;
+            }
+        }
+        if (at(pivot, k) == 0) {
+            return 0;
+        }
+        if (pivot != k) {
+            for (size_t column = 0u; column < N; ++column) {
+                std::swap(at(k, column), at(pivot, column));
+            }
+            std::swap(permutation[k], permutation[pivot]);
+            sign = -sign;
+        }
+        for (size_t row = k + 1u; row < N; ++row) {
+            at(row, k) /= at(k, k);
+            for (size_t column = k + 1u; column < N; ++column) {
+                at(row, column) -= at(row, k) * at(k, column);
+            }
+        }
+    }
+    return sign;
+}
+
+template <class FLOAT, size_t N>
+constexpr FLOAT SquareMatrix<FLOAT, N>::determinant() const
+{
+    if constexpr (N == 1u) {
+        return at(0, 0);
+    } else if constexpr (N == 2u) {
+        return at(0, 0) * at(1, 1) - at(0, 1) * at(1, 0);
+    } else if constexpr (N == 3u) {
+        return at(0, 0) * (at(1, 1) * at(2, 2) - at(2, 1) * at(1, 2))
+             - at(0, 1) * (at(1, 0) * at(2, 2) - at(2, 0) * at(1, 2))
+             + at(0, 2) * (at(1, 0) * at(2, 1) - at(2, 0) * at(1, 1));
+    } else if constexpr (N == 4u) {
+        const auto [s0, s1, s2, s3, s4, s5, c0, c1, c2, c3, c4, c5] = minors();
+        return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    } else {
+        SquareMatrix lu = *this;
+        std::array<size_t, N> permutation;
+        FLOAT determinant = lu.lu_decompose(permutation);
+        for (size_t k = 0u; k < N; ++k) {
+            determinant *= lu.at(k, k);
+        }
+        return determinant;
+    }
+}
+
+// geschlossene Formen: Adjunkte geteilt durch die Determinante,
+// für größere N werden die Spalten der Einheitsmatrix mit der LU-Zerlegung gelöst
+template <class FLOAT, size_t N>
+constexpr SquareMatrix<FLOAT, N> SquareMatrix<FLOAT, N>::inverse() const
+{
+    SquareMatrix inverse;
+    if constexpr (N <= 3u) {
+        const FLOAT determinant = this->determinant();
+        assert(determinant != 0);
+        const FLOAT reciprocal = 1 / determinant;
+        if constexpr (N == 1u) {
+            inverse.at(0, 0) = reciprocal;
+        } else if constexpr (N == 2u) {
+            inverse.at(0, 0) = at(1, 1) * reciprocal;
+            inverse.at(0, 1) = -at(0, 1) * reciprocal;
+            inverse.at(1, 0) = -at(1, 0) * reciprocal;
+            inverse.at(1, 1) = at(0, 0) * reciprocal;
+        } else {
+            inverse.at(0, 0) = (at(1, 1) * at(2, 2) - at(2, 1) * at(1, 2)) * reciprocal;
+            inverse.at(0, 1) = (at(0, 2) * at(2, 1) - at(0, 1) * at(2, 2)) * reciprocal;
+            inverse.at(0, 2) = (at(0, 1) * at(1, 2) - at(0, 2) * at(1, 1)) * reciprocal;
+            inverse.at(1, 0) = (at(1, 2) * at(2, 0) - at(1, 0) * at(2, 2)) * reciprocal;
+            inverse.at(1, 1) = (at(0, 0) * at(2, 2) - at(0, 2) * at(2, 0)) * reciprocal;
+            inverse.at(1, 2) = (at(1, 0) * at(0, 2) - at(0, 0) * at(1, 2)) * reciprocal;
+            inverse.at(2, 0) = (at(1, 0) * at(2, 1) - at(2, 0) * at(1, 1)) * reciprocal;
+            inverse.at(2, 1) = (at(2, 0) * at(0, 1) - at(0, 0) * at(2, 1)) * reciprocal;
+            inverse.at(2, 2) = (at(0, 0) * at(1, 1) - at(1, 0) * at(0, 1)) * reciprocal;
+        }
+    } else if constexpr (N == 4u) {
+        const auto [s0, s1, s2, s3, s4, s5, c0, c1, c2, c3, c4, c5] = minors();
+        const FLOAT determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        assert(determinant != 0);
+        const FLOAT reciprocal = 1 / determinant;
+        inverse.at(0, 0) = ( at(1, 1) * c5 - at(1, 2) * c4 + at(1, 3) * c3) * reciprocal;
+        inverse.at(0, 1) = (-at(0, 1) * c5 + at(0, 2) * c4 - at(0, 3) * c3) * reciprocal;
+        inverse.at(0, 2) = ( at(3, 1) * s5 - at(3, 2) * s4 + at(3, 3) * s3) * reciprocal;
+        inverse.at(0, 3) = (-at(2, 1) * s5 + at(2, 2) * s4 - at(2, 3) * s3) * reciprocal;
+        inverse.at(1, 0) = (-at(1, 0) * c5 + at(1, 2) * c2 - at(1, 3) * c1) * reciprocal;
+        inverse.at(1, 1) = ( at(0, 0) * c5 - at(0, 2) * c2 + at(0, 3) * c1) * reciprocal;
+        inverse.at(1, 2) = (-at(3, 0) * s5 + at(3, 2) * s2 - at(3, 3) * s1) * reciprocal;
+        inverse.at(1, 3) = ( at(2, 0) * s5 - at(2, 2) * s2 + at(2, 3) * s1) * reciprocal;
+        inverse.at(2, 0) = ( at(1, 0) * c4 - at(1, 1) * c2 + at(1, 3) * c0) * reciprocal;
+        inverse.at(2, 1) = (-at(0, 0) * c4 + at(0, 1) * c2 - at(0, 3) * c0) * reciprocal;
+        inverse.at(2, 2) = ( at(3, 0) * s4 - at(3, 1) * s2 + at(3, 3) * s0) * reciprocal;
+        inverse.at(2, 3) = (-at(2, 0) * s4 + at(2, 1) * s2 - at(2, 3) * s0) * reciprocal;
+        inverse.at(3, 0) = (-at(1, 0) * c3 + at(1, 1) * c1 - at(1, 2) * c0) * reciprocal;
+        inverse.at(3, 1) = ( at(0, 0) * c3 - at(0, 1) * c1 + at(0, 2) * c0) * reciprocal;
+        inverse.at(3, 2) = (-at(3, 0) * s3 + at(3, 1) * s1 - at(3, 2) * s0) * reciprocal;
+        inverse.at(3, 3) = ( at(2, 0) * s3 - at(2, 1) * s1 + at(2, 2) * s0) * reciprocal;
+    } else {
+        SquareMatrix lu = *this;
+        std::array<size_t, N> permutation;
+        [[maybe_unused]] const FLOAT sign = lu.lu_decompose(permutation);
+        assert(sign != 0);
+        for (size_t column = 0u; column < N; ++column) {
+            // L * y = P * e_column (Vorwärtseinsetzen), dann U * x = y (Rückwärtseinsetzen)
+            Vector<FLOAT, N> & x = inverse[column];
+            for (size_t row = 0u; row < N; ++row) {
+                FLOAT sum = permutation[row] == column ? 1 : 0;
+                for (size_t k = 0u; k < row; ++k) {
+                    sum -= lu.at(row, k) * x[k];
+                }
+                x[row] = sum;
+            }
+            for (size_t row = N; row-- > 0u;) {
+                FLOAT sum = x[row];
+                for (size_t k = row + 1u; k < N; ++k) {
+                    sum -= lu.at(row, k) * x[k];
+                }
+                x[row] = sum / lu.at(row, row);
+            }
+        }
+    }
+    return inverse;
+}
+
+template <class FLOAT, size_t N>
+constexpr SquareMatrix<FLOAT, 3u> SquareMatrix<FLOAT, N>::normal_matrix() const requires (N == 4u)
+{
+    SquareMatrix<FLOAT, 3u> linear;
+    for (size_t column = 0u; column < 3u; ++column) {
+        for (size_t row = 0u; row < 3u; ++row) {
+            linear.at(row, column) = at(row, column);
+        }
+    }
+    return linear.inverse().transpose();
+}
+
+template <class FLOAT>
+constexpr Affine3<FLOAT>::Affine3()
+    : linear{ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} }, translation{0, 0, 0} {}
+
+template <class FLOAT>
+constexpr Affine3<FLOAT>::Affine3(const SquareMatrix<FLOAT, 3u> & linear, const Vector<FLOAT, 3u> & translation)
+    : linear(linear), translation(translation) {}
+
+template <class FLOAT>
+constexpr Affine3<FLOAT>::Affine3(const Vector<FLOAT, 3u> & position, const SquareMatrix<FLOAT, 3u> & rotation, FLOAT scale)
+    : linear(rotation), translation(position)
+{
+    for (size_t column = 0u; column < 3u; ++column) {
+        linear[column] *= scale;
+    }
+}
+
+// die Spalten sind bereits skaliert, es wird keine Matrix multipliziert
+template <class FLOAT>
+Affine3<FLOAT>::Affine3(const Vector<FLOAT, 3u> & position, FLOAT angle, FLOAT scale)
+    : translation(position)
+{
+    const FLOAT cosine = scale * static_cast<FLOAT>(std::cos(angle));
+    const FLOAT sine = scale * static_cast<FLOAT>(std::sin(angle));
+    linear.at(0, 0) = cosine;
+    linear.at(1, 0) = sine;
+    linear.at(0, 1) = -sine;
+    linear.at(1, 1) = cosine;
+    linear.at(2, 2) = scale;
+}
+
+template <class FLOAT>
+constexpr Affine3<FLOAT>::Affine3(const SquareMatrix<FLOAT, 4u> & matrix)
+{
+    for (size_t row = 0u; row < 3u; ++row) {
+        for (size_t column = 0u; column < 3u; ++column) {
+            linear.at(row, column) = matrix.at(row, column);
+        }
+        translation[row] = matrix.at(row, 3u);
+    }
+}
+
+template <class FLOAT>
+constexpr const SquareMatrix<FLOAT, 3u> & Affine3<FLOAT>::get_linear() const
+{
+    return linear;
+}
+
+template <class FLOAT>
+constexpr const Vector<FLOAT, 3u> & Affine3<FLOAT>::get_translation() const
+{
+    return translation;
+}
+
+// inverse(T * L) = inverse(L) * inverse(T), die Translation wird also mit inverse(L) zurückgedreht
+template <class FLOAT>
+constexpr Affine3<FLOAT> Affine3<FLOAT>::inverse() const
+{
+    Affine3 inverse(linear.inverse(), {});
+    for (size_t row = 0u; row < 3u; ++row) {
+        inverse.translation[row] = -(inverse.linear.at(row, 0) * translation[0] + inverse.linear.at(row, 1) * translation[1]
+                                     + inverse.linear.at(row, 2) * translation[2]);
+    }
+    return inverse;
+}
+
+template <class FLOAT>
+constexpr SquareMatrix<FLOAT, 4u> Affine3<FLOAT>::to_matrix() const
+{
+    SquareMatrix<FLOAT, 4u> matrix;
+    for (size_t row = 0u; row < 3u; ++row) {
+        for (size_t column = 0u; column < 3u; ++column) {
+            matrix.at(row, column) = linear.at(row, column);
+        }
+        matrix.at(row, 3u) = translation[row];
+    }
+    matrix.at(3u, 3u) = 1;
+    return matrix;
+}
+
+template <class FLOAT>
+constexpr Vector<FLOAT, 3u> Affine3<FLOAT>::operator*(const Vector<FLOAT, 3u> & point) const
+{
+    return linear * point + translation;
+}
+
+// (L1, t1) * (L2, t2) = (L1 * L2, L1 * t2 + t1): 27 + 9 Multiplikationen
+template <class F>
+constexpr Affine3<F> operator*(const Affine3<F> & factor1, const Affine3<F> & factor2)
+{
+    return Affine3<F>(factor1.linear * factor2.linear, factor1.linear * factor2.translation + factor1.translation);
+}
+
+template <class FLOAT, size_t N>
+void transform_points(const SquareMatrix<FLOAT, N> & matrix, std::type_identity_t<std::span<const Vector<FLOAT, N>>> points,
+                      std::type_identity_t<std::span<Vector<FLOAT, N>>> result)
+{
+    assert(points.size() == result.size());
+    const size_t count = points.size();
+#ifdef MATH_SIMD
+    // die Spalten bleiben für alle Punkte in Registern, result könnte sonst matrix überschreiben
+    if constexpr (simd::accelerated<FLOAT, N>) {
+        const simd::Columns<N> columns = simd::load(matrix.matrix, std::make_index_sequence<N>{});
+        for (size_t i = 0u; i < count; ++i) {
+            simd::store(result[i], simd::linear_combination(columns, simd::load(points[i]), std::make_index_sequence<N>{}));
+        }
+        return;
+    }
+#endif
+    const SquareMatrix<FLOAT, N> copy = matrix;
+    for (size_t i = 0u; i < count; ++i) {
+        result[i] = copy * points[i];
+    }
+}
+
+template <class FLOAT>
+void transform_points(const SquareMatrix<FLOAT, 3u> & transformation, std::type_identity_t<std::span<const Vector<FLOAT, 2u>>> points,
+                      std::type_identity_t<std::span<Vector<FLOAT, 2u>>> result)
+{
+    assert(points.size() == result.size());
+    const size_t count = points.size();
+    size_t i = 0u;
+#ifdef MATH_SIMD
+    // zwei Punkte (x0, y0, x1, y1) pro Register
+    if constexpr (std::is_same_v<FLOAT, float>) {
+        const __m128 x_column = _mm_setr_ps(transformation.at(0, 0), transformation.at(1, 0), transformation.at(0, 0), transformation.at(1, 0));
+        const __m128 y_column = _mm_setr_ps(transformation.at(0, 1), transformation.at(1, 1), transformation.at(0, 1), transformation.at(1, 1));
+        const __m128 translation = _mm_setr_ps(transformation.at(0, 2), transformation.at(1, 2), transformation.at(0, 2), transformation.at(1, 2));
+        for (; i + 2u <= count; i += 2u) {
+            const __m128 two_points = _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(points[i].vector.data()))),
+                                                    _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double *>(points[i + 1u].vector.data()))));
+            const __m128 x = _mm_shuffle_ps(two_points, two_points, _MM_SHUFFLE(2, 2, 0, 0));
+            const __m128 y = _mm_shuffle_ps(two_points, two_points, _MM_SHUFFLE(3, 3, 1, 1));
+            const __m128 transformed = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x_column, x), _mm_mul_ps(y_column, y)), translation);
+            _mm_storel_pi(reinterpret_cast<__m64 *>(result[i].vector.data()), transformed);
+            _mm_storeh_pi(reinterpret_cast<__m64 *>(result[i + 1u].vector.data()), transformed);
+        }
+    }
+#endif
+    const FLOAT m00 = transformation.at(0, 0), m01 = transformation.at(0, 1), m02 = transformation.at(0, 2);
+    const FLOAT m10 = transformation.at(1, 0), m11 = transformation.at(1, 1), m12 = transformation.at(1, 2);
+    for (; i < count; ++i) {
+        const FLOAT x = points[i][0];
+        const FLOAT y = points[i][1];
+        result[i] = { m00 * x + m01 * y + m02, m10 * x + m11 * y + m12 };
+    }
+}
+
+template <class FLOAT>
+SquareMatrix<FLOAT, 3u> affine_2d(const Vector<FLOAT, 2u> & position, FLOAT angle, FLOAT scale)
+{
+    const FLOAT cosine = scale * static_cast<FLOAT>(std::cos(angle));
+    const FLOAT sine = scale * static_cast<FLOAT>(std::sin(angle));
+    SquareMatrix<FLOAT, 3u> transformation;
+    transformation.at(0, 0) = cosine;
+    transformation.at(1, 0) = sine;
+    transformation.at(0, 1) = -sine;
+    transformation.at(1, 1) = cosine;
+    transformation.at(0, 2) = position[0];
+    transformation.at(1, 2) = position[1];
+    transformation.at(2, 2) = 1;
+    return transformation;
+}
@@ -1,5 +1,11 @@
 #include "matrix.h"
+#include "batch.h"
 #include "gtest/gtest.h"
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <utility>
 
 namespace {
 	
@@ -142,4 +148,348 @@ TEST(MATRIX, ProductMultiplicationWithMatrix3df) {
   }
 }
 
+// Testet die Auswertung zur Übersetzungszeit
+TEST(MATRIX, ConstantEvaluation4df) {
+  constexpr SquareMatrix4df rotation = { {0.0f, -1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f, 0.0f},
+                                         {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f} };
+  constexpr SquareMatrix4df translation = { {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f},
+                                            {0.0f, 0.0f, 1.0f, 0.0f}, {5.0f, 6.0f, 0.0f, 1.0f} };
+  constexpr SquareMatrix4df product = translation * rotation;
+  constexpr Vector4df point = product * Vector4df{1.0f, 0.0f, 0.0f, 1.0f};
+
+  static_assert(point[0] == 5.0f && point[1] == 5.0f && point[2] == 0.0f && point[3] == 1.0f);
+  static_assert(product.at(0, 3) == 5.0f && product.at(1, 0) == -1.0f);
+
+  SquareMatrix4df runtime = translation;
+  runtime = runtime * rotation;
+  for (ssize_t c = 0; c < 4; ++c) {
+    for (ssize_t r = 0; r < 4; ++r) {
+      EXPECT_FLOAT_EQ(runtime.at(r, c), product.at(r, c));
+    }
+  }
+}
+
+// Testet, ob die SSE-Produkte zur Laufzeit bitgleich mit der generischen Auswertung zur Übersetzungszeit sind
+TEST(MATRIX, RuntimeProductsEqualConstantEvaluation4df) {
+  constexpr SquareMatrix4df matrix1 = { {0.1f, 2.3f, -1.7f, 0.0f}, {3.3f, 0.7f, 5.1f, -0.0f},
+                                        {-0.9f, 1e-7f, -1.3f, 2.2f}, {7.5f, 0.25f, 3.1f, 1.0f} };
+  constexpr SquareMatrix4df matrix2 = { {1.1f, -0.3f, 0.6f, 0.0f}, {0.2f, 1.9f, -4.4f, 0.0f},
+                                        {-2.8f, 0.05f, 1.3f, 0.0f}, {0.3f, -6.1f, 9.7f, 1.0f} };
+  constexpr Vector4df vector = {0.3f, -1.1f, 2.9f, 1.0f};
+  constexpr SquareMatrix4df product = matrix1 * matrix2;
+  constexpr Vector4df transformed = matrix1 * vector;
+
+  SquareMatrix4df runtime_matrix = matrix1;
+  SquareMatrix4df runtime_product = runtime_matrix * matrix2;
+  Vector4df runtime_transformed = runtime_matrix * vector;
+  for (ssize_t c = 0; c < 4; ++c) {
+    for (ssize_t r = 0; r < 4; ++r) {
+      EXPECT_EQ(std::bit_cast<uint32_t>(product.at(r, c)), std::bit_cast<uint32_t>(runtime_product.at(r, c)));
+    }
+    EXPECT_EQ(std::bit_cast<uint32_t>(transformed[c]), std::bit_cast<uint32_t>(runtime_transformed[c]));
+  }
+}
+
+// Testet die Bitgleichheit auch für 3x3-Matrizen, deren Spalten um ein viertes Element erweitert sind
+TEST(MATRIX, RuntimeProductsEqualConstantEvaluation3df) {
+  constexpr SquareMatrix3df matrix1 = { {0.1f, 2.3f, -1.7f}, {3.3f, 0.7f, -0.0f}, {-0.9f, 1e-7f, -1.3f} };
+  constexpr SquareMatrix3df matrix2 = { {1.1f, -0.3f, 0.6f}, {0.2f, 1.9f, -4.4f}, {-2.8f, 0.05f, 1.3f} };
+  constexpr Vector3df vector = {0.3f, -1.1f, 2.9f};
+  constexpr SquareMatrix3df product = matrix1 * matrix2;
+  constexpr Vector3df transformed = matrix1 * vector;
+
+  SquareMatrix3df runtime_matrix = matrix1;
+  SquareMatrix3df runtime_product = runtime_matrix * matrix2;
+  Vector3df runtime_transformed = runtime_matrix * vector;
+  for (ssize_t c = 0; c < 3; ++c) {
+    for (ssize_t r = 0; r < 3; ++r) {
+      EXPECT_EQ(std::bit_cast<uint32_t>(product.at(r, c)), std::bit_cast<uint32_t>(runtime_product.at(r, c)));
+    }
+    EXPECT_EQ(std::bit_cast<uint32_t>(transformed[c]), std::bit_cast<uint32_t>(runtime_transformed[c]));
+  }
+}
+
+// Testet die direkte TRS-Konstruktion gegen das Produkt der drei 4x4-Matrizen
+TEST(AFFINE, TranslationRotationScaleEqualsMatrixProduct) {
+  const float angle = 0.7f;
+  SquareMatrix4df translation = { {1.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 0.0f},
+                                  {0.0f, 0.0f, 1.0f, 0.0f}, {5.0f, -6.0f, 2.0f, 1.0f} };
+  SquareMatrix4df rotation = { {std::cos(angle), std::sin(angle), 0.0f, 0.0f}, {-std::sin(angle), std::cos(angle), 0.0f, 0.0f},
+                               {0.0f, 0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f} };
+  SquareMatrix4df scaling = { {3.0f, 0.0f, 0.0f, 0.0f}, {0.0f, 3.0f, 0.0f, 0.0f},
+                              {0.0f, 0.0f, 3.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f} };
+  SquareMatrix4df expected = translation * rotation * scaling;
+
+  SquareMatrix4df result = Affine3f(Vector3df{5.0f, -6.0f, 2.0f}, angle, 3.0f).to_matrix();
+  for (ssize_t c = 0; c < 4; ++c) {
+    for (ssize_t r = 0; r < 4; ++r) {
+      EXPECT_NEAR(expected.at(r, c), result.at(r, c), 1e-6f);
+    }
+  }
+}
+
+// Testet die Komposition und das Transformieren von Punkten gegen die homogenen 4x4-Matrizen
+TEST(AFFINE, CompositionEqualsMatrixProduct) {
+  constexpr SquareMatrix4df matrix1 = { {1.0f, 2.0f, -2.0f, 0.0f}, {3.0f, 4.0f, 5.0f, 0.0f},
+                                        {0.0f, -2.0f, -1.0f, 0.0f}, {7.0f, 0.25f, 3.0f, 1.0f} };
+  constexpr SquareMatrix4df matrix2 = { {0.5f, 0.0f, 1.0f, 0.0f}, {0.0f, 2.0f, 0.0f, 0.0f},
+                                        {-1.0f, 0.0f, 0.5f, 0.0f}, {-3.0f, 1.0f, 4.0f, 1.0f} };
+  constexpr SquareMatrix4df expected = matrix1 * matrix2;
+  constexpr SquareMatrix4df product = (Affine3f(matrix1) * Affine3f(matrix2)).to_matrix();
+  static_assert(product.at(3, 3) == 1.0f && product.at(3, 0) == 0.0f);
+  for (ssize_t c = 0; c < 4; ++c) {
+    for (ssize_t r = 0; r < 4; ++r) {
+      EXPECT_FLOAT_EQ(expected.at(r, c), product.at(r, c));
+    }
+  }
+
+  Vector3df point = Affine3f(matrix1) * Vector3df{1.0f, -2.0f, 0.5f};
+  Vector4df expected_point = matrix1 * Vector4df{1.0f, -2.0f, 0.5f, 1.0f};
+  for (ssize_t r = 0; r < 3; ++r) {
+    EXPECT_FLOAT_EQ(expected_point[r], point[r]);
+  }
+}
+
+// Testet, ob die Inverse die Transformation rückgängig macht
+TEST(AFFINE, InverseComposesToIdentity) {
+  Affine3f transformation = Affine3f(Vector3df{5.0f, -6.0f, 2.0f}, 0.7f, 3.0f)
+                            * Affine3f({ {1.0f, 0.5f, 0.0f}, {0.0f, 2.0f, 0.0f}, {0.25f, 0.0f, 1.0f} }, Vector3df{1.0f, 1.0f, -1.0f});
+  SquareMatrix4df identity = (transformation.inverse() * transformation).to_matrix();
+  SquareMatrix4df identity2 = (transformation * transformation.inverse()).to_matrix();
+  for (ssize_t c = 0; c < 4; ++c) {
+    for (ssize_t r = 0; r < 4; ++r) {
+      EXPECT_NEAR(r == c ? 1.0f : 0.0f, identity.at(r, c), 1e-5f);
+      EXPECT_NEAR(r == c ? 1.0f : 0.0f, identity2.at(r, c), 1e-5f);
+    }
+  }
+  Vector3df point = {3.0f, -1.0f, 4.0f};
+  Vector3df back = transformation.inverse() * (transformation * point);
+  for (ssize_t r = 0; r < 3; ++r) {
+    EXPECT_NEAR(point[r], back[r], 1e-5f);
+  }
+}
+
+// Testet Transponierte und Determinante in geschlossener Form (zur Übersetzungszeit)
+TEST(MATRIX, TransposeAndDeterminant) {
+  constexpr SquareMatrix2df matrix2 = { {1.0f, 2.0f}, {3.0f, 4.0f} };
+  constexpr SquareMatrix3df matrix3 = { {2.0f, 0.0f, 1.0f}, {1.0f, 3.0f, 0.0f}, {0.0f, 1.0f, 4.0f} };
+  constexpr SquareMatrix4df matrix4 = { {1.0f, 0.0f, 2.0f, -1.0f}, {3.0f, 0.0f, 0.0f, 5.0f},
+                                        {2.0f, 1.0f, 4.0f, -3.0f}, {1.0f, 0.0f, 5.0f, 0.0f} };
+  static_assert(matrix2.determinant() == -2.0f);
+  static_assert(matrix3.determinant() == 25.0f);
+  static_assert(matrix4.determinant() == 30.0f);
+  static_assert(matrix4.transpose().determinant() == 30.0f);
+  static_assert(matrix3.transpose().at(0, 2) == matrix3.at(2, 0) && matrix3.transpose().at(2, 0) == matrix3.at(0, 2));
+}
+
+template <class FLOAT, size_t N>
+void expect_identity(const SquareMatrix<FLOAT, N> & matrix, FLOAT epsilon) {
+  for (size_t c = 0; c < N; ++c) {
+    for (size_t r = 0; r < N; ++r) {
+      EXPECT_NEAR(r == c ? 1.0 : 0.0, matrix.at(r, c), epsilon);
+    }
+  }
+}
+
+// Testet die Inversen in geschlossener Form für N = 2, 3, 4
+TEST(MATRIX, InverseClosedForm) {
+  SquareMatrix2df matrix2 = { {1.0f, 2.0f}, {3.0f, 4.0f} };
+  SquareMatrix3df matrix3 = { {2.0f, 0.0f, 1.0f}, {1.0f, 3.0f, 0.0f}, {0.0f, 1.0f, 4.0f} };
+  SquareMatrix4df matrix4 = { {1.0f, 0.0f, 2.0f, -1.0f}, {3.0f, 0.0f, 0.0f, 5.0f},
+                              {2.0f, 1.0f, 4.0f, -3.0f}, {1.0f, 0.0f, 5.0f, 0.0f} };
+  expect_identity(matrix2 * matrix2.inverse(), 1e-6f);
+  expect_identity(matrix2.inverse() * matrix2, 1e-6f);
+  expect_identity(matrix3 * matrix3.inverse(), 1e-6f);
+  expect_identity(matrix3.inverse() * matrix3, 1e-6f);
+  expect_identity(matrix4 * matrix4.inverse(), 1e-6f);
+  expect_identity(matrix4.inverse() * matrix4, 1e-6f);
+}
+
+// Testet die LU-Zerlegung für N > 4, inklusive Zeilenvertauschung (Pivot 0 auf der Diagonalen)
+TEST(MATRIX, InverseAndDeterminantByLUDecomposition) {
+  SquareMatrix<double, 5u> matrix = { {0.0, 2.0, 1.0, 0.0, 3.0}, {1.0, 0.0, 2.0, 1.0, 0.0},
+                                      {4.0, 1.0, 0.0, 2.0, 1.0}, {0.0, 3.0, 1.0, 0.0, 2.0},
+                                      {2.0, 0.0, 1.0, 5.0, 1.0} };
+  expect_identity(matrix * matrix.inverse(), 1e-12);
+  expect_identity(matrix.inverse() * matrix, 1e-12);
+  EXPECT_NEAR(1.0, matrix.determinant() * matrix.inverse().determinant(), 1e-12);
+
+  // Vertauschen zweier Spalten ändert das Vorzeichen
+  SquareMatrix<double, 5u> swapped = matrix;
+  std::swap(swapped[0], swapped[1]);
+  EXPECT_NEAR(-matrix.determinant(), swapped.determinant(), 1e-9);
+
+  SquareMatrix<double, 5u> triangular = { {2.0, 0.0, 0.0, 0.0, 0.0}, {1.0, 3.0, 0.0, 0.0, 0.0},
+                                          {4.0, 1.0, -1.0, 0.0, 0.0}, {0.0, 3.0, 1.0, 0.5, 0.0},
+                                          {2.0, 0.0, 1.0, 5.0, 4.0} };
+  EXPECT_DOUBLE_EQ(-12.0, triangular.determinant());
+  triangular[2] = triangular[1];
+  EXPECT_EQ(0.0, triangular.determinant());
+}
+
+// Testet, ob transformierte Normalen senkrecht auf transformierten Tangenten bleiben
+TEST(MATRIX, NormalMatrixKeepsNormalsPerpendicular) {
+  SquareMatrix4df model = { {0.0f, 2.0f, 0.0f, 0.0f}, {-0.5f, 0.0f, 0.0f, 0.0f},
+                            {0.0f, 0.0f, 3.0f, 0.0f}, {5.0f, 6.0f, 7.0f, 1.0f} };
+  Vector3df normal = {1.0f, 1.0f, 0.0f};
+  Vector4df tangent = {1.0f, -1.0f, 0.0f, 0.0f};
+  Vector3df transformed_normal = model.normal_matrix() * normal;
+  Vector4df transformed_tangent = model * tangent;
+  EXPECT_NEAR(0.0f, transformed_normal[0] * transformed_tangent[0] + transformed_normal[1] * transformed_tangent[1]
+                    + transformed_normal[2] * transformed_tangent[2], 1e-6f);
+  // a rotation is its own normal matrix
+  SquareMatrix4df rotation = { {0.0f, 1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f, 0.0f},
+                               {0.0f, 0.0f, 1.0f, 0.0f}, {5.0f, 6.0f, 7.0f, 1.0f} };
+  SquareMatrix3df normal_matrix = rotation.normal_matrix();
+  for (size_t c = 0; c < 3; ++c) {
+    for (size_t r = 0; r < 3; ++r) {
+      EXPECT_FLOAT_EQ(rotation.at(r, c), normal_matrix.at(r, c));
+    }
+  }
+}
+
+// Testet, ob transform_points dasselbe Ergebnis liefert wie das Produkt für jeden einzelnen Punkt
+TEST(MATRIX, TransformPointsEqualsProduct) {
+  SquareMatrix4df matrix4 = { {1.0f, 2.0f, -2.0f, 0.5f}, {3.0f, 4.0f, 5.0f, -1.0f},
+                              {0.0f, -2.0f, -1.0f, 2.0f}, {7.0f, 0.25f, 3.0f, 1.0f} };
+  SquareMatrix3df matrix3 = { {0.1f, 2.3f, -1.7f}, {3.3f, 0.7f, 5.1f}, {-0.9f, 1e-7f, -1.3f} };
+  std::vector<Vector4df> points4;
+  std::vector<Vector3df> points3;
+  for (size_t i = 0u; i < 11u; i++) {
+    points4.push_back(Vector4df{0.5f * i, 1.0f - i, 2.0f, 1.0f});
+    points3.push_back(Vector3df{0.3f * i, 1.0f - i, -0.7f});
+  }
+  std::vector<Vector4df> result4(points4.size());
+  std::vector<Vector3df> result3(points3.size());
+  transform_points(matrix4, points4, result4);
+  transform_points(matrix3, points3, result3);
+  for (size_t i = 0u; i < points4.size(); i++) {
+    Vector4df expected4 = matrix4 * points4[i];
+    Vector3df expected3 = matrix3 * points3[i];
+    for (size_t r = 0u; r < 4u; r++) {
+      EXPECT_EQ(expected4[r], result4[i][r]);
+    }
+    for (size_t r = 0u; r < 3u; r++) {
+      EXPECT_EQ(expected3[r], result3[i][r]);
+    }
+  }
+}
+
+// Testet die affine 2D-Variante (ungerade Anzahl Punkte) gegen das homogene Produkt
+TEST(MATRIX, TransformPoints2dEqualsHomogeneousProduct) {
+  SquareMatrix3df transformation = affine_2d(Vector2df{100.0f, 50.0f}, 0.7f, 2.0f);
+  std::vector<Vector2df> points;
+  for (size_t i = 0u; i < 7u; i++) {
+    points.push_back(Vector2df{0.5f * i - 1.0f, 3.0f - i});
+  }
+  std::vector<Vector2df> result(points.size());
+  transform_points(transformation, points, result);
+  for (size_t i = 0u; i < points.size(); i++) {
+    Vector3df expected = transformation * Vector3df{points[i][0], points[i][1], 1.0f};
+    EXPECT_NEAR(expected[0], result[i][0], 1e-4f);
+    EXPECT_NEAR(expected[1], result[i][1], 1e-4f);
+  }
+  // Drehung um 90 Grad, Skalierung und Verschiebung
+  SquareMatrix3df quarter_turn = affine_2d(Vector2df{10.0f, 20.0f}, static_cast<float>(PI / 2.0), 2.0f);
+  transform_points(quarter_turn, std::span<const Vector2df>(points).first(1u), std::span(result).first(1u));
+  EXPECT_NEAR(10.0f - 2.0f * points[0][1], result[0][0], 1e-5f);
+  EXPECT_NEAR(20.0f + 2.0f * points[0][0], result[0][1], 1e-5f);
+}
+
+template <class F, size_t N>
+constexpr SquareMatrix<F, N> create_large_matrix(size_t seed) {
+  SquareMatrix<F, N> matrix;
+  for (size_t column = 0u; column < N; column++) {
+    for (size_t row = 0u; row < N; row++) {
+      matrix.at(row, column) = static_cast<F>((row * 7u + column * 13u + seed) % 17u) / F{8} - F{1};
+    }
+  }
+  return matrix;
+}
+
+// Testet das blockweise Produkt großer Matrizen (N kein Vielfaches der Kachelbreite) gegen die Auswertung zur Übersetzungszeit
+TEST(MATRIX, BlockedProductEqualsConstantEvaluation) {
+  constexpr SquareMatrix<float, 37u> factor1 = create_large_matrix<float, 37u>(1u);
+  constexpr SquareMatrix<float, 37u> factor2 = create_large_matrix<float, 37u>(5u);
+  constexpr SquareMatrix<float, 37u> expected = factor1 * factor2;
+  SquareMatrix<float, 37u> product = factor1 * factor2;
+  for (size_t c = 0; c < 37u; ++c) {
+    for (size_t r = 0; r < 37u; ++r) {
+      EXPECT_EQ(expected.at(r, c), product.at(r, c));
+    }
+  }
+}
+
+// Testet das parallele Produkt sehr großer Matrizen gegen die einfache Dreifachschleife
+TEST(MATRIX, ParallelProductEqualsNaiveProduct) {
+  auto factor1 = std::make_unique<SquareMatrix<double, 130u>>(create_large_matrix<double, 130u>(2u));
+  auto factor2 = std::make_unique<SquareMatrix<double, 130u>>(create_large_matrix<double, 130u>(3u));
+  auto product = std::make_unique<SquareMatrix<double, 130u>>(*factor1 * *factor2);
+  for (size_t c = 0; c < 130u; ++c) {
+    for (size_t r = 0; r < 130u; ++r) {
+      double sum = 0.0;
+      for (size_t k = 0; k < 130u; ++k) {
+        sum += factor1->at(r, k) * factor2->at(k, c);
+      }
+      EXPECT_EQ(sum, product->at(r, c));
+    }
+  }
+}
+
+// Testet die Aufteilung in Bereiche für mehrere Threads
+TEST(MATRIX, ParallelForCoversAllColumns) {
+  for (unsigned threads : { 1u, 3u, 8u }) {
+    std::vector<std::atomic<int>> calls(130u);
+    blocked::parallel_for(calls.size(), 4u, [&](size_t first, size_t last) {
+      EXPECT_EQ(0u, first % 4u);
+      for (size_t i = first; i < last; i++) {
+        calls[i]++;
+      }
+    }, threads);
+    for (auto & count : calls) {
+      EXPECT_EQ(1, count);
+    }
+  }
+}
+
+// Testet alle Varianten der Batch-Kernel gegen die skalare Referenz
+TEST(BATCH, TransformAndMultiplyOfEachIsaEqualScalar) {
+  SquareMatrix4df matrix = { {1.0f, 2.0f, -2.0f, 0.5f}, {3.0f, 4.0f, 5.0f, -1.0f},
+                             {0.0f, -2.0f, -1.0f, 2.0f}, {7.0f, 0.25f, 3.0f, 1.0f} };
+  std::vector<Vector4df> points;
+  for (size_t i = 0u; i < 11u; i++) {
+    points.push_back(Vector4df{0.5f * i, 1.0f - i, 2.0f, 1.0f});
+  }
+  std::vector<Vector4df> expected(points.size());
+  batch::get_kernels(batch::Isa::scalar).transform(matrix, points, expected);
+  SquareMatrix4df expected_product;
+  batch::get_kernels(batch::Isa::scalar).multiply(matrix, matrix, expected_product);
+
+  for (batch::Isa isa : { batch::Isa::scalar, batch::Isa::sse2, batch::Isa::avx2, batch::Isa::avx512 }) {
+    if (! batch::is_supported(isa)) {
+      continue;
+    }
+    SCOPED_TRACE(batch::get_name(isa));
+    std::vector<Vector4df> result(points.size());
+    batch::get_kernels(isa).transform(matrix, points, result);
+    for (size_t i = 0u; i < points.size(); i++) {
+      Vector4df reference = matrix * points[i];
+      for (ssize_t r = 0; r < 4; ++r) {
+        EXPECT_FLOAT_EQ(expected[i][r], result[i][r]);
+        EXPECT_FLOAT_EQ(reference[r], result[i][r]);
+      }
+    }
+
+    SquareMatrix4df product;
+    batch::get_kernels(isa).multiply(matrix, matrix, product);
+    SquareMatrix4df reference = matrix * matrix;
+    for (ssize_t c = 0; c < 4; ++c) {
+      for (ssize_t r = 0; r < 4; ++r) {
+        EXPECT_FLOAT_EQ(expected_product.at(r, c), product.at(r, c));
+        EXPECT_FLOAT_EQ(reference.at(r, c), product.at(r, c));
+      }
+    }
+  }
+}
+
 }
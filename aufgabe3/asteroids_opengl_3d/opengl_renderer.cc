@@ -3,107 +3,18 @@
 #include <span>
 #include <utility>
 
+#include "shapes.h"
 #include "wavefront.h"
 
 
 // geometric data as in original game and game coordinates
-std::vector<Vector2df> spaceship = {
-    Vector2df{-6.0f, 3.0f},
-    Vector2df{-6.0f, -3.0f},
-    Vector2df{-10.0f, -6.0f},
-    Vector2df{14.0f, 0.0f},
-    Vector2df{-10.0f, 6.0f},
-    Vector2df{-6.0f, 3.0f}
-};
-
-std::vector<Vector2df> flame = {
-    Vector2df{-6, 3},
-    Vector2df{-12, 0},
-    Vector2df{-6, -3}
-};
-
-std::vector<Vector2df> torpedo_points = {
+// (compiled in as constant data, no allocation at startup, the shapes shared with the game are in shapes.h)
+constexpr auto torpedo_points = std::to_array<Vector2df>({
     Vector2df{0, 0},
     Vector2df{0, 1}
-};
-
-std::vector<Vector2df> saucer_points = {
-    Vector2df{-16, -6},
-    Vector2df{16, -6},
-    Vector2df{40, 6},
-    Vector2df{-40, 6},
-    Vector2df{-16, 18},
-    Vector2df{16, 18},
-    Vector2df{40, 6},
-    Vector2df{16, -6},
-    Vector2df{8, -18},
-    Vector2df{-8, -18},
-    Vector2df{-16, -6},
-    Vector2df{-40, 6}
-};
-
-
-std::vector<Vector2df> asteroid_1 = {
-    Vector2df{0, -12},
-    Vector2df{16, -24},
-    Vector2df{32, -12},
-    Vector2df{24, 0},
-    Vector2df{32, 12},
-    Vector2df{8, 24},
-    Vector2df{-16, 24},
-    Vector2df{-32, 12},
-    Vector2df{-32, -12},
-    Vector2df{-16, -24},
-    Vector2df{0, -12}
-};
-
-std::vector<Vector2df> asteroid_2 = {
-    Vector2df{6, -6},
-    Vector2df{32, -12},
-    Vector2df{16, -24},
-    Vector2df{0, -16},
-    Vector2df{-16, -24},
-    Vector2df{-24, -12},
-    Vector2df{-16, -0},
-    Vector2df{-32, 12},
-    Vector2df{-16, 24},
-    Vector2df{-8, 16},
-    Vector2df{16, 24},
-    Vector2df{32, 6},
-    Vector2df{16, -6},
-};
+});
 
-std::vector<Vector2df> asteroid_3 = {
-    Vector2df{-16, 0},
-    Vector2df{-32, 6},
-    Vector2df{-16, 24},
-    Vector2df{0, 6},
-    Vector2df{0, 24},
-    Vector2df{16, 24},
-    Vector2df{32, 6},
-    Vector2df{32, 6},
-    Vector2df{16, -24},
-    Vector2df{-8, -24},
-    Vector2df{-32, -6}
-};
-
-std::vector<Vector2df> asteroid_4 = {
-    Vector2df{8, 0},
-    Vector2df{32, -6},
-    Vector2df{32, -12},
-    Vector2df{8, -24},
-    Vector2df{-16, -24},
-    Vector2df{-8, -12},
-    Vector2df{-32, -12},
-    Vector2df{-32, 12},
-    Vector2df{-16, 24},
-    Vector2df{8, 16},
-    Vector2df{16, 24},
-    Vector2df{32, 12},
-    Vector2df{8, 0}
-};
-
-std::vector<Vector2df> spaceship_debris = {
+constexpr auto spaceship_debris = std::to_array<Vector2df>({
     Vector2df{-2, -1},
     Vector2df{-10, 7},
     Vector2df{3, 1},
@@ -116,18 +27,18 @@ std::vector<Vector2df> spaceship_debris = {
     Vector2df{-6, -6},
     Vector2df{-2, 2},
     Vector2df{2, 5}
-};
+});
 
-std::vector<Vector2df> spaceship_debris_direction = {
+constexpr auto spaceship_debris_direction = std::to_array<Vector2df>({
     Vector2df{-40, -23},
     Vector2df{50, 15},
     Vector2df{0, 45},
     Vector2df{60, -15},
     Vector2df{10, -52},
     Vector2df{-40, 30}
-};
+});
 
-std::vector<Vector2df> debris_points = {
+constexpr auto debris_points = std::to_array<Vector2df>({
     Vector2df{-32, 32},
     Vector2df{-32, -16},
     Vector2df{-16, 0},
@@ -138,26 +49,27 @@ std::vector<Vector2df> debris_points = {
     Vector2df{24, -24},
     Vector2df{24, -32},
     Vector2df{32, -8}
-};
-
-std::vector<Vector2df> digit_0 = {{0, -8}, {4, -8}, {4, 0}, {0, 0}, {0, -8}};
-std::vector<Vector2df> digit_1 = {{4, 0}, {4, -8}};
-std::vector<Vector2df> digit_2 = {{0, -8}, {4, -8}, {4, -4}, {0, -4}, {0, 0}, {4, 0}};
-std::vector<Vector2df> digit_3 = {{0, 0}, {4, 0}, {4, -4}, {0, -4}, {4, -4}, {4, -8}, {0, -8}};
-std::vector<Vector2df> digit_4 = {{4, 0}, {4, -8}, {4, -4}, {0, -4}, {0, -8}};
-std::vector<Vector2df> digit_5 = {{0, 0}, {4, 0}, {4, -4}, {0, -4}, {0, -8}, {4, -8}};
-std::vector<Vector2df> digit_6 = {{0, -8}, {0, 0}, {4, 0}, {4, -4}, {0, -4}};
-std::vector<Vector2df> digit_7 = {{0, -8}, {4, -8}, {4, 0}};
-std::vector<Vector2df> digit_8 = {{0, -8}, {4, -8}, {4, 0}, {0, 0}, {0, -8}, {0, -4}, {4, -4}};
-std::vector<Vector2df> digit_9 = {{4, 0}, {4, -8}, {0, -8}, {0, -4}, {4, -4}};
-
-std::vector<std::vector<Vector2df> *> vertice_data = {
-    &spaceship, &flame,
-    &torpedo_points, &saucer_points,
-    &asteroid_1, &asteroid_2, &asteroid_3, &asteroid_4,
-    &spaceship_debris, &spaceship_debris_direction,
-    &debris_points,
-    &digit_0, &digit_1, &digit_2, &digit_3, &digit_4, &digit_5, &digit_6, &digit_7, &digit_8, &digit_9
+});
+
+constexpr auto digit_0 = std::to_array<Vector2df>({{0, -8}, {4, -8}, {4, 0}, {0, 0}, {0, -8}});
+constexpr auto digit_1 = std::to_array<Vector2df>({{4, 0}, {4, -8}});
+constexpr auto digit_2 = std::to_array<Vector2df>({{0, -8}, {4, -8}, {4, -4}, {0, -4}, {0, 0}, {4, 0}});
+constexpr auto digit_3 = std::to_array<Vector2df>({{0, 0}, {4, 0}, {4, -4}, {0, -4}, {4, -4}, {4, -8}, {0, -8}});
+constexpr auto digit_4 = std::to_array<Vector2df>({{4, 0}, {4, -8}, {4, -4}, {0, -4}, {0, -8}});
+constexpr auto digit_5 = std::to_array<Vector2df>({{0, 0}, {4, 0}, {4, -4}, {0, -4}, {0, -8}, {4, -8}});
+constexpr auto digit_6 = std::to_array<Vector2df>({{0, -8}, {0, 0}, {4, 0}, {4, -4}, {0, -4}});
+constexpr auto digit_7 = std::to_array<Vector2df>({{0, -8}, {4, -8}, {4, 0}});
+constexpr auto digit_8 = std::to_array<Vector2df>({{0, -8}, {4, -8}, {4, 0}, {0, 0}, {0, -8}, {0, -4}, {4, -4}});
+constexpr auto digit_9 = std::to_array<Vector2df>({{4, 0}, {4, -8}, {0, -8}, {0, -4}, {4, -4}});
+
+// views of all shape tables, in the order of the vbos created by createVbos()
+constexpr std::array<std::span<const Vector2df>, 21> vertice_data = {
+    shapes::spaceship, shapes::flame,
+    torpedo_points, shapes::saucer,
+    shapes::asteroid_1, shapes::asteroid_2, shapes::asteroid_3, shapes::asteroid_4,
+    spaceship_debris, spaceship_debris_direction,
+    debris_points,
+    digit_0, digit_1, digit_2, digit_3, digit_4, digit_5, digit_6, digit_7, digit_8, digit_9
 };
 
 // class OpenGLView
@@ -252,6 +164,17 @@ void OpenGLView::render(SquareMatrix<float, 4> &matrice) {
         transformLoc = glGetUniformLocation(shaderProgram, "transform");
     }
         glUniformMatrix4fv(transformLoc, 1, GL_FALSE, &matrice[0][0]);
+    if (is3d) {
+        // once per object instead of per vertex, the columns of a SquareMatrix3df are padded
+        SquareMatrix3df normal_matrix = matrice.normal_matrix();
+        std::array<float, 9> columns;
+        for (size_t column = 0u; column < 3u; column++) {
+            for (size_t row = 0u; row < 3u; row++) {
+                columns[3u * column + row] = normal_matrix.at(row, column);
+            }
+        }
+        glUniformMatrix3fv(glGetUniformLocation(shaderProgram, "normal_matrix"), 1, GL_FALSE, columns.data());
+    }
 
     const int vertex_division = is3d ? 9 : 1;
     // draw call/rendern
@@ -268,27 +191,9 @@ TypedBodyView::TypedBodyView(TypedBody *typed_body, GLuint vbo, unsigned int sha
       modify(modify) {
 }
 
-SquareMatrix4df TypedBodyView::create_object_transformation(Vector3df direction, float angle, float scale) {
-    SquareMatrix4df translation = {
-        {1.0f, 0.0f, 0.0f, 0.0f},
-        {0.0f, 1.0f, 0.0f, 0.0f},
-        {0.0f, 0.0f, 1.0f, 0.0f},
-        {direction[0], direction[1], direction[2], 1.0f}
-    };
-    SquareMatrix4df rotation = {
-        {std::cos(angle), std::sin(angle), 0.0f, 0.0f},
-        {-std::sin(angle), std::cos(angle), 0.0f, 0.0f},
-        {0.0f, 0.0f, 1.0f, 0.0f},
-        {0.0f, 0.0f, 0.0f, 1.0f}
-    };
-    SquareMatrix4df scaling = {
-        {scale, 0.0f, 0.0f, 0.0f},
-        {0.0f, scale, 0.0f, 0.0f},
-        {0.0f, 0.0f, scale, 0.0f},
-        {0.0f, 0.0f, 0.0f, 1.0f}
-    };
-
-    return translation * rotation * scaling;
+// translation * rotation * scaling, composed directly instead of two matrix products
+Affine3f TypedBodyView::create_object_transformation(Vector3df direction, Quaternionf orientation, float scale) {
+    return Affine3f(direction, orientation.to_rotation_matrix(), scale);
 }
 
 
@@ -297,11 +202,16 @@ void TypedBodyView::render(SquareMatrix<float, 4>& world) {
         modify(this);
         Vector2df position_2d = typed_body->get_position();
         Vector3df position_3d = {position_2d[0], position_2d[1], 0.0f};
-        auto transform = world * create_object_transformation(position_3d, typed_body->get_angle(), scale);
+        Quaternionf heading({0.0f, 0.0f, 1.0f}, typed_body->get_angle());
+        auto transform = world * create_object_transformation(position_3d, heading * orientation, scale).to_matrix();
         OpenGLView::render(transform);
     }
 }
 
+void TypedBodyView::tumble(float seconds) {
+    orientation.integrate(angular_velocity, seconds);
+}
+
 TypedBody *TypedBodyView::get_typed_body() {
     return typed_body;
 }
@@ -310,6 +220,10 @@ void TypedBodyView::set_scale(float scale) {
     this->scale = scale;
 }
 
+void TypedBodyView::set_angular_velocity(Vector3df angular_velocity) {
+    this->angular_velocity = angular_velocity;
+}
+
 // class OpenGLRenderer
 
 void OpenGLRenderer::createVbos() {
@@ -318,7 +232,7 @@ void OpenGLRenderer::createVbos() {
 
     for (size_t i = 0; i < vertice_data.size(); i++) {
         glBindBuffer(GL_ARRAY_BUFFER, vbos[i]);
-        glBufferData(GL_ARRAY_BUFFER, vertice_data[i]->size() * sizeof(Vector2df), vertice_data[i]->data(),
+        glBufferData(GL_ARRAY_BUFFER, vertice_data[i].size() * sizeof(Vector2df), vertice_data[i].data(),
                      GL_STATIC_DRAW);
     }
 }
@@ -380,17 +294,24 @@ void OpenGLRenderer::create(Asteroid *asteroid, std::vector<std::unique_ptr<Type
     debug(4, "create(Asteroid *) entry...");
     //GLuint rock_vbo_index = 4 + asteroid->get_rock_type();
 
-    float scale = (asteroid->get_size() == 3 ? 1.0 : (asteroid->get_size() == 2 ? 0.5 : 0.25));
+    // the mesh rotates around its origin, the sphere around the origin containing the smallest sphere
+    // of the mesh is scaled to the bounding volume used by the physics
+    const Sphere3df & bounds = mesh_bounds[2].sphere;
+    float scale = asteroid->get_bounding_volume().get_radius() / (bounds.get_center().length() + bounds.get_radius());
 
     views.push_back(std::make_unique<TypedBodyView>(asteroid, vbos3d[2], shaderProgram3d,
                                                     vertice_3d_data[2].size(),
                                                     scale, GL_TRIANGLES, true));
+    // every rock type tumbles around its own axis, smaller rocks faster
+    constexpr Vector3df tumble_axes[] = { {0.6f, 0.8f, 0.0f}, {0.0f, 0.6f, -0.8f},
+                                          {-0.8f, 0.0f, 0.6f}, {0.48f, 0.6f, 0.64f} };
+    views.back()->set_angular_velocity((0.6f / scale) * tumble_axes[asteroid->get_rock_type() % 4]);
     debug(4, "create(Asteroid *) exit.");
 }
 
 void OpenGLRenderer::create(SpaceshipDebris *debris, std::vector<std::unique_ptr<TypedBodyView> > &views) {
     debug(4, "create(SpaceshipDebris *) entry...");
-    views.push_back(std::make_unique<TypedBodyView>(debris, vbos[10], shaderProgram, vertice_data[10]->size(), 0.1f,
+    views.push_back(std::make_unique<TypedBodyView>(debris, vbos[10], shaderProgram, vertice_data[10].size(), 0.1f,
                                                     GL_POINTS, false,
                                                     []() -> bool { return true; },
                                                     [debris](TypedBodyView *view) -> void {
@@ -414,13 +335,13 @@ void OpenGLRenderer::create(Debris *debris, std::vector<std::unique_ptr<TypedBod
 }
 
 void OpenGLRenderer::createSpaceShipView() {
-    spaceship_view = std::make_unique<OpenGLView>(vbos[0], shaderProgram, vertice_data[0]->size(),
+    spaceship_view = std::make_unique<OpenGLView>(vbos[0], shaderProgram, vertice_data[0].size(),
                                                   GL_LINE_LOOP, false );
 }
 
 void OpenGLRenderer::createDigitViews() {
     for (size_t i = 0; i < 10; i++) {
-        digit_views[i] = std::make_unique<OpenGLView>(vbos[11 + i], shaderProgram, vertice_data[11 + i]->size(),
+        digit_views[i] = std::make_unique<OpenGLView>(vbos[11 + i], shaderProgram, vertice_data[11 + i].size(),
                                                       GL_LINE_STRIP, false);
     }
 }
@@ -430,11 +351,11 @@ void OpenGLRenderer::renderFreeShips(const SquareMatrix4df &matrice) const
 {
     constexpr float FREE_SHIP_X = 128;
     constexpr float FREE_SHIP_Y = 64;
-    const auto PIf = static_cast<float>(PI);
     Vector2df position = {FREE_SHIP_X, FREE_SHIP_Y};
-    SquareMatrix4df rotation = {
-        {std::cos(-PIf / 2.0f), std::sin(-PIf / 2.0f), 0.0f, 0.0f},
-        {-std::sin(-PIf / 2.0f), std::cos(-PIf / 2.0f), 0.0f, 0.0f},
+    // rotation by -PI/2 (cos = 0, sin = -1)
+    constexpr SquareMatrix4df rotation = {
+        {0.0f, -1.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 0.0f, 0.0f},
         {0.0f, 0.0f, 1.0f, 0.0f},
         {0.0f, 0.0f, 0.0f, 1.0f}
     };
@@ -490,11 +411,12 @@ void OpenGLRenderer::create_3dshader_programs()
         "out vec3 color;\n"
         "out vec4 normal;\n"
         "uniform mat4 model;\n"
+        "uniform mat3 normal_matrix;\n"
         "void main()\n"
         "{\n"
         "gl_Position = model * vec4(position, 1.0);\n"
         "color = incolor;\n"
-        "normal = normalize( model * vec4(innormal, 1.0));\n"
+        "normal = vec4(normalize(normal_matrix * innormal), 0.0);\n"
         "}\0";
 
     auto const fragmentShaderSource3d = "#version 330 core\n"
@@ -625,6 +547,7 @@ std::vector<Vector2df> get_points(const std::vector<float> &vertices) {
 
 bool OpenGLRenderer::load_objects(const std::vector<std::string>& object_files) {
     vertice_3d_data.clear();
+    mesh_bounds.clear();
     bool success = true;
 
     for (const auto& file : object_files) {
@@ -637,6 +560,15 @@ bool OpenGLRenderer::load_objects(const std::vector<std::string>& object_files)
         WavefrontImporter wi(in);
         wi.parse();
         vertice_3d_data.push_back(create_vertices(wi));
+
+        std::vector<Vector3df> points;
+        for (const auto &vertice: wi.get_vertices()) {
+            points.push_back({vertice[0], vertice[1], vertice[2]});
+        }
+        if (points.empty()) {
+            points.push_back(Vector3df{}); // an empty object has bounds of size 0
+        }
+        mesh_bounds.emplace_back(points);
     }
 
     return success;
@@ -700,7 +632,7 @@ bool OpenGLRenderer::init() {
   | 6 | 8 | 3 |
   +---+---+---+
 */
-static Vector2df tile_positions[] = {
+constexpr Vector2df tile_positions[] = {
     {0.0f, 0.0f},
     {1024.0f, 0.0f},
     {1024.0f, 768.0f},
@@ -780,8 +712,16 @@ void OpenGLRenderer::render() {
         }
     }
 
+    // the orientations advance by the time since the previous frame, independent of the frame rate
+    Uint64 ticks = SDL_GetTicks64();
+    float seconds = last_frame_ticks == 0 ? 0.0f : static_cast<float>(ticks - last_frame_ticks) / 1000.0f;
+    last_frame_ticks = ticks;
+    for (auto &view: views) {
+        view->tumble(seconds);
+    }
+
     debug(2, "render all views");
-    const std::vector<Vector2df> kachels = {
+    const std::array<Vector2df, 9> kachels = {{
         {static_cast<float>(-window_width), static_cast<float>(window_height)},
         {0.0f, static_cast<float>(window_height)},
         {static_cast<float>(window_width), static_cast<float>(window_height)},
@@ -789,7 +729,7 @@ void OpenGLRenderer::render() {
         {static_cast<float>(-window_width), static_cast<float>(-window_height)},
         {0.0f, static_cast<float>(-window_height)},
         {static_cast<float>(window_width), static_cast<float>(-window_height)}
-    };
+    }};
     for (auto &kachel: kachels) {
         SquareMatrix4df kachel_position_translation = {
             {1.0f, 0.0f, 0.0f, 0.0f},
@@ -10,10 +10,12 @@
 #include <functional>
 #include <string>
 #include "matrix.h"
+#include "quaternion.h"
 #include "physics.h"
 #include "game.h"
 #include "renderer.h"
 #include "debug.h"
+#include "geometry.h"
 #include "wavefront.h"
 
 // stores information on how to render a specific vertex buffer (vbo)
@@ -38,8 +40,10 @@ class TypedBodyView : public OpenGLView {
     float scale;
     std::function<bool()> draw;
     std::function<void(TypedBodyView*)> modify;
+    Quaternionf orientation;         // 3D orientation, applied before the body's angle in the x/y plane
+    Vector3df angular_velocity{};    // tumbling in radians per second
 
-    SquareMatrix4df create_object_transformation(Vector3df direction, float angle, float scale);
+    Affine3f create_object_transformation(Vector3df direction, Quaternionf orientation, float scale);
 
 public:
     TypedBodyView(TypedBody* typed_body, GLuint vbo, unsigned int shaderProgram, size_t vertices_size,
@@ -47,8 +51,10 @@ public:
                   std::function<bool()> draw = []() -> bool { return true; },
                   std::function<void(TypedBodyView*)> modify = [](TypedBodyView*) -> void {});
     void render(SquareMatrix<float, 4>& world);
+    void tumble(float seconds);      // once per frame, not per rendered tile
     TypedBody* get_typed_body();
     void set_scale(float scale);
+    void set_angular_velocity(Vector3df angular_velocity);
 };
 
 class OpenGLRenderer : public Renderer {
@@ -62,7 +68,9 @@ class OpenGLRenderer : public Renderer {
     std::vector<GLuint> vbos;
     std::vector<GLuint> vbos3d;
     std::vector<std::vector<float>> vertice_3d_data;
+    std::vector<MeshBounds3df> mesh_bounds; // of the loaded objects, in model coordinates
     std::vector<std::unique_ptr<TypedBodyView>> views;
+    Uint64 last_frame_ticks = 0;     // of the previous frame in milliseconds, 0 before the first frame
     std::unique_ptr<OpenGLView> spaceship_view;
     std::array<std::unique_ptr<OpenGLView>, 10> digit_views;
 
@@ -20,6 +20,10 @@ public:
 
   bool collides(BoundingVolumeCircle<FLOAT_TYPE, N> volume) const;
 
+  // returns the smallest t >= 0 such that the given volume moved by t * relative_velocity collides with this one,
+  // INFINITY if they never collide
+  FLOAT_TYPE time_of_impact(BoundingVolumeCircle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> relative_velocity) const;
+
   FLOAT_TYPE get_radius() const;
   
   Vector<FLOAT_TYPE,N> get_position() const;
@@ -40,6 +44,10 @@ public:
 
   bool collides(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume) const;
 
+  // returns the smallest t >= 0 such that the given volume moved by t * relative_velocity collides with this one,
+  // INFINITY if they never collide
+  FLOAT_TYPE time_of_impact(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> relative_velocity) const;
+
   FLOAT_TYPE get_edge_length(size_t edge) const;
   
   Vector<FLOAT_TYPE,N> get_position() const;
@@ -65,6 +73,7 @@ protected:
 
   Counter delete_counter;
   bool deletable = false;
+  bool fast = false;
 public:
   Body(  BV bounding_volume,
          Vector<FLOAT_TYPE, N> velocity, 
@@ -108,6 +117,12 @@ public:
   Vector<FLOAT_TYPE,N> get_position() const;
     
   void set_position(Vector<FLOAT_TYPE,N> position);  
+
+  // the collisions of fast bodies are detected along their whole movement during a tick, not only at its end,
+  // so they do not tunnel through small bodies at low tick rates
+  void set_fast(bool fast);
+
+  bool is_fast() const;
   
   friend class Physics<FLOAT_TYPE, N, BV>;
 
@@ -139,6 +154,10 @@ class Physics {
 
 
   FLOAT_TYPE tick_time = 1.0;
+
+  // continuous collision detection: returns true iff the bounding volumes of the bodies collide anywhere
+  // on their (linear) movement during the last tick, a wrap around by the fix function is not swept
+  static bool collides_during_tick(const Body<FLOAT_TYPE, N, BV> & body1, const Body<FLOAT_TYPE, N, BV> & body2, FLOAT_TYPE tick_time);
 public:
 
   Physics( std::function<bool(Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *)> check_collision
@@ -168,7 +187,8 @@ public:
   // 1. adds all new Body object to this engine,
   // 2. removes all Body object, that has to be deleted from it
   // 3. moves all objects according to the current tick_time
-  // 4. checks for collisions and uses the callback handler to resolve them
+  // 4. checks for collisions and uses the callback handler to resolve them,
+  //    the movements of fast bodies are checked completely (continuous collision detection)
   // 5. removes all Body objects, that has to be deleted
   void tick();
   
@@ -1,6 +1,7 @@
 #include <utility>
 #include <cassert>
 #include "debug.h"
+#include "vector_expression.h"
 
 template<class FLOAT_TYPE, size_t N>
 BoundingVolumeCircle<FLOAT_TYPE, N>::BoundingVolumeCircle(Vector<FLOAT_TYPE,N> position, FLOAT_TYPE radius) 
@@ -11,6 +12,11 @@ bool BoundingVolumeCircle<FLOAT_TYPE, N>::collides(BoundingVolumeCircle<FLOAT_TY
   return this->intersects(volume);
 }
 
+template<class FLOAT_TYPE, size_t N>
+FLOAT_TYPE BoundingVolumeCircle<FLOAT_TYPE, N>::time_of_impact(BoundingVolumeCircle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> relative_velocity) const {
+  return this->sweep_intersects(volume, relative_velocity);
+}
+
 template<class FLOAT_TYPE, size_t N>  
 FLOAT_TYPE BoundingVolumeCircle<FLOAT_TYPE, N>::get_radius() const {
   return this->radius;
@@ -41,6 +47,20 @@ bool BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::collides(BoundingVolumeHyperRec
  return collision;
 }
 
+// the position of the moving volume is a ray against this volume extended by the edge lengths of the moving one
+template<class FLOAT_TYPE, size_t N>
+FLOAT_TYPE BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::time_of_impact(BoundingVolumeHyperRectangle<FLOAT_TYPE, N> volume, Vector<FLOAT_TYPE, N> relative_velocity) const {
+  Vector<FLOAT_TYPE, N> center, half_edge_lengths;
+  for (size_t axis = 0u; axis < N; axis++) {
+    half_edge_lengths[axis] = 0.5f * (edge_lengths[axis] + volume.edge_lengths[axis]);
+    center[axis] = position[axis] - volume.edge_lengths[axis] + half_edge_lengths[axis];
+  }
+  AxisAlignedBoundingBox<FLOAT_TYPE, N> extended(center, half_edge_lengths);
+  PreparedRay<FLOAT_TYPE, N> ray(Ray<FLOAT_TYPE, N>{ volume.position, relative_velocity });
+  auto [t_near, t_far] = extended.slab_interval(ray, static_cast<FLOAT_TYPE>(0.0));
+  return t_near <= t_far ? t_near : INFINITY;
+}
+
 template<class FLOAT_TYPE, size_t N>  
 FLOAT_TYPE BoundingVolumeHyperRectangle<FLOAT_TYPE,N>::get_edge_length(size_t edge) const {
   return edge_lengths[edge];
@@ -82,10 +102,13 @@ void Body<FLOAT_TYPE, N, BV>::move(FLOAT_TYPE seconds) {
 }
   
 // turns the Body in the x/y-Plane 
-// angle is measured in radians
+// angle is measured in radians, the resulting angle is wrapped to (-PI, PI]
+// (fast::unit_vector is only accurate for arguments within [-8192, 8192])
 template<class FLOAT_TYPE, size_t N, class BV>
 void Body<FLOAT_TYPE, N, BV>::turn(FLOAT_TYPE angle, FLOAT_TYPE seconds) {
+  constexpr FLOAT_TYPE pi = static_cast<FLOAT_TYPE>(PI);
   this->angle += seconds * angle;
+  this->angle -= 2.0f * pi * std::ceil((this->angle - pi) / (2.0f * pi));
 }
 
 template<class FLOAT_TYPE, size_t N, class BV>
@@ -102,8 +125,13 @@ void Body<FLOAT_TYPE, N, BV>::set_velocity(Vector<FLOAT_TYPE, N> velocity) {
 template<class FLOAT_TYPE, size_t N, class BV>
 void Body<FLOAT_TYPE, N, BV>::accelerate(FLOAT_TYPE acceleration, FLOAT_TYPE seconds) {
   if (N >= 2) {
-    Vector<FLOAT_TYPE, N> velocity = this->velocity + seconds * acceleration * Vector<FLOAT_TYPE,N>{ std::cos(angle), std::sin(angle) };   
-    set_velocity(velocity);
+    Vector<FLOAT_TYPE, N> direction;
+    if constexpr (std::is_same_v<FLOAT_TYPE, float>) {
+      direction = fast::unit_vector<N>(angle);
+    } else {
+      direction = { std::cos(angle), std::sin(angle) };
+    }
+    set_velocity(expr::lazy(this->velocity) + (seconds * acceleration) * expr::lazy(direction));
   }
 }
 
@@ -127,6 +155,17 @@ void Body<FLOAT_TYPE, N, BV>::set_position(Vector<FLOAT_TYPE,N> position) {
 }
 
 
+template<class FLOAT_TYPE, size_t N, class BV>
+void Body<FLOAT_TYPE, N, BV>::set_fast(bool fast) {
+  this->fast = fast;
+}
+
+template<class FLOAT_TYPE, size_t N, class BV>
+bool Body<FLOAT_TYPE, N, BV>::is_fast() const {
+  return fast;
+}
+
+
 template<class FLOAT_TYPE, size_t N, class BV>
 void Body<FLOAT_TYPE, N, BV>::mark_for_deletion() {
   set_time_to_delete(0.0);
@@ -221,6 +260,17 @@ std::vector< Body<FLOAT_TYPE, N, BV> * > & Physics<FLOAT_TYPE, N, BV>::get_recen
 }
 
 
+// the positions at the beginning of the tick are reconstructed from the velocities,
+// the movement of body2 relative to body1 is swept against body1 at its start position
+template<class FLOAT_TYPE, size_t N, class BV>
+bool Physics<FLOAT_TYPE, N, BV>::collides_during_tick(const Body<FLOAT_TYPE, N, BV> & body1, const Body<FLOAT_TYPE, N, BV> & body2, FLOAT_TYPE tick_time) {
+  BV start1 = body1.bounding;
+  BV start2 = body2.bounding;
+  start1.set_position( body1.get_position() - tick_time * body1.velocity );
+  start2.set_position( body2.get_position() - tick_time * body2.velocity );
+  return start1.time_of_impact(start2, body2.velocity - body1.velocity) <= tick_time;
+}
+
 template<class FLOAT_TYPE, size_t N, class BV>
 void Physics<FLOAT_TYPE, N, BV>::tick() {
   Physics<FLOAT_TYPE, N, BV>::tick(tick_time);
@@ -252,7 +302,8 @@ void Physics<FLOAT_TYPE, N, BV>::tick(FLOAT_TYPE tick_time) {
    
   for (auto iterator1 = bodies.begin(); iterator1 != bodies.end(); iterator1++ ) {
     for (auto iterator2 = iterator1 + 1; iterator2 != bodies.end(); iterator2++) {
-      if ( (*iterator1)->bounding.collides( (*iterator2)->bounding)   ) {
+      if ( (*iterator1)->bounding.collides( (*iterator2)->bounding)
+           || ( ((*iterator1)->fast || (*iterator2)->fast) && collides_during_tick(**iterator1, **iterator2, tick_time) ) ) {
         if (check_collision( (*iterator1).get(), (*iterator2).get()) ) {
           bodies_to_resolve.push_back( std::pair<Body<FLOAT_TYPE, N, BV> *, Body<FLOAT_TYPE, N, BV> *>( (*iterator1).get(), (*iterator2).get()) );
         }
@@ -33,6 +33,14 @@ TEST(BOUNDING_VOLUME, CollidesInside2) {
 }
 
 
+TEST(BOUNDING_VOLUME, TimeOfImpact) {
+  BoundingVolume2df asteroid( {100.0, 0.0}, 11.0 );
+  BoundingVolume2df torpedo( {0.0, 0.0}, 1.0 );
+
+  EXPECT_NEAR(0.25, asteroid.time_of_impact(torpedo, {352.0, 0.0}), 0.00001);
+  EXPECT_EQ(INFINITY, asteroid.time_of_impact(torpedo, {0.0, 352.0}));
+}
+
 TEST(RECT_BOUNDING_VOLUME, DoesNotCollide) {
   Rectangle2df boundingVolume1( {0.0, 0.0}, {1.0, 1.0} );
   Rectangle2df boundingVolume2( {2.0, 2.0}, {0.5, 0.5} );
@@ -62,6 +70,16 @@ TEST(RECT_BOUNDING_VOLUME, CollidesInside) {
 }
 
 
+TEST(RECT_BOUNDING_VOLUME, TimeOfImpact) {
+  Rectangle2df rectangle1( {10.0, 0.0}, {2.0, 2.0} );
+  Rectangle2df rectangle2( {0.0, 1.5}, {1.0, 1.0} );
+
+  EXPECT_NEAR(0.9, rectangle1.time_of_impact(rectangle2, {10.0, 0.0}), 0.00001);
+  EXPECT_EQ(0.0, rectangle1.time_of_impact(Rectangle2df({10.5, 0.5}, {1.0, 1.0}), {-10.0, 0.0}));
+  EXPECT_EQ(INFINITY, rectangle1.time_of_impact(rectangle2, {-10.0, 0.0}));
+  EXPECT_EQ(INFINITY, rectangle1.time_of_impact(Rectangle2df({0.0, 2.5}, {1.0, 1.0}), {10.0, 0.0}));
+}
+
 TEST(BODY, Move) {
   Body2df body( BoundingVolume2df({0.0, 0.0}, 1.0), {1.0, 0.0} );
   body.move();
@@ -124,6 +142,21 @@ TEST(BODY, AccelerateAndMove) {
   EXPECT_NEAR(0.0, body.get_position()[1], 0.00001);
 }
 
+TEST(BODY, TurnWrapsAngle) {
+  Body2df body( BoundingVolume2df({0.0, 0.0}, 1.0), {0.0, 0.0} );
+  body.turn(3.0f * static_cast<float>(PI), 1.0f);
+  EXPECT_NEAR(PI, body.get_angle(), 0.00001);
+  // an hour of turning at 4 radians per second in one direction
+  for (size_t i = 0; i < 60u * 60u * 60u; i++) {
+    body.turn(-4.0f, 1.0f / 60.0f);
+    EXPECT_LE(-PI, body.get_angle());
+    EXPECT_GE(PI, body.get_angle());
+  }
+  body.accelerate(1.0f);
+  EXPECT_NEAR(1.0f, body.get_velocity().length(), 0.00001);
+  EXPECT_NEAR(std::cos(body.get_angle()), body.get_velocity()[0], 0.00001);
+}
+
 TEST(BODY, AccelerateAndMoveWithMinimumVelocity) {
   Body2df body( BoundingVolume2df({0.0, 0.0}, 1.0), {1.0, 0.0}, 10.0, 1.0 );
   body.accelerate(-0.5);
@@ -298,4 +331,41 @@ TEST(PHYSICS, TickTime120) {
   EXPECT_NEAR(768.0, std::round(b->get_position()[1]), 0.00001);
 }
 
+
+// returns true iff a torpedo (radius 1) fired from (0, offset) with 768 pixel per second in x direction
+// collides with a small asteroid (radius 11) at (192, 0) moving with the given velocity during 1 s at 30 FPS
+bool torpedo_hits_asteroid(float offset, Vector2df asteroid_velocity, bool fast) {
+  std::unique_ptr<Body2df> torpedo = std::make_unique<Body2df>( BoundingVolume2df({0.0, offset}, 1.0), Vector2df{768.0, 0.0}, 768.0 );
+  std::unique_ptr<Body2df> asteroid = std::make_unique<Body2df>( BoundingVolume2df({192.0, 0.0}, 11.0), asteroid_velocity, 348.0 );
+  torpedo->set_fast(fast);
+  bool hit = false;
+  Physics2df physics( [](Body2df *, Body2df *) -> bool { return true; },
+                      [&](Body2df *, Body2df *) -> void { hit = true; } );
+  physics.add_body( torpedo );
+  physics.add_body( asteroid );
+  for (size_t i = 0; i < 30u; i++) {
+    physics.tick(1.0f / 30.0f);
+  }
+  return hit;
+}
+
+TEST(PHYSICS, TickTime30Tunneling) {
+  // the torpedo moves 25.6 pixels per tick, more than the sum of the diameters,
+  // and is at x = 179.2 and x = 204.8 after the ticks
+  EXPECT_FALSE(torpedo_hits_asteroid(0.0f, {0.0, 0.0}, false));
+  EXPECT_TRUE(torpedo_hits_asteroid(0.0f, {0.0, 0.0}, true));
+}
+
+TEST(PHYSICS, TickTime30NoTunneling) {
+  EXPECT_FALSE(Body2df( BoundingVolume2df({0.0, 0.0}, 1.0), Vector2df{0.0, 0.0} ).is_fast());
+  for (float offset = -11.75f; offset <= 11.75f; offset += 0.5f) {
+    EXPECT_TRUE(torpedo_hits_asteroid(offset, {0.0, 0.0}, true)) << offset;
+    // the torpedo reaches x = 192 after 0.25 s, the asteroid is at (192, 10) then
+    EXPECT_TRUE(torpedo_hits_asteroid(10.0f + offset, {0.0, 40.0}, true)) << offset;
+    EXPECT_TRUE(torpedo_hits_asteroid(offset, {-348.0, 0.0}, true)) << offset;
+  }
+  EXPECT_FALSE(torpedo_hits_asteroid(12.25f, {0.0, 0.0}, true));
+  EXPECT_FALSE(torpedo_hits_asteroid(-12.25f, {-348.0, 0.0}, true));
+}
+
 }
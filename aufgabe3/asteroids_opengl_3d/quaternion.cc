@@ -0,0 +1,9 @@
+#include "quaternion.h"
+
+template struct Quaternion<float>;
+
+template Quaternion<float> operator*(Quaternion<float> factor1, Quaternion<float> factor2);
+template Quaternion<float> nlerp(Quaternion<float> from, Quaternion<float> to, float t);
+template Quaternion<float> slerp(Quaternion<float> from, Quaternion<float> to, float t);
+template void integrate(std::span<Quaternion<float>> orientations,
+                        std::span<const Vector<float, 3u>> angular_velocities, float seconds);
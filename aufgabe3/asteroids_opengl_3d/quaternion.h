@@ -0,0 +1,79 @@
+#ifndef QUATERNION_H
+#define QUATERNION_H
+
+#include <span>
+#include "math.h"
+#include "matrix.h"
+
+// a quaternion w + x*i + y*j + z*k
+// unit quaternions represent orientations (rotations) in the three-dimensional space,
+// they are composed with 16 multiplications instead of the 64 of a 4x4 matrix product
+template <class FLOAT>
+struct Quaternion {
+  FLOAT w;
+  FLOAT x;
+  FLOAT y;
+  FLOAT z;
+
+  // creates the identity (no rotation)
+  constexpr Quaternion();
+
+  constexpr Quaternion(FLOAT w, FLOAT x, FLOAT y, FLOAT z);
+
+  // creates the rotation by angle (in radians) around the given axis
+  // axis must be a normalized vector
+  Quaternion(Vector<FLOAT, 3u> axis, FLOAT angle);
+
+  // returns the inverse rotation of this unit quaternion
+  constexpr Quaternion conjugate() const;
+
+  constexpr FLOAT square_of_length() const;
+
+  FLOAT length() const;
+
+  // normalize this Quaternion to the length 1,
+  // compensates the rounding errors of repeated compositions
+  void normalize();
+
+  // returns the vector v rotated by this unit quaternion
+  constexpr Vector<FLOAT, 3u> rotate(Vector<FLOAT, 3u> v) const;
+
+  // result[i] = rotation of vectors[i], both spans must have the same size
+  // the rotation matrix is computed once for all vectors
+  void rotate(std::span<const Vector<FLOAT, 3u>> vectors, std::span<Vector<FLOAT, 3u>> result) const;
+
+  // returns the (homogeneous) rotation matrix of this unit quaternion
+  constexpr SquareMatrix<FLOAT, 4u> to_matrix() const;
+
+  // returns the 3x3 rotation matrix of this unit quaternion, e.g. for an Affine3
+  constexpr SquareMatrix<FLOAT, 3u> to_rotation_matrix() const;
+
+  // turns this orientation with the given angular velocity (axis * radians per second)
+  // for the given time and normalizes the result
+  void integrate(Vector<FLOAT, 3u> angular_velocity, FLOAT seconds);
+
+  // returns the composition of both rotations, first factor2 and then factor1
+  template <class F>
+  friend constexpr Quaternion<F> operator*(Quaternion<F> factor1, Quaternion<F> factor2);
+};
+
+// normalized linear interpolation between from (t = 0) and to (t = 1) on the shorter arc
+template <class FLOAT>
+Quaternion<FLOAT> nlerp(Quaternion<FLOAT> from, Quaternion<FLOAT> to, FLOAT t);
+
+// spherical linear interpolation (constant angular velocity) between from and to on the shorter arc
+template <class FLOAT>
+Quaternion<FLOAT> slerp(Quaternion<FLOAT> from, Quaternion<FLOAT> to, FLOAT t);
+
+// integrates the orientations of many bodies at once, see Quaternion::integrate
+// both spans must have the same size
+template <class FLOAT>
+void integrate(std::span<Quaternion<FLOAT>> orientations,
+               std::span<const Vector<FLOAT, 3u>> angular_velocities, FLOAT seconds);
+
+typedef Quaternion<float> Quaternionf;
+
+// definitions are needed in every translation unit to allow constant evaluation
+#include "quaternion.tcc"
+
+#endif
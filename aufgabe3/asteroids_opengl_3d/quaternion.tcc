@@ -0,0 +1,187 @@
+#include <cassert>
+#include <type_traits>
+
+template <class FLOAT>
+constexpr Quaternion<FLOAT>::Quaternion() : Quaternion(1, 0, 0, 0) {}
+
+template <class FLOAT>
+constexpr Quaternion<FLOAT>::Quaternion(FLOAT w, FLOAT x, FLOAT y, FLOAT z) : w(w), x(x), y(y), z(z) {}
+
+template <class FLOAT>
+Quaternion<FLOAT>::Quaternion(Vector<FLOAT, 3u> axis, FLOAT angle) {
+  FLOAT sin_half = std::sin(angle / 2);
+  w = std::cos(angle / 2);
+  x = sin_half * axis[0];
+  y = sin_half * axis[1];
+  z = sin_half * axis[2];
+}
+
+template <class FLOAT>
+constexpr Quaternion<FLOAT> Quaternion<FLOAT>::conjugate() const {
+  return {w, -x, -y, -z};
+}
+
+template <class FLOAT>
+constexpr FLOAT Quaternion<FLOAT>::square_of_length() const {
+  return w * w + x * x + y * y + z * z;
+}
+
+template <class FLOAT>
+FLOAT Quaternion<FLOAT>::length() const {
+  return std::sqrt(square_of_length());
+}
+
+template <class FLOAT>
+void Quaternion<FLOAT>::normalize() {
+  FLOAT factor;
+  if constexpr (std::is_same_v<FLOAT, float>) {
+    factor = fast::rsqrt(square_of_length());
+  } else {
+    factor = 1 / length();
+  }
+  w *= factor;
+  x *= factor;
+  y *= factor;
+  z *= factor;
+}
+
+// v + 2w (u x v) + 2u x (u x v) with u = (x, y, z), the cross products are written out
+template <class FLOAT>
+constexpr Vector<FLOAT, 3u> Quaternion<FLOAT>::rotate(Vector<FLOAT, 3u> v) const {
+  FLOAT tx = 2 * (y * v[2] - z * v[1]);
+  FLOAT ty = 2 * (z * v[0] - x * v[2]);
+  FLOAT tz = 2 * (x * v[1] - y * v[0]);
+  return { v[0] + w * tx + (y * tz - z * ty),
+           v[1] + w * ty + (z * tx - x * tz),
+           v[2] + w * tz + (x * ty - y * tx) };
+}
+
+template <class FLOAT>
+void Quaternion<FLOAT>::rotate(std::span<const Vector<FLOAT, 3u>> vectors, std::span<Vector<FLOAT, 3u>> result) const {
+  assert(vectors.size() == result.size());
+  const SquareMatrix<FLOAT, 4u> rotation = to_matrix();
+  const size_t count = vectors.size();
+#ifdef MATH_SIMD
+  if constexpr (simd::accelerated<FLOAT, 3u>) {
+    // the padding of the columns is zero, so the padding of the results stays zero
+    const __m128 c0 = simd::load(rotation[0]);
+    const __m128 c1 = simd::load(rotation[1]);
+    const __m128 c2 = simd::load(rotation[2]);
+    for (size_t i = 0u; i < count; i++) {
+      __m128 v = simd::load(vectors[i]);
+      __m128 sum = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, 0x00));
+      sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, 0x55)));
+      sum = _mm_add_ps(sum, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, 0xaa)));
+      simd::store(result[i], sum);
+    }
+    return;
+  }
+#endif
+  const Vector<FLOAT, 4u> c0 = rotation[0];
+  const Vector<FLOAT, 4u> c1 = rotation[1];
+  const Vector<FLOAT, 4u> c2 = rotation[2];
+  for (size_t i = 0u; i < count; i++) {
+    const Vector<FLOAT, 3u> v = vectors[i];
+    for (size_t row = 0u; row < 3u; row++) {
+      result[i][row] = c0[row] * v[0] + c1[row] * v[1] + c2[row] * v[2];
+    }
+  }
+}
+
+template <class FLOAT>
+constexpr SquareMatrix<FLOAT, 4u> Quaternion<FLOAT>::to_matrix() const {
+  const SquareMatrix<FLOAT, 3u> rotation = to_rotation_matrix();
+  SquareMatrix<FLOAT, 4u> matrix;
+  for (size_t column = 0u; column < 3u; column++) {
+    for (size_t row = 0u; row < 3u; row++) {
+      matrix.at(row, column) = rotation.at(row, column);
+    }
+  }
+  matrix.at(3, 3) = 1;
+  return matrix;
+}
+
+template <class FLOAT>
+constexpr SquareMatrix<FLOAT, 3u> Quaternion<FLOAT>::to_rotation_matrix() const {
+  // element wise, the initializer lists of SquareMatrix and Vector are not optimized away
+  SquareMatrix<FLOAT, 3u> matrix;
+  matrix.at(0, 0) = 1 - 2 * (y * y + z * z);
+  matrix.at(1, 0) = 2 * (x * y + w * z);
+  matrix.at(2, 0) = 2 * (x * z - w * y);
+  matrix.at(0, 1) = 2 * (x * y - w * z);
+  matrix.at(1, 1) = 1 - 2 * (x * x + z * z);
+  matrix.at(2, 1) = 2 * (y * z + w * x);
+  matrix.at(0, 2) = 2 * (x * z + w * y);
+  matrix.at(1, 2) = 2 * (y * z - w * x);
+  matrix.at(2, 2) = 1 - 2 * (x * x + y * y);
+  return matrix;
+}
+
+// first order integration of dq/dt = 1/2 (0, angular_velocity) * q
+template <class FLOAT>
+void Quaternion<FLOAT>::integrate(Vector<FLOAT, 3u> angular_velocity, FLOAT seconds) {
+  const FLOAT a = seconds / 2 * angular_velocity[0];
+  const FLOAT b = seconds / 2 * angular_velocity[1];
+  const FLOAT c = seconds / 2 * angular_velocity[2];
+  *this = { w - (a * x + b * y + c * z),
+            x + (a * w + b * z - c * y),
+            y + (b * w + c * x - a * z),
+            z + (c * w + a * y - b * x) };
+  // the step changes the length only slightly, so one Newton-Raphson step
+  // for 1 / sqrt(square_of_length()) starting at 1 normalizes it (and vectorizes)
+  const FLOAT factor = (3 - square_of_length()) / 2;
+  w *= factor;
+  x *= factor;
+  y *= factor;
+  z *= factor;
+}
+
+template <class F>
+constexpr Quaternion<F> operator*(Quaternion<F> factor1, Quaternion<F> factor2) {
+  const Quaternion<F> & p = factor1;
+  const Quaternion<F> & q = factor2;
+  return { p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z,
+           p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y,
+           p.w * q.y - p.x * q.z + p.y * q.w + p.z * q.x,
+           p.w * q.z + p.x * q.y - p.y * q.x + p.z * q.w };
+}
+
+template <class FLOAT>
+Quaternion<FLOAT> nlerp(Quaternion<FLOAT> from, Quaternion<FLOAT> to, FLOAT t) {
+  // q and -q are the same rotation, the sign with the positive dot product is the shorter arc
+  FLOAT dot = from.w * to.w + from.x * to.x + from.y * to.y + from.z * to.z;
+  FLOAT s = dot < 0 ? -t : t;
+  Quaternion<FLOAT> result = { (1 - t) * from.w + s * to.w, (1 - t) * from.x + s * to.x,
+                               (1 - t) * from.y + s * to.y, (1 - t) * from.z + s * to.z };
+  result.normalize();
+  return result;
+}
+
+template <class FLOAT>
+Quaternion<FLOAT> slerp(Quaternion<FLOAT> from, Quaternion<FLOAT> to, FLOAT t) {
+  FLOAT dot = from.w * to.w + from.x * to.x + from.y * to.y + from.z * to.z;
+  FLOAT sign = 1;
+  if (dot < 0) {
+    dot = -dot;
+    sign = -1;
+  }
+  // nearly identical orientations, sin(theta) would be close to zero
+  if (dot > FLOAT(0.9995)) {
+    return nlerp(from, to, t);
+  }
+  FLOAT theta = std::acos(dot);
+  FLOAT sin_theta = std::sin(theta);
+  FLOAT a = std::sin((1 - t) * theta) / sin_theta;
+  FLOAT b = sign * std::sin(t * theta) / sin_theta;
+  return { a * from.w + b * to.w, a * from.x + b * to.x, a * from.y + b * to.y, a * from.z + b * to.z };
+}
+
+template <class FLOAT>
+void integrate(std::span<Quaternion<FLOAT>> orientations,
+               std::span<const Vector<FLOAT, 3u>> angular_velocities, FLOAT seconds) {
+  assert(orientations.size() == angular_velocities.size());
+  const size_t count = orientations.size();
+  for (size_t i = 0u; i < count; i++) {
+    orientations[i].integrate(angular_velocities[i], seconds);
+  }
+}
@@ -0,0 +1,159 @@
+#include "quaternion.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr float EPSILON = 0.00001f;
+
+TEST(QUATERNION, DefaultIsIdentity) {
+  constexpr Quaternionf identity;
+  constexpr Vector3df v = identity.rotate(Vector3df{1.0f, 2.0f, 3.0f});
+  static_assert(v[0] == 1.0f && v[1] == 2.0f && v[2] == 3.0f);
+
+  SquareMatrix4df matrix = identity.to_matrix();
+  for (ssize_t c = 0; c < 4; ++c) {
+    for (ssize_t r = 0; r < 4; ++r) {
+      EXPECT_FLOAT_EQ(r == c ? 1.0f : 0.0f, matrix.at(r, c));
+    }
+  }
+}
+
+TEST(QUATERNION, RotationAroundZEqualsRotationMatrix) {
+  float angle = 0.7f;
+  Quaternionf rotation({0.0f, 0.0f, 1.0f}, angle);
+  SquareMatrix4df expected = {
+    {std::cos(angle), std::sin(angle), 0.0f, 0.0f},
+    {-std::sin(angle), std::cos(angle), 0.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f, 0.0f},
+    {0.0f, 0.0f, 0.0f, 1.0f}
+  };
+  SquareMatrix4df matrix = rotation.to_matrix();
+  for (ssize_t c = 0; c < 4; ++c) {
+    for (ssize_t r = 0; r < 4; ++r) {
+      EXPECT_NEAR(expected.at(r, c), matrix.at(r, c), EPSILON);
+    }
+  }
+}
+
+TEST(QUATERNION, RotateEqualsMatrixProduct) {
+  Vector3df axis = {1.0f, -2.0f, 0.5f};
+  axis.normalize();
+  Quaternionf rotation(axis, 2.3f);
+  Vector3df v = {0.5f, 4.0f, -3.0f};
+
+  Vector3df rotated = rotation.rotate(v);
+  Vector4df expected = rotation.to_matrix() * Vector4df{v[0], v[1], v[2], 1.0f};
+
+  for (size_t i = 0u; i < 3u; i++) {
+    EXPECT_NEAR(expected[i], rotated[i], EPSILON);
+  }
+  EXPECT_NEAR(v.length(), rotated.length(), EPSILON);
+}
+
+TEST(QUATERNION, RotationMatrixEqualsUpperLeftOfMatrix) {
+  Vector3df axis = {1.0f, -2.0f, 0.5f};
+  axis.normalize();
+  Quaternionf rotation(axis, 2.3f);
+
+  SquareMatrix4df expected = rotation.to_matrix();
+  SquareMatrix3df matrix = rotation.to_rotation_matrix();
+  for (size_t column = 0u; column < 3u; column++) {
+    for (size_t row = 0u; row < 3u; row++) {
+      EXPECT_EQ(expected.at(row, column), matrix.at(row, column));
+    }
+  }
+}
+
+TEST(QUATERNION, CompositionRotatesFirstByRightFactor) {
+  Quaternionf around_z({0.0f, 0.0f, 1.0f}, static_cast<float>(PI / 2));
+  Quaternionf around_x({1.0f, 0.0f, 0.0f}, static_cast<float>(PI / 2));
+
+  // x axis -> y axis (around z) -> z axis (around x)
+  Vector3df rotated = (around_x * around_z).rotate(Vector3df{1.0f, 0.0f, 0.0f});
+
+  EXPECT_NEAR(0.0f, rotated[0], EPSILON);
+  EXPECT_NEAR(0.0f, rotated[1], EPSILON);
+  EXPECT_NEAR(1.0f, rotated[2], EPSILON);
+}
+
+TEST(QUATERNION, ConjugateIsInverse) {
+  Quaternionf rotation({0.0f, 0.6f, 0.8f}, 1.1f);
+  Quaternionf identity = rotation * rotation.conjugate();
+
+  EXPECT_NEAR(1.0f, identity.w, EPSILON);
+  EXPECT_NEAR(0.0f, identity.x, EPSILON);
+  EXPECT_NEAR(0.0f, identity.y, EPSILON);
+  EXPECT_NEAR(0.0f, identity.z, EPSILON);
+}
+
+TEST(QUATERNION, BatchedRotateEqualsSingleRotate) {
+  Quaternionf rotation({0.0f, 0.6f, 0.8f}, -0.4f);
+  std::vector<Vector3df> vectors;
+  for (size_t i = 0u; i < 7u; i++) {
+    vectors.push_back(Vector3df{1.0f * i, 2.0f - i, 0.5f});
+  }
+  std::vector<Vector3df> result(vectors.size());
+
+  rotation.rotate(vectors, result);
+
+  for (size_t i = 0u; i < vectors.size(); i++) {
+    Vector3df expected = rotation.rotate(vectors[i]);
+    for (size_t axis = 0u; axis < 3u; axis++) {
+      EXPECT_NEAR(expected[axis], result[i][axis], EPSILON);
+    }
+    if constexpr (VectorStorage<float, 3u>::size == 4u) {
+      EXPECT_EQ(0.0f, result[i].vector.back()); // padding of SSE vectors
+    }
+  }
+}
+
+TEST(QUATERNION, SlerpHasConstantAngularVelocity) {
+  Quaternionf from;
+  Quaternionf to({0.0f, 0.0f, 1.0f}, 2.0f);
+
+  for (float t : {0.0f, 0.25f, 0.5f, 1.0f}) {
+    Quaternionf expected({0.0f, 0.0f, 1.0f}, 2.0f * t);
+    Quaternionf result = slerp(from, to, t);
+    EXPECT_NEAR(expected.w, result.w, EPSILON);
+    EXPECT_NEAR(expected.z, result.z, EPSILON);
+    EXPECT_NEAR(1.0f, result.length(), EPSILON);
+  }
+}
+
+TEST(QUATERNION, InterpolationTakesShorterArc) {
+  Quaternionf from({0.0f, 0.0f, 1.0f}, 0.1f);
+  Quaternionf to({0.0f, 0.0f, 1.0f}, -0.1f);
+  Quaternionf negated = {-to.w, -to.x, -to.y, -to.z};
+
+  Quaternionf spherical = slerp(from, negated, 0.5f);
+  Quaternionf linear = nlerp(from, negated, 0.5f);
+
+  EXPECT_NEAR(1.0f, std::abs(spherical.w), EPSILON);
+  EXPECT_NEAR(1.0f, std::abs(linear.w), EPSILON);
+}
+
+TEST(QUATERNION, IntegrateAngularVelocity) {
+  Quaternionf orientation;
+  Vector3df angular_velocity = {0.0f, 0.0f, 1.5f};
+
+  for (size_t i = 0u; i < 1000u; i++) {
+    orientation.integrate(angular_velocity, 0.001f);
+  }
+  Quaternionf expected({0.0f, 0.0f, 1.0f}, 1.5f);
+
+  EXPECT_NEAR(expected.w, orientation.w, 0.0001f);
+  EXPECT_NEAR(expected.z, orientation.z, 0.0001f);
+  EXPECT_NEAR(1.0f, orientation.length(), EPSILON);
+
+  std::vector<Quaternionf> orientations(3u);
+  std::vector<Vector3df> angular_velocities(3u, angular_velocity);
+  for (size_t i = 0u; i < 1000u; i++) {
+    integrate<float>(orientations, angular_velocities, 0.001f);
+  }
+  for (auto & q : orientations) {
+    EXPECT_FLOAT_EQ(orientation.w, q.w);
+    EXPECT_FLOAT_EQ(orientation.z, q.z);
+  }
+}
+
+}
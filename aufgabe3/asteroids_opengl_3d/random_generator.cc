@@ -0,0 +1,92 @@
+#include "random_generator.h"
+#include "math.h" // MATH_SIMD
+
+namespace {
+
+// splitmix64 (S. Vigna), spreads the bits of a simple seed over the generator states
+uint64_t splitmix64(uint64_t & seed) {
+  uint64_t z = (seed += 0x9e3779b97f4a7c15u);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+  return z ^ (z >> 31);
+}
+
+void seed_words(uint32_t * words, size_t count, uint64_t & seed) {
+  for (size_t i = 0u; i < count; i += 2u) {
+    uint64_t bits = splitmix64(seed);
+    words[i] = static_cast<uint32_t>(bits);
+    words[i + 1u] = static_cast<uint32_t>(bits >> 32);
+  }
+}
+
+}
+
+RandomGenerator::RandomGenerator(uint64_t seed) {
+  seed_words(state.data(), state.size(), seed);
+  seed_words(lanes.data(), lanes.size(), seed);
+}
+
+void RandomGenerator::fill(std::span<float> values) {
+  fill(values, 0.0f, 1.0f);
+}
+
+void RandomGenerator::fill(std::span<float> values, float min, float max) {
+  const float range = max - min;
+  const size_t count = values.size();
+  size_t i = 0u;
+#ifdef MATH_SIMD
+  __m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i *>(lanes.data()));
+  __m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i *>(lanes.data() + 4u));
+  __m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i *>(lanes.data() + 8u));
+  __m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i *>(lanes.data() + 12u));
+  const __m128 scale = _mm_set1_ps(0x1.0p-24f);
+  const __m128 offsets = _mm_set1_ps(min);
+  const __m128 ranges = _mm_set1_ps(range);
+  auto next_numbers = [&]() {
+    const __m128i result = _mm_add_epi32(s0, s3);
+    const __m128i t = _mm_slli_epi32(s1, 9);
+    s2 = _mm_xor_si128(s2, s0);
+    s3 = _mm_xor_si128(s3, s1);
+    s1 = _mm_xor_si128(s1, s2);
+    s0 = _mm_xor_si128(s0, s3);
+    s2 = _mm_xor_si128(s2, t);
+    s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+    const __m128 numbers = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), scale);
+    return _mm_add_ps(offsets, _mm_mul_ps(ranges, numbers));
+  };
+  for (; i + 4u <= count; i += 4u) {
+    _mm_storeu_ps(values.data() + i, next_numbers());
+  }
+  if (i < count) { // the numbers of the unused lanes are dropped
+    alignas(16) float last[4];
+    _mm_store_ps(last, next_numbers());
+    for (size_t lane = 0u; i + lane < count; lane++) {
+      values[i + lane] = last[lane];
+    }
+  }
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes.data()), s0);
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes.data() + 4u), s1);
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes.data() + 8u), s2);
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes.data() + 12u), s3);
+#else
+  uint32_t * s0 = lanes.data();
+  uint32_t * s1 = lanes.data() + 4u;
+  uint32_t * s2 = lanes.data() + 8u;
+  uint32_t * s3 = lanes.data() + 12u;
+  for (; i < count; i += 4u) {
+    for (size_t lane = 0u; lane < 4u; lane++) {
+      const uint32_t result = s0[lane] + s3[lane];
+      const uint32_t t = s1[lane] << 9;
+      s2[lane] ^= s0[lane];
+      s3[lane] ^= s1[lane];
+      s1[lane] ^= s2[lane];
+      s0[lane] ^= s3[lane];
+      s2[lane] ^= t;
+      s3[lane] = (s3[lane] << 11) | (s3[lane] >> 21);
+      if (i + lane < count) {
+        values[i + lane] = min + range * (static_cast<float>(result >> 8) * 0x1.0p-24f);
+      }
+    }
+  }
+#endif
+}
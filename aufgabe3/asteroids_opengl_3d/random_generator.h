@@ -0,0 +1,59 @@
+#ifndef RANDOM_GENERATOR_H
+#define RANDOM_GENERATOR_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+// explicitly seeded pseudo random number generator xoshiro128+ (D. Blackman, S. Vigna),
+// 16 bytes of state, a few instructions per number and no shared global state
+//
+// fill() draws from four further interleaved xoshiro128+ generators, one per SSE lane,
+// so its numbers are independent of (and not equal to) the numbers of uniform()
+// the results are the same with and without SSE, for the same seed and the same calls
+class RandomGenerator {
+  std::array<uint32_t, 4u> state;
+  // lanes[4 * k + lane] is the k-th state word of the lane's generator
+  alignas(16) std::array<uint32_t, 16u> lanes;
+
+public:
+  // the states of all generators are derived from seed with splitmix64
+  explicit RandomGenerator(uint64_t seed);
+
+  // returns the next 32 random bits, the lowest bits are of lower quality
+  uint32_t next();
+
+  // returns a uniform random number of [0, 1), with 24 random bits
+  float uniform();
+
+  // returns a uniform random number of [min, max), rounding may return max if |min| >> max - min
+  float uniform(float min, float max);
+
+  // fills values with uniform random numbers of [0, 1)
+  void fill(std::span<float> values);
+
+  // fills values with uniform random numbers of [min, max), see uniform(min, max)
+  void fill(std::span<float> values, float min, float max);
+};
+
+inline uint32_t RandomGenerator::next() {
+  const uint32_t result = state[0] + state[3];
+  const uint32_t t = state[1] << 9;
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = (state[3] << 11) | (state[3] >> 21);
+  return result;
+}
+
+inline float RandomGenerator::uniform() {
+  return static_cast<float>(next() >> 8) * 0x1.0p-24f;
+}
+
+inline float RandomGenerator::uniform(float min, float max) {
+  return min + (max - min) * uniform();
+}
+
+#endif
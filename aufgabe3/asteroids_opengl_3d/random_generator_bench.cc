@@ -0,0 +1,54 @@
+#include "random_generator.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+// compares RandomGenerator with the std::mt19937 and std::uniform_real_distribution
+// formerly used by the game, one number per call and a batch of numbers
+
+namespace {
+
+constexpr size_t NO_OF_NUMBERS = 4096u;
+
+void BM_Mt19937(benchmark::State & state) {
+  std::mt19937 gen(42u);
+  std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+  std::vector<float> values(NO_OF_NUMBERS);
+  for (auto _ : state) {
+    for (float & value : values) {
+      value = dis(gen);
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_NUMBERS);
+}
+
+void BM_Uniform(benchmark::State & state) {
+  RandomGenerator random(42u);
+  std::vector<float> values(NO_OF_NUMBERS);
+  for (auto _ : state) {
+    for (float & value : values) {
+      value = random.uniform();
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_NUMBERS);
+}
+
+void BM_Fill(benchmark::State & state) {
+  RandomGenerator random(42u);
+  std::vector<float> values(NO_OF_NUMBERS);
+  for (auto _ : state) {
+    random.fill(values);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_NUMBERS);
+}
+
+BENCHMARK(BM_Mt19937);
+BENCHMARK(BM_Uniform);
+BENCHMARK(BM_Fill);
+
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,92 @@
+#include "random_generator.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+namespace {
+
+// expected values computed with the reference implementations of splitmix64 and xoshiro128+
+TEST(RANDOM_GENERATOR, KnownSequence) {
+  RandomGenerator random(42u);
+
+  EXPECT_EQ(0x58db51c8u, random.next());
+  EXPECT_EQ(0x815c6c29u, random.next());
+  EXPECT_EQ(0xec0a8dcfu, random.next());
+  EXPECT_EQ(0xa5de31d4u, random.next());
+}
+
+TEST(RANDOM_GENERATOR, KnownFillValues) {
+  RandomGenerator random(42u);
+  std::vector<float> values(6u);
+
+  random.fill(values);
+
+  EXPECT_EQ(0.11836415529251099f, values[0]);
+  EXPECT_EQ(0.618532121181488f, values[1]);
+  EXPECT_EQ(0.21793144941329956f, values[2]);
+  EXPECT_EQ(0.962672770023346f, values[3]);
+  EXPECT_EQ(0.9039913415908813f, values[4]);
+  EXPECT_EQ(0.9098654985427856f, values[5]);
+}
+
+TEST(RANDOM_GENERATOR, SameSeedSameNumbers) {
+  RandomGenerator random1(7u);
+  RandomGenerator random2(7u);
+  RandomGenerator random3(8u);
+  size_t equal_to_other_seed = 0u;
+
+  for (size_t i = 0u; i < 100u; i++) {
+    float number = random1.uniform();
+    EXPECT_EQ(number, random2.uniform());
+    equal_to_other_seed += number == random3.uniform() ? 1u : 0u;
+  }
+  EXPECT_EQ(0u, equal_to_other_seed);
+}
+
+TEST(RANDOM_GENERATOR, UniformDistribution) {
+  RandomGenerator random(1u);
+  std::vector<float> values(100000u);
+  random.fill(values);
+  std::vector<size_t> buckets(10u);
+  double sum = 0.0;
+
+  for (float value : values) {
+    ASSERT_LE(0.0f, value);
+    ASSERT_GT(1.0f, value);
+    buckets[static_cast<size_t>(value * 10.0f)]++;
+    sum += value;
+  }
+  EXPECT_NEAR(0.5, sum / values.size(), 0.005);
+  for (size_t bucket : buckets) {
+    EXPECT_NEAR(10000.0, bucket, 500.0);
+  }
+}
+
+TEST(RANDOM_GENERATOR, RangeOfUniformAndFill) {
+  RandomGenerator random(3u);
+  std::vector<float> values(1001u);
+  random.fill(values, -2.0f, 5.0f);
+
+  for (float value : values) {
+    EXPECT_LE(-2.0f, value);
+    EXPECT_GE(5.0f, value);
+    float number = random.uniform(-2.0f, 5.0f);
+    EXPECT_LE(-2.0f, number);
+    EXPECT_GE(5.0f, number);
+  }
+}
+
+TEST(RANDOM_GENERATOR, FillOfRemainingValues) {
+  RandomGenerator random1(5u);
+  RandomGenerator random2(5u);
+  std::vector<float> values1(7u);
+  std::vector<float> values2(4u);
+
+  random1.fill(values1);
+  random2.fill(values2);
+
+  for (size_t i = 0u; i < values2.size(); i++) {
+    EXPECT_EQ(values2[i], values1[i]);
+  }
+}
+
+}
@@ -1,68 +1,48 @@
 #include "sdl2_renderer.h"
+#include "matrix.h"
+#include "shapes.h"
+#include <cassert>
 #include <span>
 #include <utility>
 
 
-void SDL2Renderer::renderSpaceship(Vector2df position, float angle) {
-    static std::array<SDL_Point, 6> ship_points{SDL_Point{-6, 3},
-                                              SDL_Point{-6,-3},
-                                              SDL_Point{-10,-6},
-                                              SDL_Point{ 14, 0},
-                                              SDL_Point{-10, 6},
-                                              SDL_Point{-6, 3}};
-  
-  std::array<SDL_Point, ship_points.size()> points;
+namespace {
 
-  float cos_angle = std::cos(angle);
-  float sin_angle = std::sin(angle);
-  for (size_t i = 0; i < ship_points.size(); i++) {
-    float x = ship_points[i].x;
-    float y = ship_points[i].y;
-    points[i].x = (cos_angle * x - sin_angle * y) + position[0];
-    points[i].y = (sin_angle * x + cos_angle * y) + position[1];
+constexpr size_t MAX_SHAPE_POINTS = 16u;
+
+// transforms the points of the shape with one matrix and draws the connecting lines
+void draw_lines(SDL_Renderer * renderer, const SquareMatrix3df & transformation, std::span<const Vector2df> shape) {
+  assert(shape.size() <= MAX_SHAPE_POINTS);
+  std::array<Vector2df, MAX_SHAPE_POINTS> transformed;
+  transform_points(transformation, shape, std::span(transformed).first(shape.size()));
+  std::array<SDL_Point, MAX_SHAPE_POINTS> points;
+  for (size_t i = 0; i < shape.size(); i++) {
+    points[i] = SDL_Point{ static_cast<int>(transformed[i][0]), static_cast<int>(transformed[i][1]) };
   }
-  SDL_RenderDrawLines(renderer, points.data(), points.size());
+  SDL_RenderDrawLines(renderer, points.data(), shape.size());
+}
 
 }
 
-void SDL2Renderer::render(Spaceship * ship) {
-  static SDL_Point flame_points[] { {-6, 3}, {-12, 0}, {-6, -3} };
-  std::array<SDL_Point, std::span{flame_points}.size()> points;
+void SDL2Renderer::renderSpaceship(Vector2df position, float angle) {
+  draw_lines(renderer, affine_2d(position, angle, 1.0f), shapes::spaceship);
+}
 
+void SDL2Renderer::render(Spaceship * ship) {
   if (! ship->is_in_hyperspace()) {
     if (ship->is_accelerating()) {
-      float cos_angle = std::cos(ship->get_angle());
-      float sin_angle = std::sin(ship->get_angle());
-      for (size_t i = 0; i < points.size(); i++) {
-        float x = flame_points[i].x;
-        float y = flame_points[i].y;
-        points[i].x = (cos_angle * x - sin_angle * y) + ship->get_position()[0];
-        points[i].y = (sin_angle * x + cos_angle * y) + ship->get_position()[1];
-      }
-       SDL_RenderDrawLines(renderer, points.data(), points.size());
+      draw_lines(renderer, affine_2d(ship->get_position(), ship->get_angle(), 1.0f), shapes::flame);
     }
   renderSpaceship(ship->get_position(), ship->get_angle());  
   }
 }
 
 void SDL2Renderer::render(Saucer * saucer) {
-  static SDL_Point saucer_points[] = { {-16, -6}, {16, -6}, {40, 6}, {-40, 6}, {-16, 18}, {16, 18},
-                                       {40, 6}, {16, -6}, {8, -18}, {-8, -18}, {-16, -6}, {-40, 6} };
-  
-  std::array<SDL_Point, std::span{saucer_points}.size()> points;
-
-  Vector2df position = saucer->get_position();
   float scale = 0.5;
   if ( saucer->get_size() == 0 ) {
     scale = 0.25;
   }
-  for (size_t i = 0; i < points.size(); i++) {
-    float x = saucer_points[i].x;
-    float y = saucer_points[i].y;
-    points[i].x = scale * x + position[0];
-    points[i].y = scale * y + position[1];
-  }
-  SDL_RenderDrawLines(renderer, points.data(), points.size());
+  draw_lines(renderer, affine_2d(saucer->get_position(), 0.0f, scale), shapes::saucer);
 }
 
 
@@ -75,37 +55,8 @@ void SDL2Renderer::render(Torpedo * torpedo) {
 }
   
 void SDL2Renderer::render(Asteroid * asteroid) {
-  static SDL_Point asteroids_points1[] = {
-    { 0, -12}, {16, -24}, {32, -12}, {24, 0}, {32, 12}, {8, 24}, {-16, 24}, {-32, 12}, {-32, -12}, {-16, -24}, {0, -12}
-  };   
-  static SDL_Point asteroids_points2[] = {
-    { 16, -6}, {32, -12}, {16, -24}, {0, -16}, {-16, -24}, {-24, -12}, {-16, -0}, {-32, 12}, {-16, 24}, {-8, 16}, {16, 24}, {32, 6}, {16, -6}
-  }; 
-  static SDL_Point asteroids_points3[] = {
-    {-16, 0}, {-32, 6}, {-16, 24}, {0, 6}, {0, 24}, {16, 24}, {32, 6}, {32, 6}, {16, -24}, {-8, -24}, {-32, -6}, {-16, 0}
-  };
-  static SDL_Point asteroids_points4[] = {  
-    {8,0}, {32,-6}, {32, -12}, {8, -24}, {-16, -24}, {-8, -12}, {-32, -12}, {-32, 12}, {-16, 24}, {8, 16}, {16, 24}, {32, 12}, {8, 0}
-  };
-  static size_t sizes[] = {std::span{asteroids_points1}.size(),
-                           std::span{asteroids_points2}.size(),
-                           std::span{asteroids_points3}.size(),
-                           std::span{asteroids_points4}.size() };
-  size_t size = sizes[ asteroid->get_rock_type() ];
-  SDL_Point * asteroids_points = asteroids_points1;
-  if ( asteroid->get_rock_type() == 1 ) asteroids_points = asteroids_points2;
-  if ( asteroid->get_rock_type() == 2 ) asteroids_points = asteroids_points3;
-  if ( asteroid->get_rock_type() == 3 ) asteroids_points = asteroids_points4;
- 
-  SDL_Point points[std::span{asteroids_points4}.size()];
-  
   float scale = (asteroid->get_size() == 3 ? 1.0 : ( asteroid->get_size() == 2 ? 0.5 : 0.25 ));
-  Vector2df position = asteroid->get_position();
-  for (size_t i = 0; i < size; i++) {
-    points[i].x = scale * asteroids_points[i].x + position[0];
-    points[i].y = scale * asteroids_points[i].y + position[1];
-  }
-  SDL_RenderDrawLines(renderer, points, size);
+  draw_lines(renderer, affine_2d(asteroid->get_position(), 0.0f, scale), shapes::asteroids[asteroid->get_rock_type()]);
 }
 
 
@@ -116,7 +67,7 @@ void SDL2Renderer::render(SpaceshipDebris * debris) {
                                         { SDL_Point{3, -1}, SDL_Point{ -5, -7} },
                                         { SDL_Point{0, -4}, SDL_Point{-6, -6} },
                                         { SDL_Point{-2, 2}, SDL_Point{2, 5} } };
-  static std::array<Vector2df, 6> debris_direction = { Vector2df{-40, -23}, Vector2df{50, 15}, Vector2df{0, 45},
+  static constexpr std::array<Vector2df, 6> debris_direction = { Vector2df{-40, -23}, Vector2df{50, 15}, Vector2df{0, 45},
                                                        Vector2df{60, -15}, Vector2df{10, -52}, Vector2df{-40, 30} };
   Vector2df position = debris->get_position();
   std::array<SDL_Point, 4> points;
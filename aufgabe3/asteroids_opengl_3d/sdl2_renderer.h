@@ -30,7 +30,9 @@ class SDL2Renderer : public Renderer {
   void renderScore();
 public:
   SDL2Renderer(Game & game, std::string title, int window_width = 1024, int window_height = 768)
-    : Renderer(game), title(title), window_width(window_width), window_height(window_height) { }
+    : Renderer(game), title(title), window_width(window_width), window_height(window_height) {
+    game.set_outline_collisions(true); // hits follow the drawn outlines
+  }
   
   virtual bool init();
   
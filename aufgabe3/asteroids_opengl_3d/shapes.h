@@ -0,0 +1,39 @@
+#ifndef SHAPES_H
+#define SHAPES_H
+
+#include <array>
+#include <span>
+#include "math.h"
+
+// the polylines of the original game in game coordinates, relative to the position of a body
+// (drawn by the SDL2 renderer and the 2D views of the OpenGL renderer,
+// the outline collisions of the game decompose them into convex polygons)
+namespace shapes {
+
+inline constexpr auto spaceship = std::to_array<Vector2df>({ {-6, 3}, {-6, -3}, {-10, -6}, {14, 0}, {-10, 6}, {-6, 3} });
+
+inline constexpr auto flame = std::to_array<Vector2df>({ {-6, 3}, {-12, 0}, {-6, -3} });
+
+// the lines cross each other
+inline constexpr auto saucer = std::to_array<Vector2df>({ {-16, -6}, {16, -6}, {40, 6}, {-40, 6}, {-16, 18}, {16, 18},
+                                                          {40, 6}, {16, -6}, {8, -18}, {-8, -18}, {-16, -6}, {-40, 6} });
+
+inline constexpr auto asteroid_1 = std::to_array<Vector2df>({
+  { 0, -12}, {16, -24}, {32, -12}, {24, 0}, {32, 12}, {8, 24}, {-16, 24}, {-32, 12}, {-32, -12}, {-16, -24}, {0, -12}
+});
+inline constexpr auto asteroid_2 = std::to_array<Vector2df>({
+  { 16, -6}, {32, -12}, {16, -24}, {0, -16}, {-16, -24}, {-24, -12}, {-16, -0}, {-32, 12}, {-16, 24}, {-8, 16}, {16, 24}, {32, 6}, {16, -6}
+});
+inline constexpr auto asteroid_3 = std::to_array<Vector2df>({
+  {-16, 0}, {-32, 6}, {-16, 24}, {0, 6}, {0, 24}, {16, 24}, {32, 6}, {32, 6}, {16, -24}, {-8, -24}, {-32, -6}, {-16, 0}
+});
+inline constexpr auto asteroid_4 = std::to_array<Vector2df>({
+  {8,0}, {32,-6}, {32, -12}, {8, -24}, {-16, -24}, {-8, -12}, {-32, -12}, {-32, 12}, {-16, 24}, {8, 16}, {16, 24}, {32, 12}, {8, 0}
+});
+
+// indexed by the rock type, drawn with the scale 0.25, 0.5, 1.0 for the sizes 1, 2, 3
+inline constexpr std::array<std::span<const Vector2df>, 4> asteroids = { asteroid_1, asteroid_2, asteroid_3, asteroid_4 };
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef VECTOR_EXPRESSION_H
+#define VECTOR_EXPRESSION_H
+
+#include <type_traits>
+#include "math.h"
+
+// opt-in expression templates for Vector arithmetic
+//
+// lazy(v) wraps a Vector. Sums, differences and scalar products of wrapped Vectors
+// build an expression tree instead of temporary Vectors. The tree is evaluated
+// component by component in a single pass when it is converted to a Vector:
+//
+//   Vector3df reflective = lazy(d) - (2.0f * (lazy(d) * lazy(n))) * lazy(n);
+//
+// expressions only reference their Vector operands, so an expression has to be
+// converted in the statement that builds it (never store one in an auto variable)
+namespace expr {
+
+// base of all expression nodes, E is the node type (CRTP)
+template <class E, class FLOAT_TYPE, size_t N>
+struct VectorExpression {
+  // returns the i-th scalar component of the expression's result
+  constexpr FLOAT_TYPE operator[](std::size_t i) const {
+    return static_cast<const E &>(*this)[i];
+  }
+
+  // evaluates the expression in a single (unrolled) pass over the components
+  constexpr operator Vector<FLOAT_TYPE, N>() const {
+    const E & expression = static_cast<const E &>(*this);
+    Vector<FLOAT_TYPE, N> result;
+#ifdef MATH_SIMD
+    if constexpr (simd::accelerated<FLOAT_TYPE, N>) {
+      if (! std::is_constant_evaluated()) {
+        // one register store, single component stores followed by a
+        // 16 byte load of the result would stall the store forwarding
+        simd::store(result, _mm_setr_ps(expression[0], expression[1], expression[2],
+                                        N == 4u ? expression[N - 1u] : 0.0f));
+        return result;
+      }
+    }
+#endif
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      ((result[I] = expression[I]), ...);
+    }(std::make_index_sequence<N>{});
+    return result;
+  }
+};
+
+// leaf of an expression tree
+template <class FLOAT_TYPE, size_t N>
+struct Reference : VectorExpression<Reference<FLOAT_TYPE, N>, FLOAT_TYPE, N> {
+  const Vector<FLOAT_TYPE, N> & vector;
+
+  constexpr explicit Reference(const Vector<FLOAT_TYPE, N> & vector) : vector(vector) {}
+  constexpr FLOAT_TYPE operator[](std::size_t i) const { return vector[i]; }
+};
+
+template <class L, class R, class FLOAT_TYPE, size_t N>
+struct Sum : VectorExpression<Sum<L, R, FLOAT_TYPE, N>, FLOAT_TYPE, N> {
+  L left;
+  R right;
+
+  constexpr Sum(L left, R right) : left(left), right(right) {}
+  constexpr FLOAT_TYPE operator[](std::size_t i) const { return left[i] + right[i]; }
+};
+
+template <class L, class R, class FLOAT_TYPE, size_t N>
+struct Difference : VectorExpression<Difference<L, R, FLOAT_TYPE, N>, FLOAT_TYPE, N> {
+  L left;
+  R right;
+
+  constexpr Difference(L left, R right) : left(left), right(right) {}
+  constexpr FLOAT_TYPE operator[](std::size_t i) const { return left[i] - right[i]; }
+};
+
+template <class E, class FLOAT_TYPE, size_t N>
+struct Scaled : VectorExpression<Scaled<E, FLOAT_TYPE, N>, FLOAT_TYPE, N> {
+  FLOAT_TYPE factor;
+  E expression;
+
+  constexpr Scaled(FLOAT_TYPE factor, E expression) : factor(factor), expression(expression) {}
+  constexpr FLOAT_TYPE operator[](std::size_t i) const { return factor * expression[i]; }
+};
+
+// wraps v for lazy evaluation
+template <class FLOAT_TYPE, size_t N>
+constexpr Reference<FLOAT_TYPE, N> lazy(const Vector<FLOAT_TYPE, N> & v) {
+  return Reference<FLOAT_TYPE, N>(v);
+}
+
+// returns the lazy sum of the two given expressions
+template <class L, class R, class FLOAT_TYPE, size_t N>
+constexpr Sum<L, R, FLOAT_TYPE, N> operator+(const VectorExpression<L, FLOAT_TYPE, N> & value,
+                                             const VectorExpression<R, FLOAT_TYPE, N> & addend) {
+  return {static_cast<const L &>(value), static_cast<const R &>(addend)};
+}
+
+// returns the lazy difference value - minuend
+template <class L, class R, class FLOAT_TYPE, size_t N>
+constexpr Difference<L, R, FLOAT_TYPE, N> operator-(const VectorExpression<L, FLOAT_TYPE, N> & value,
+                                                    const VectorExpression<R, FLOAT_TYPE, N> & minuend) {
+  return {static_cast<const L &>(value), static_cast<const R &>(minuend)};
+}
+
+// returns the lazy scalar product of the given scalar and expression
+template <class E, class FLOAT_TYPE, size_t N>
+constexpr Scaled<E, FLOAT_TYPE, N> operator*(std::type_identity_t<FLOAT_TYPE> scalar,
+                                             const VectorExpression<E, FLOAT_TYPE, N> & value) {
+  return {scalar, static_cast<const E &>(value)};
+}
+
+// returns the scalar (inner) product of two expressions, evaluated immediately
+template <class L, class R, class FLOAT_TYPE, size_t N>
+constexpr FLOAT_TYPE operator*(const VectorExpression<L, FLOAT_TYPE, N> & vector1,
+                               const VectorExpression<R, FLOAT_TYPE, N> & vector2) {
+  return [&]<size_t... I>(std::index_sequence<I...>) {
+    return (FLOAT_TYPE{0} + ... + (vector1[I] * vector2[I]));
+  }(std::make_index_sequence<N>{});
+}
+
+}
+
+#endif
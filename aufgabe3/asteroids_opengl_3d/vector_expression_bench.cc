@@ -0,0 +1,158 @@
+#include "vector_expression.h"
+#include "geometry.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+// compares the by-value Vector operators (Temporaries) with the
+// expression templates of vector_expression.h (Expression)
+// for the formulas used per ray bounce and per physics tick
+
+namespace {
+
+using expr::lazy;
+
+constexpr size_t NO_OF_VECTORS = 1024u;
+
+template <size_t N>
+std::vector< Vector<float, N> > create_directions() {
+  std::vector< Vector<float, N> > vectors(NO_OF_VECTORS);
+  for (size_t i = 0u; i < NO_OF_VECTORS; i++) {
+    for (size_t axis = 0u; axis < N; axis++) {
+      vectors[i][axis] = 0.25f + static_cast<float>((i * 7u + axis * 13u) % 31u);
+    }
+    vectors[i].normalize();
+  }
+  return vectors;
+}
+
+template <size_t N>
+Vector<float, N> create_normal() {
+  Vector<float, N> normal{};
+  normal[1] = 1.0f;
+  return normal;
+}
+
+template <size_t N>
+void BM_ReflectTemporaries(benchmark::State & state) {
+  auto directions = create_directions<N>();
+  auto normal = create_normal<N>();
+  for (auto _ : state) {
+    for (auto & d : directions) {
+      Vector<float, N> reflective = d - 2.0f * (d * normal) * normal;
+      benchmark::DoNotOptimize(reflective);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <size_t N>
+void BM_ReflectExpression(benchmark::State & state) {
+  auto directions = create_directions<N>();
+  auto normal = create_normal<N>();
+  for (auto _ : state) {
+    for (auto & d : directions) {
+      Vector<float, N> reflective = lazy(d) - (2.0f * (lazy(d) * lazy(normal))) * lazy(normal);
+      benchmark::DoNotOptimize(reflective);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+// the formula of refract() in geometry.h, transmission = index * (d - cos_theta * n) - cos_phi * n
+template <size_t N>
+void BM_RefractTemporaries(benchmark::State & state) {
+  auto directions = create_directions<N>();
+  auto normal = create_normal<N>();
+  const float refraction_index = 0.9f;
+  for (auto _ : state) {
+    for (auto & d : directions) {
+      float cos_theta = d * normal;
+      float sin_phi_squared = refraction_index * refraction_index * (1.0f - cos_theta * cos_theta);
+      if (sin_phi_squared > 1.0f) {
+        continue;
+      }
+      float cos_phi = std::sqrt(1.0f - sin_phi_squared);
+      Vector<float, N> transmission = refraction_index * (d - cos_theta * normal) - cos_phi * normal;
+      benchmark::DoNotOptimize(transmission);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <size_t N>
+void BM_RefractExpression(benchmark::State & state) {
+  auto directions = create_directions<N>();
+  auto normal = create_normal<N>();
+  const float refraction_index = 0.9f;
+  for (auto _ : state) {
+    for (auto & d : directions) {
+      float cos_theta = lazy(d) * lazy(normal);
+      float sin_phi_squared = refraction_index * refraction_index * (1.0f - cos_theta * cos_theta);
+      if (sin_phi_squared > 1.0f) {
+        continue;
+      }
+      float cos_phi = std::sqrt(1.0f - sin_phi_squared);
+      Vector<float, N> transmission = refraction_index * (lazy(d) - cos_theta * lazy(normal)) - cos_phi * lazy(normal);
+      benchmark::DoNotOptimize(transmission);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+// refract() of geometry.h itself, which is not inlined (pre-compiled in geometry.cc)
+template <size_t N>
+void BM_Refract(benchmark::State & state) {
+  auto directions = create_directions<N>();
+  auto normal = create_normal<N>();
+  for (auto _ : state) {
+    for (auto & d : directions) {
+      Vector<float, N> transmission;
+      benchmark::DoNotOptimize(refract(0.9f, normal, d, transmission));
+      benchmark::DoNotOptimize(transmission);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+// Body::accelerate, velocity + seconds * acceleration * direction
+template <size_t N>
+void BM_IntegrateTemporaries(benchmark::State & state) {
+  auto directions = create_directions<N>();
+  Vector<float, N> velocity{};
+  for (auto _ : state) {
+    for (auto & d : directions) {
+      velocity = velocity + 0.016f * 2.5f * d;
+    }
+    benchmark::DoNotOptimize(velocity);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+template <size_t N>
+void BM_IntegrateExpression(benchmark::State & state) {
+  auto directions = create_directions<N>();
+  Vector<float, N> velocity{};
+  for (auto _ : state) {
+    for (auto & d : directions) {
+      velocity = lazy(velocity) + (0.016f * 2.5f) * lazy(d);
+    }
+    benchmark::DoNotOptimize(velocity);
+  }
+  state.SetItemsProcessed(state.iterations() * NO_OF_VECTORS);
+}
+
+BENCHMARK(BM_ReflectTemporaries<2u>);
+BENCHMARK(BM_ReflectExpression<2u>);
+BENCHMARK(BM_ReflectTemporaries<3u>);
+BENCHMARK(BM_ReflectExpression<3u>);
+BENCHMARK(BM_RefractTemporaries<3u>);
+BENCHMARK(BM_RefractExpression<3u>);
+BENCHMARK(BM_Refract<3u>);
+BENCHMARK(BM_IntegrateTemporaries<2u>);
+BENCHMARK(BM_IntegrateExpression<2u>);
+BENCHMARK(BM_IntegrateTemporaries<3u>);
+BENCHMARK(BM_IntegrateExpression<3u>);
+
+}
+
+BENCHMARK_MAIN();
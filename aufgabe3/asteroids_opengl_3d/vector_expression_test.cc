@@ -0,0 +1,51 @@
+#include "vector_expression.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+using expr::lazy;
+
+TEST(VECTOR_EXPRESSION, SumAndDifference3df) {
+  Vector3df a = {1.0, 2.0, 3.0};
+  Vector3df b = {0.5, -1.0, 4.0};
+  Vector3df c = {2.0, 2.0, 2.0};
+
+  Vector3df result = lazy(a) + lazy(b) - lazy(c);
+  Vector3df expected = a + b - c;
+
+  for (size_t i = 0u; i < 3u; i++) {
+    EXPECT_FLOAT_EQ(expected[i], result[i]);
+  }
+}
+
+TEST(VECTOR_EXPRESSION, ReflectionEqualsGetReflective3df) {
+  Vector3df direction = {1.0, -1.0, 0.5};
+  Vector3df normal = {0.0, 1.0, 0.0};
+
+  Vector3df result = lazy(direction) - (2.0f * (lazy(direction) * lazy(normal))) * lazy(normal);
+  Vector3df expected = direction.get_reflective(normal);
+
+  for (size_t i = 0u; i < 3u; i++) {
+    EXPECT_FLOAT_EQ(expected[i], result[i]);
+  }
+}
+
+TEST(VECTOR_EXPRESSION, IntegrationAssignsToExistingVector2df) {
+  Vector2df velocity = {1.0, 2.0};
+  Vector2df direction = {0.0, 1.0};
+
+  velocity = lazy(velocity) + (0.5f * 4.0f) * lazy(direction);
+
+  EXPECT_FLOAT_EQ(1.0, velocity[0]);
+  EXPECT_FLOAT_EQ(4.0, velocity[1]);
+}
+
+TEST(VECTOR_EXPRESSION, ConvertsToVectorParameter4df) {
+  Vector4df a = {1.0, 2.0, 3.0, 4.0};
+  auto length = [](Vector4df v) { return v.length(); };
+
+  EXPECT_FLOAT_EQ(2.0f * a.length(), length(2.0f * lazy(a)));
+  EXPECT_FLOAT_EQ(a * a, lazy(a) * lazy(a));
+}
+
+}